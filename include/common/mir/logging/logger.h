@@ -65,6 +65,11 @@ protected:
 void log(Severity severity, const std::string& message, const std::string& component);
 void set_logger(std::shared_ptr<Logger> const& new_logger);
 
+/// Messages less severe than max_severity are discarded before they are formatted.
+/// (The default is Severity::debug, which discards nothing.)
+void set_max_severity(Severity max_severity);
+auto is_enabled(Severity severity) -> bool;
+
 }
 }
 
@@ -21,6 +21,7 @@
 
 #include "miral/application.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,18 @@ namespace miral
 {
 class Window;
 
+/// The resources an application is using, as accounted by the server
+/// \remark Since MirAL 3.1
+struct ApplicationResourceUsage
+{
+    size_t surfaces;
+    size_t buffer_streams;
+    size_t buffers;             ///< Client buffers the server holds
+    size_t buffer_bytes;        ///< The memory those buffers use
+    uint64_t commits;           ///< Buffers submitted since the application connected
+    uint64_t throttled_frames;  ///< Frames held back on surfaces that weren't visible
+};
+
 struct ApplicationInfo
 {
     ApplicationInfo();
@@ -40,6 +53,10 @@ struct ApplicationInfo
     auto application()  const -> Application;
     auto windows() const -> std::vector <Window>&;
 
+    /// The resources the application is using. Sampling this periodically gives its commit rate.
+    /// \remark Since MirAL 3.1
+    auto resource_usage() const -> ApplicationResourceUsage;
+
     /// This can be used by client code to store window manager specific information
     auto userdata() const -> std::shared_ptr<void>;
     void userdata(std::shared_ptr<void> userdata);
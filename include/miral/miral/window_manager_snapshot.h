@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_WINDOW_MANAGER_SNAPSHOT_H
+#define MIRAL_WINDOW_MANAGER_SNAPSHOT_H
+
+#include "miral/application.h"
+#include "miral/window.h"
+
+#include <mir_toolkit/common.h>
+#include <mir/geometry/point.h>
+#include <mir/geometry/size.h>
+
+#include <string>
+#include <vector>
+
+namespace miral
+{
+/// A copy of the state of a window at the time a WindowManagerSnapshot was taken
+/// \remark Since MirAL 3.1
+struct WindowSnapshot
+{
+    Window window;
+    Application application;
+    std::string name;
+    MirWindowType type;
+    MirWindowState state;
+    MirDepthLayer depth_layer;
+    mir::geometry::Point top_left;
+    mir::geometry::Size size;
+    Window parent;
+    bool is_visible;
+};
+
+/// A consistent, read-only copy of MirAL's model. Unlike the model itself, this can be read from
+/// any thread without holding the window manager lock.
+/// \remark Since MirAL 3.1
+struct WindowManagerSnapshot
+{
+    Window active_window;
+    std::vector<Application> applications;
+    std::vector<WindowSnapshot> windows;    ///< In no particular order
+};
+}
+
+#endif //MIRAL_WINDOW_MANAGER_SNAPSHOT_H
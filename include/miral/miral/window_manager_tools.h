@@ -38,6 +38,7 @@ class Window;
 struct WindowInfo;
 struct ApplicationInfo;
 class WindowSpecification;
+struct WindowManagerSnapshot;
 
 /**
  * Workspace is intentionally opaque in the miral API. Its only purpose is to
@@ -246,6 +247,14 @@ public:
      */
     void invoke_under_lock(std::function<void()> const& callback);
 
+    /** A read-only copy of the model, as it was when the lock was last released.
+     *  This can be called from any thread without blocking the window manager: if the model has changed
+     *  but is currently locked the previous copy is returned. Like invoke_under_lock(), it should NOT
+     *  be used by a thread that has called the WindowManagementPolicy methods.
+     *  \remark Since MirAL 3.1
+     */
+    auto snapshot() const -> std::shared_ptr<WindowManagerSnapshot const>;
+
 private:
     WindowManagerToolsImplementation* tools;
 };
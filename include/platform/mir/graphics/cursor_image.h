@@ -23,6 +23,9 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/displacement.h"
 
+#include <chrono>
+#include <cstddef>
+
 namespace mir
 {
 namespace graphics
@@ -46,6 +49,22 @@ protected:
     CursorImage(CursorImage const&) = delete;
     CursorImage& operator=(CursorImage const&) = delete;
 };
+
+/// A cursor image that cycles through a sequence of frames (such as the
+/// "watch" cursor of many XCursor themes). The CursorImage accessors
+/// describe the first frame, so cursors that don't animate can ignore
+/// the rest.
+class AnimatedCursorImage : public CursorImage
+{
+public:
+    virtual size_t frame_count() const = 0;
+    virtual CursorImage const& frame(size_t index) const = 0;
+    /// How long frame(index) is displayed before moving on to the next
+    virtual std::chrono::milliseconds frame_duration(size_t index) const = 0;
+
+protected:
+    AnimatedCursorImage() = default;
+};
 }
 }
 
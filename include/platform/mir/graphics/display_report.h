@@ -21,6 +21,8 @@
 
 #include <EGL/egl.h>
 
+#include <chrono>
+
 namespace mir
 {
 namespace graphics
@@ -49,6 +51,10 @@ protected:
     virtual ~DisplayReport() = default;
     DisplayReport(const DisplayReport&) = delete;
     DisplayReport& operator=(const DisplayReport&) = delete;
+
+public:
+    /// How long a step of applying a display configuration took (ignored by default)
+    virtual void report_configuration_phase(char const* phase, std::chrono::nanoseconds duration);
 };
 
 }
@@ -47,6 +47,14 @@ extern char const* const touchspots_opt;
 extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
+extern char const* const log_level_opt;
+extern char const* const async_logging_opt;
+extern char const* const metrics_socket_opt;
+extern char const* const timeline_file_opt;
+extern char const* const client_surface_limit_opt;
+extern char const* const client_buffer_stream_limit_opt;
+extern char const* const client_buffer_memory_warning_opt;
+extern char const* const client_buffer_memory_limit_opt;
 extern char const* const composite_delay_opt;
 extern char const* const enable_key_repeat_opt;
 extern char const* const x11_display_opt;
@@ -61,6 +69,7 @@ extern char const* const enable_key_repeat_opt;
 extern char const* const off_opt_value;
 extern char const* const log_opt_value;
 extern char const* const lttng_opt_value;
+extern char const* const metrics_opt_value;
 
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
@@ -154,6 +154,14 @@ auto alloc_buffer_with_content(
     geometry::Stride const& src_stride,
     MirPixelFormat src_format) -> std::shared_ptr<graphics::Buffer>;
 
+/// Overwrite the whole of an existing CPU-accessible buffer with content of
+/// the buffer's own size and format (for example, to reuse a buffer from
+/// alloc_buffer_with_content() rather than allocate another)
+void write_buffer_content(
+    std::shared_ptr<graphics::Buffer> const& buffer,
+    unsigned char const* content,
+    geometry::Stride const& src_stride);
+
 class PixelSource
 {
 public:
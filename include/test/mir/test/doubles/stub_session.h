@@ -20,6 +20,7 @@
 #define MIR_TEST_DOUBLES_STUB_SESSION_H
 
 #include <mir/scene/session.h>
+#include <mir/scene/session_resources.h>
 
 namespace mir
 {
@@ -77,7 +78,10 @@ struct StubSession : scene::Session
 
     void send_input_config(MirInputConfig const& config) override;
 
+    auto resources() const -> std::shared_ptr<scene::SessionResources> override;
+
     pid_t pid;
+    std::shared_ptr<scene::SessionResources> const resources_{std::make_shared<scene::SessionResources>("")};
 };
 }
 }
@@ -112,7 +112,9 @@ PosixTimestamp FrameClock::next_frame_after(PosixTimestamp when) const
     if (missed_frames > 1 || config_changed)
     {
         lock.unlock();
-        auto const server_frame = resync_callback();
+        auto server_frame = resync_callback();
+        if (server_frame.nanoseconds == server_frame.nanoseconds.zero())
+            server_frame = fallback_resync_callback();
         lock.lock();
 
         phase = server_frame % period;
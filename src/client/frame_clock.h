@@ -47,6 +47,8 @@ public:
      *   Lowest precision: Don't provide a callback.
      *   Medium precision: Provide a callback which returns a recent timestamp.
      *   Highest precision: Provide a callback that queries the server.
+     * The callback may return a default (zero) timestamp when it has nothing
+     * better to offer, in which case the low precision fallback is used.
      */
     void set_resync_callback(ResyncCallback);
 
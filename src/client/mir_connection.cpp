@@ -27,6 +27,7 @@
 #include "mir/client/client_platform.h"
 #include "mir/client/client_platform_factory.h"
 #include "rpc/mir_basic_rpc_channel.h"
+#include "rpc/submission_ring_producer.h"
 #include "mir/dispatch/dispatchable.h"
 #include "mir/dispatch/threaded_dispatcher.h"
 #include "mir/input/input_devices.h"
@@ -63,6 +64,7 @@
 #include <boost/throw_exception.hpp>
 
 namespace mcl = mir::client;
+namespace mclr = mir::client::rpc;
 namespace md = mir::dispatch;
 namespace mircv = mir::input::receiver;
 namespace mev = mir::events;
@@ -108,6 +110,11 @@ size_t get_nbuffers_from_env()
     return 3u;
 }
 
+bool submission_ring_disabled_by_env()
+{
+    return getenv("MIR_CLIENT_DISABLE_SUBMISSION_RING") != nullptr;
+}
+
 struct OnScopeExit
 {
     ~OnScopeExit() { f(); }
@@ -323,6 +330,7 @@ MirConnection::MirConnection(
         connect_done{false},
         ignored{mcl::make_protobuf_object<mir::protobuf::Void>()},
         connect_parameters{mcl::make_protobuf_object<mir::protobuf::ConnectParameters>()},
+        submission_ring_fds{mcl::make_protobuf_object<mir::protobuf::SocketFD>()},
         platform_operation_reply{mcl::make_protobuf_object<mir::protobuf::PlatformOperationMessage>()},
         display_configuration_response{mcl::make_protobuf_object<mir::protobuf::DisplayConfiguration>()},
         set_base_display_configuration_response{mcl::make_protobuf_object<mir::protobuf::Void>()},
@@ -652,6 +660,41 @@ void MirConnection::connected(MirConnectedCallback callback, void * context)
                                  boost::diagnostic_information(e));
     }
 
+    if (!connect_result->has_error() &&
+        connect_result->submission_ring_supported() &&
+        !submission_ring_disabled_by_env())
+    {
+        // Set up the ring before reporting the connection so that every
+        // buffer submission goes the same way and they can't be reordered.
+        server.create_submission_ring(
+            void_response.get(),
+            submission_ring_fds.get(),
+            google::protobuf::NewCallback(
+                this, &MirConnection::submission_ring_created, callback, context));
+        return;
+    }
+
+    callback(this, context);
+    connect_wait_handle.result_received();
+}
+
+void MirConnection::submission_ring_created(MirConnectedCallback callback, void* context)
+{
+    if (!submission_ring_fds->has_error() && submission_ring_fds->fd_size() == 2)
+    {
+        try
+        {
+            server.use_submission_ring(std::make_shared<mclr::SubmissionRingProducer>(
+                mir::Fd{submission_ring_fds->fd(0)},
+                mir::Fd{submission_ring_fds->fd(1)}));
+        }
+        catch (std::exception const& e)
+        {
+            logger->log(ml::Severity::warning,
+                std::string{"Failed to set up submission ring: "} + e.what(), "MirConnection");
+        }
+    }
+
     callback(this, context);
     connect_wait_handle.result_received();
 }
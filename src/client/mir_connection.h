@@ -56,6 +56,7 @@ class Connection;
 class ConnectParameters;
 class PlatformOperationMessage;
 class DisplayConfiguration;
+class SocketFD;
 }
 /// The client-side library implementation namespace
 namespace client
@@ -327,6 +328,7 @@ private:
     std::atomic<bool> connect_done;
     std::unique_ptr<mir::protobuf::Void> ignored;
     std::unique_ptr<mir::protobuf::ConnectParameters> connect_parameters;
+    std::unique_ptr<mir::protobuf::SocketFD> submission_ring_fds;
     std::unique_ptr<mir::protobuf::PlatformOperationMessage> platform_operation_reply;
     std::unique_ptr<mir::protobuf::DisplayConfiguration> display_configuration_response;
     std::unique_ptr<mir::protobuf::Void> set_base_display_configuration_response;
@@ -374,6 +376,7 @@ private:
     void set_error_message(std::string const& error);
     void done_disconnect();
     void connected(MirConnectedCallback callback, void * context);
+    void submission_ring_created(MirConnectedCallback callback, void* context);
     void released(SurfaceRelease);
     void released(StreamRelease);
     void done_platform_operation(MirPlatformOperationCallback, void* context);
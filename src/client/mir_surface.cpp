@@ -22,6 +22,7 @@
 #include "make_protobuf_object.h"
 #include "mir_protobuf.pb.h"
 #include "connection_surface_map.h"
+#include "server_frame_timing.h"
 
 #include "mir_toolkit/mir_client_library.h"
 #include "mir_toolkit/mir_blob.h"
@@ -124,6 +125,7 @@ MirSurface::MirSurface(
     surface{mcl::make_protobuf_object<mir::protobuf::Surface>()},
     connection_(conn),
     frame_clock(std::make_shared<FrameClock>()),
+    server_frame_timing(std::make_shared<mcl::ServerFrameTiming>(server)),
     creation_handle(handle)
 {
     surface->set_error(error);
@@ -155,6 +157,7 @@ MirSurface::MirSurface(
       keymapper(std::make_shared<mircv::XKBMapper>()),
       configure_result{mcl::make_protobuf_object<mir::protobuf::SurfaceSetting>()},
       frame_clock(std::make_shared<FrameClock>()),
+      server_frame_timing(std::make_shared<mcl::ServerFrameTiming>(server)),
       creation_handle(handle),
       size({surface_proto.width(), surface_proto.height()}),
       format(static_cast<MirPixelFormat>(surface_proto.pixel_format())),
@@ -229,13 +232,21 @@ MirSurface::~MirSurface()
 void MirSurface::configure_frame_clock()
 {
     /*
-     * TODO: Implement frame_clock->set_resync_callback(...) when IPC to get
-     *       timestamps from the server exists.
-     *       Until we do, client-side vsync will perform suboptimally (it is
-     *       randomly up to one frame out of phase with the real display).
-     *       However even while it's suboptimal it's dramatically lower latency
-     *       than the old approach and still totally eliminates nesting lag.
+     * Error surfaces have no server to ask. They also never get a
+     * window_output event, so the clock stays unthrottled anyway.
      */
+    if (!server)
+        return;
+
+    /*
+     * The frame clock may outlive us (buffer streams hold on to it), so
+     * capture only what's shared with the clock.
+     */
+    frame_clock->set_resync_callback(
+        [timing = server_frame_timing]
+        {
+            return timing->last_frame();
+        });
 }
 
 MirWindowParameters MirSurface::get_parameters() const
@@ -539,6 +550,7 @@ void MirSurface::handle_event(MirEvent& e)
          */
         auto soevent = mir_event_get_surface_output_event(&e);
         auto rate = mir_surface_output_event_get_refresh_rate(soevent);
+        server_frame_timing->set_output(mir_surface_output_event_get_output_id(soevent));
         if (rate > 10.0)  // should be >0, but 10 to workaround LP: #1639725
         {
             std::chrono::nanoseconds const ns(
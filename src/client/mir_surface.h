@@ -71,6 +71,7 @@ class DisplayServerDebug;
 
 class ClientBuffer;
 class MirBufferStreamFactory;
+class ServerFrameTiming;
 
 struct MemoryRegion;
 }
@@ -266,6 +267,8 @@ private:
     MirOrientation orientation = mir_orientation_normal;
 
     std::shared_ptr<mir::client::FrameClock> const frame_clock;
+    // The server's vblanks on the output we're on; shared with the frame clock's resync callback
+    std::shared_ptr<mir::client::ServerFrameTiming> const server_frame_timing;
 
     std::function<void(MirEvent const*)> handle_event_callback;
     std::function<void(MirWindowEvent const*)> handle_drag_and_drop_start_callback = [](auto){};
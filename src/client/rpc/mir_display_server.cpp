@@ -18,7 +18,9 @@
 
 #include "mir_basic_rpc_channel.h"
 #include "mir_display_server.h"
+#include "submission_ring_producer.h"
 
+#include <atomic>
 #include <string>
 
 namespace mclr = mir::client::rpc;
@@ -194,6 +196,13 @@ void mclr::DisplayServer::submit_buffer(
     mir::protobuf::Void* response,
     google::protobuf::Closure* done)
 {
+    auto const ring = std::atomic_load(&submission_ring);
+    if (ring && request->buffer().fd_size() == 0 &&
+        ring->submit_buffer(request->id().value(), request->buffer().buffer_id()))
+    {
+        done->Run();
+        return;
+    }
     channel->call_method(std::string(__func__), request, response, done);
 }
 void mclr::DisplayServer::allocate_buffers(
@@ -208,6 +217,13 @@ void mclr::DisplayServer::release_buffers(
     mir::protobuf::Void* response,
     google::protobuf::Closure* done)
 {
+    auto const ring = std::atomic_load(&submission_ring);
+    if (ring && request->has_id() && request->buffers_size() == 1 && request->buffers(0).fd_size() == 0 &&
+        ring->release_buffer(request->id().value(), request->buffers(0).buffer_id()))
+    {
+        done->Run();
+        return;
+    }
     channel->call_method(std::string(__func__), request, response, done);
 }
 void mclr::DisplayServer::request_persistent_surface_id(
@@ -217,6 +233,13 @@ void mclr::DisplayServer::request_persistent_surface_id(
 {
     channel->call_method(std::string(__func__), request, response, done);
 }
+void mclr::DisplayServer::frame_timing(
+    mir::protobuf::FrameTimingRequest const* request,
+    mir::protobuf::FrameTiming* response,
+    google::protobuf::Closure* done)
+{
+    channel->call_method(std::string(__func__), request, response, done);
+}
 void mclr::DisplayServer::pong(
     mir::protobuf::PingEvent const* request,
     mir::protobuf::Void* response,
@@ -253,3 +276,14 @@ void mclr::DisplayServer::set_base_input_configuration(
 {
     channel->call_method(std::string(__func__), request, response, done);
 }
+void mclr::DisplayServer::create_submission_ring(
+    mir::protobuf::Void const* request,
+    mir::protobuf::SocketFD* response,
+    google::protobuf::Closure* done)
+{
+    channel->call_method(std::string(__func__), request, response, done);
+}
+void mclr::DisplayServer::use_submission_ring(std::shared_ptr<SubmissionRingProducer> const& ring)
+{
+    std::atomic_store(&submission_ring, ring);
+}
@@ -29,6 +29,7 @@ namespace client
 namespace rpc
 {
 class MirBasicRpcChannel;
+class SubmissionRingProducer;
 
 class DisplayServer : public mir::protobuf::DisplayServer
 {
@@ -143,6 +144,10 @@ public:
         mir::protobuf::SurfaceId const* request,
         mir::protobuf::PersistentSurfaceId* response,
         google::protobuf::Closure* done) override;
+    void frame_timing(
+        mir::protobuf::FrameTimingRequest const* request,
+        mir::protobuf::FrameTiming* response,
+        google::protobuf::Closure* done) override;
     void pong(
         mir::protobuf::PingEvent const* request,
         mir::protobuf::Void* response,
@@ -163,8 +168,19 @@ public:
         mir::protobuf::InputConfigurationRequest const* request,
         mir::protobuf::Void* response,
         google::protobuf::Closure* done) override;
+
+    /// Ask the server for a SubmissionRing (see mir/frontend/submission_ring.h)
+    void create_submission_ring(
+        mir::protobuf::Void const* request,
+        mir::protobuf::SocketFD* response,
+        google::protobuf::Closure* done);
+
+    /// Route fd-less submit_buffer and release_buffers calls through ring
+    void use_submission_ring(std::shared_ptr<SubmissionRingProducer> const& ring);
+
 private:
     std::shared_ptr<mir::client::rpc::MirBasicRpcChannel> const channel;
+    std::shared_ptr<SubmissionRingProducer> submission_ring;
 };
 }
 }
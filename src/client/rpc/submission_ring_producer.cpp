@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "submission_ring_producer.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mclr = mir::client::rpc;
+namespace mf = mir::frontend;
+
+class mclr::SubmissionRingProducer::Mapping
+{
+public:
+    Mapping(int fd)
+    {
+        struct stat info;
+        if (fstat(fd, &info) < 0)
+            BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to stat submission ring"}));
+
+        // The server sizes the file; refuse anything too small to hold a ring
+        if (static_cast<size_t>(info.st_size) < size)
+            BOOST_THROW_EXCEPTION(std::runtime_error("Submission ring is too small"));
+
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED)
+            BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to map submission ring"}));
+    }
+
+    ~Mapping() noexcept
+    {
+        munmap(address, size);
+    }
+
+    size_t const size = mf::SubmissionRing::mapping_size();
+    void* address;
+};
+
+mclr::SubmissionRingProducer::SubmissionRingProducer(Fd const& ring_fd, Fd const& wakeup_fd) :
+    mapping{std::make_unique<Mapping>(ring_fd)},
+    wakeup_fd{wakeup_fd},
+    ring{mapping->address, false}
+{
+}
+
+mclr::SubmissionRingProducer::~SubmissionRingProducer() noexcept = default;
+
+bool mclr::SubmissionRingProducer::submit_buffer(int stream_id, int buffer_id)
+{
+    return post({mf::SubmissionRingOperation::submit_buffer, stream_id, buffer_id, 0});
+}
+
+bool mclr::SubmissionRingProducer::release_buffer(int stream_id, int buffer_id)
+{
+    return post({mf::SubmissionRingOperation::release_buffer, stream_id, buffer_id, 0});
+}
+
+bool mclr::SubmissionRingProducer::post(mf::SubmissionRingEntry const& entry)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    // If the ring is full the caller uses the socket instead. That doesn't reorder
+    // anything, as the server handles the ring before each socket invocation.
+    if (!ring.push(entry))
+    {
+        eventfd_write(wakeup_fd, 1);
+        return false;
+    }
+
+    if (ring.consumer_needs_wakeup())
+        eventfd_write(wakeup_fd, 1);
+
+    return true;
+}
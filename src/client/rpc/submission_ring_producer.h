@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_RPC_SUBMISSION_RING_PRODUCER_H_
+#define MIR_CLIENT_RPC_SUBMISSION_RING_PRODUCER_H_
+
+#include "mir/frontend/submission_ring.h"
+#include "mir/fd.h"
+
+#include <memory>
+#include <mutex>
+
+namespace mir
+{
+namespace client
+{
+namespace rpc
+{
+/// The client end of a connection's SubmissionRing.
+///
+/// Buffer submissions and releases posted here reach the server without a
+/// socket round-trip; the server is only woken when it has gone idle.
+class SubmissionRingProducer
+{
+public:
+    /// \param ring_fd   the shared memory backing the ring, from the server
+    /// \param wakeup_fd the eventfd to signal the server through
+    SubmissionRingProducer(Fd const& ring_fd, Fd const& wakeup_fd);
+    ~SubmissionRingProducer() noexcept;
+
+    /// Returns false if the ring is full, in which case the caller should
+    /// use the socket instead.
+    bool submit_buffer(int stream_id, int buffer_id);
+    bool release_buffer(int stream_id, int buffer_id);
+
+private:
+    bool post(frontend::SubmissionRingEntry const& entry);
+
+    class Mapping;
+    std::unique_ptr<Mapping> const mapping;
+    Fd const wakeup_fd;
+
+    std::mutex mutex;
+    frontend::SubmissionRing ring;
+};
+}
+}
+}
+
+#endif /* MIR_CLIENT_RPC_SUBMISSION_RING_PRODUCER_H_ */
@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server_frame_timing.h"
+#include "rpc/mir_display_server.h"
+#include "mir_protobuf.pb.h"
+
+#include "mir_toolkit/client_types.h"
+
+using mir::client::ServerFrameTiming;
+using mir::time::PosixTimestamp;
+
+namespace mp = mir::protobuf;
+namespace gp = google::protobuf;
+
+namespace
+{
+typedef std::lock_guard<std::mutex> Lock;
+
+uint32_t const no_output = static_cast<uint32_t>(mir_display_output_id_invalid);
+
+struct FrameTimingQuery
+{
+    std::shared_ptr<ServerFrameTiming> const owner;
+    mp::FrameTimingRequest request;
+    mp::FrameTiming response;
+};
+
+void frame_timing_received(std::shared_ptr<FrameTimingQuery> query)
+{
+    auto const& response = query->response;
+
+    // An unknown output (or a server without frame timing) leaves us guessing
+    PosixTimestamp frame;
+    if (!response.has_error() && response.has_ust())
+        frame = {response.clock_id(), std::chrono::nanoseconds{response.ust()}};
+
+    query->owner->frame_received(query->request.output_id(), frame);
+}
+} // namespace
+
+ServerFrameTiming::ServerFrameTiming(rpc::DisplayServer* server)
+    : server{server}
+    , output_id{no_output}
+    , query_pending{false}
+{
+}
+
+void ServerFrameTiming::set_output(uint32_t output_id)
+{
+    Lock lock(mutex);
+    if (this->output_id != output_id)
+    {
+        this->output_id = output_id;
+        frame = {};
+    }
+}
+
+PosixTimestamp ServerFrameTiming::last_frame()
+{
+    std::shared_ptr<FrameTimingQuery> query;
+    {
+        Lock lock(mutex);
+        if (output_id == no_output || query_pending)
+            return frame;
+
+        query = std::make_shared<FrameTimingQuery>(FrameTimingQuery{shared_from_this(), {}, {}});
+        query->request.set_output_id(output_id);
+        query_pending = true;
+    }
+
+    try
+    {
+        server->frame_timing(
+            &query->request,
+            &query->response,
+            gp::NewCallback(&frame_timing_received, query));
+    }
+    catch (std::exception const&)
+    {
+        Lock lock(mutex);
+        query_pending = false;
+    }
+
+    Lock lock(mutex);
+    return frame;
+}
+
+void ServerFrameTiming::frame_received(uint32_t output_id, PosixTimestamp frame)
+{
+    Lock lock(mutex);
+    query_pending = false;
+
+    // Frames from the output we've since left are no use
+    if (this->output_id == output_id && frame.nanoseconds != frame.nanoseconds.zero())
+        this->frame = frame;
+}
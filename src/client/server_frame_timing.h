@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_SERVER_FRAME_TIMING_H_
+#define MIR_CLIENT_SERVER_FRAME_TIMING_H_
+
+#include "mir/time/posix_timestamp.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace mir { namespace client {
+namespace rpc { class DisplayServer; }
+
+/**
+ * The last vblank the server told us about on the output a surface is on.
+ *
+ * Any past vblank gives a FrameClock its phase, so last_frame() answers from
+ * what we already know and asks the server for a newer frame in the
+ * background. Rendering never waits for a round trip.
+ */
+class ServerFrameTiming : public std::enable_shared_from_this<ServerFrameTiming>
+{
+public:
+    explicit ServerFrameTiming(rpc::DisplayServer* server);
+
+    /// Follow a (different) output. What we knew of the old one is discarded.
+    void set_output(uint32_t output_id);
+
+    /// The last frame we know of (a default timestamp if none).
+    time::PosixTimestamp last_frame();
+
+    void frame_received(uint32_t output_id, time::PosixTimestamp frame);
+
+private:
+    rpc::DisplayServer* const server;
+
+    std::mutex mutex;  // Protects below fields:
+    uint32_t output_id;
+    time::PosixTimestamp frame;
+    bool query_pending;
+};
+
+}} // namespace mir::client
+
+#endif // MIR_CLIENT_SERVER_FRAME_TIMING_H_
@@ -28,6 +28,10 @@ namespace mir {
 void logv(logging::Severity sev, char const* component,
           char const* fmt, va_list va)
 {
+    // Checked before formatting, so that filtered messages are cheap
+    if (!logging::is_enabled(sev))
+        return;
+
     char message[1024];
     int max = sizeof(message) - 1;
     int len = vsnprintf(message, max, fmt, va);
@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+#include "mir/thread_name.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace ml = mir::logging;
+
+/// A queued message. The queue is a bounded multi-producer queue (after Dmitry Vyukov's):
+/// sequence says whether the slot is free for the producer at a position, or holds the
+/// message for the consumer at a position.
+struct ml::AsyncLogger::Slot
+{
+    std::atomic<size_t> sequence;
+    Severity severity;
+    char component[64];
+    char message[1024];     // The same limit as mir::logv()
+};
+
+namespace
+{
+void copy_truncated(char* to, size_t size, char const* from)
+{
+    strncpy(to, from, size - 1);
+    to[size - 1] = '\0';
+}
+}
+
+ml::AsyncLogger::AsyncLogger(std::shared_ptr<Logger> const& sink, size_t capacity) :
+    sink{sink},
+    capacity{std::max<size_t>(capacity, 1)},
+    slots{new Slot[this->capacity]}
+{
+    for (size_t i = 0; i != this->capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    writer = std::thread{[this]
+        {
+            mir::set_thread_name("Mir/Logger");
+            run_writer();
+        }};
+}
+
+ml::AsyncLogger::~AsyncLogger()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        stopping = true;
+        wake_writer.notify_one();
+    }
+    writer.join();
+}
+
+void ml::AsyncLogger::log(Severity severity, std::string const& message, std::string const& component)
+{
+    if (severity == Severity::critical)
+    {
+        // Probably the last thing we log before aborting, so don't leave it in the queue
+        flush();
+        sink->log(severity, message, component);
+        return;
+    }
+
+    size_t position;
+    if (auto const slot = reserve(position))
+    {
+        slot->severity = severity;
+        copy_truncated(slot->component, sizeof slot->component, component.c_str());
+        copy_truncated(slot->message, sizeof slot->message, message.c_str());
+        commit(*slot, position);
+    }
+}
+
+void ml::AsyncLogger::log(char const* component, Severity severity, char const* format, ...)
+{
+    if (!is_enabled(severity))
+        return;
+
+    va_list va;
+    va_start(va, format);
+
+    if (severity == Severity::critical)
+    {
+        char message[sizeof Slot::message];
+        vsnprintf(message, sizeof message, format, va);
+        log(severity, message, component);
+    }
+    else
+    {
+        // Format straight into the queue, without constructing any strings
+        size_t position;
+        if (auto const slot = reserve(position))
+        {
+            slot->severity = severity;
+            copy_truncated(slot->component, sizeof slot->component, component);
+            vsnprintf(slot->message, sizeof slot->message, format, va);
+            commit(*slot, position);
+        }
+    }
+
+    va_end(va);
+}
+
+void ml::AsyncLogger::flush()
+{
+    auto const target = enqueue_position.load(std::memory_order_relaxed);
+
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    written.wait(lock, [&]{ return written_position >= target; });
+}
+
+auto ml::AsyncLogger::reserve(size_t& position) -> Slot*
+{
+    position = enqueue_position.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[position % capacity];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                return &slot;
+        }
+        else if (difference < 0)
+        {
+            // The writer hasn't caught up: drop the message rather than wait for it
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ml::AsyncLogger::commit(Slot& slot, size_t position)
+{
+    slot.sequence.store(position + 1, std::memory_order_release);
+
+    // Pairs with the fence in run_writer(): either the writer sees this message before
+    // it sleeps, or we see that it is waiting and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer_waiting.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        wake_writer.notify_one();
+    }
+}
+
+auto ml::AsyncLogger::has_pending() const -> bool
+{
+    auto const& slot = slots[dequeue_position % capacity];
+    return slot.sequence.load(std::memory_order_acquire) == dequeue_position + 1;
+}
+
+void ml::AsyncLogger::write_pending()
+{
+    while (has_pending())
+    {
+        auto& slot = slots[dequeue_position % capacity];
+        sink->log(slot.severity, slot.message, slot.component);
+        slot.sequence.store(dequeue_position + capacity, std::memory_order_release);
+        ++dequeue_position;
+    }
+
+    if (auto const count = dropped.exchange(0, std::memory_order_relaxed))
+    {
+        sink->log(
+            Severity::warning,
+            std::to_string(count) + " log message(s) dropped: they were logged faster than they could be written",
+            "logging");
+    }
+}
+
+void ml::AsyncLogger::run_writer()
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+
+    for (;;)
+    {
+        lock.unlock();
+        write_pending();
+        lock.lock();
+
+        written_position = dequeue_position;
+        written.notify_all();
+
+        if (stopping && !has_pending())
+            return;
+
+        writer_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_writer.wait(lock, [this]{ return stopping || has_pending(); });
+        writer_waiting.store(false, std::memory_order_relaxed);
+    }
+}
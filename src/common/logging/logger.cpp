@@ -19,14 +19,22 @@
 #include "mir/logging/dumb_console_logger.h"
 #include "mir/logging/logger.h"
 
-#include <mutex>
+#include <atomic>
 #include <cstdarg>
 #include <cstdio>
 
 namespace ml = mir::logging;
 
+namespace
+{
+std::atomic<ml::Severity> max_severity{ml::Severity::debug};
+}
+
 void ml::Logger::log(char const* component, Severity severity, char const* format, ...)
 {
+    if (!is_enabled(severity))
+        return;
+
     auto const bufsize = 4096;
     va_list va;
     va_start(va, format);
@@ -40,22 +48,28 @@ void ml::Logger::log(char const* component, Severity severity, char const* forma
 
 namespace
 {
-std::mutex log_mutex;
+// Read on every log call, so it is accessed atomically rather than under a mutex
 std::shared_ptr<ml::Logger> the_logger;
 
 std::shared_ptr<ml::Logger> get_logger()
 {
-    std::lock_guard<decltype(log_mutex)> lock{log_mutex};
+    if (auto const logger = std::atomic_load(&the_logger))
+        return logger;
 
-    if (!the_logger)
-        the_logger = std::make_shared<ml::DumbConsoleLogger>();
+    std::shared_ptr<ml::Logger> expected;
+    std::shared_ptr<ml::Logger> const fallback = std::make_shared<ml::DumbConsoleLogger>();
+    if (std::atomic_compare_exchange_strong(&the_logger, &expected, fallback))
+        return fallback;
 
-    return the_logger;
+    return expected;
 }
 }
 
 void ml::log(ml::Severity severity, const std::string& message, const std::string& component)
 {
+    if (!is_enabled(severity))
+        return;
+
     auto const logger = get_logger();
 
     logger->log(severity, message, component);
@@ -65,11 +79,20 @@ void ml::set_logger(std::shared_ptr<Logger> const& new_logger)
 {
     if (new_logger)
     {
-        std::lock_guard<decltype(log_mutex)> lock{log_mutex};
-        the_logger = new_logger;
+        std::atomic_store(&the_logger, new_logger);
     }
 }
 
+void ml::set_max_severity(Severity severity)
+{
+    max_severity.store(severity, std::memory_order_relaxed);
+}
+
+auto ml::is_enabled(Severity severity) -> bool
+{
+    return severity <= max_severity.load(std::memory_order_relaxed);
+}
+
 namespace mir
 {
 namespace logging
@@ -81,4 +104,3 @@ void log(ml::Severity severity, std::string const& message)
 }
 }
 }
-
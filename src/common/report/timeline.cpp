@@ -0,0 +1,360 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/report/timeline.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mrt = mir::report::timeline;
+
+struct mrt::Timeline::Event
+{
+    char const* name;
+    int64_t start;          ///< Nanoseconds on the steady clock
+    int64_t duration;       ///< Nanoseconds, for spans
+    uint64_t id;            ///< For flows
+    char phase;
+};
+
+namespace
+{
+/// Thread buffers are allocated in chunks of this many events, as they fill
+size_t const events_per_chunk = 1024;
+}
+
+/// Only the thread that owns a buffer writes to it. Events before count (and the chunks holding them)
+/// are complete, so the buffer can be read while the thread is recording. A new recording resets the
+/// buffer the next time the thread records (so that only the owning thread writes count), and reuses
+/// its chunks.
+struct mrt::Timeline::ThreadBuffer
+{
+    ThreadBuffer(size_t capacity, std::shared_ptr<std::atomic<bool> const> exited) :
+        capacity{capacity},
+        chunks{new std::unique_ptr<Event[]>[(capacity + events_per_chunk - 1) / events_per_chunk]},
+        exited{std::move(exited)}
+    {
+    }
+
+    auto event(size_t index) const -> Event&
+    {
+        return chunks[index / events_per_chunk][index % events_per_chunk];
+    }
+
+    std::thread::id const thread{std::this_thread::get_id()};
+    pid_t const tid{static_cast<pid_t>(syscall(SYS_gettid))};
+    std::string name;
+
+    size_t const capacity;
+    std::unique_ptr<std::unique_ptr<Event[]>[]> const chunks;
+    std::shared_ptr<std::atomic<bool> const> const exited;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::vector<uint64_t> held_flows;
+};
+
+/// The buffer this thread last recorded to, and the Timeline it belongs to
+struct mrt::Timeline::CachedBuffer
+{
+    ~CachedBuffer()
+    {
+        exited->store(true, std::memory_order_release);
+    }
+
+    uint64_t instance{0};
+    ThreadBuffer* buffer{nullptr};
+
+    /// Shared with this thread's buffers, so their memory can be reclaimed once it has exited
+    std::shared_ptr<std::atomic<bool>> const exited{std::make_shared<std::atomic<bool>>(false)};
+};
+
+namespace
+{
+std::atomic<uint64_t> next_instance{1};
+
+auto nanoseconds(std::chrono::steady_clock::time_point time) -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+void write_string(std::ostream& out, std::string const& value)
+{
+    out << '"';
+    for (auto const c : value)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < ' ')
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+/// Trace-event timestamps are in microseconds
+void write_microseconds(std::ostream& out, int64_t nanoseconds)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof buffer, "%" PRId64 ".%03" PRId64, nanoseconds / 1000, nanoseconds % 1000);
+    out << buffer;
+}
+}
+
+mrt::Timeline::Timeline(size_t events_per_thread) :
+    instance{next_instance++},
+    events_per_thread{std::max<size_t>(events_per_thread, 1)}
+{
+}
+
+mrt::Timeline::~Timeline() = default;
+
+void mrt::Timeline::start()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    free_exited_threads(lock, false);
+    started = std::chrono::steady_clock::now();
+    epoch.fetch_add(1, std::memory_order_release);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void mrt::Timeline::stop()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    recording.store(false, std::memory_order_relaxed);
+    free_exited_threads(lock, true);
+}
+
+void mrt::Timeline::complete(char const* name, std::chrono::steady_clock::time_point start)
+{
+    auto const end = std::chrono::steady_clock::now();
+    push('X', name, nanoseconds(start), nanoseconds(end) - nanoseconds(start), 0);
+}
+
+void mrt::Timeline::flow(FlowPhase phase, uint64_t id)
+{
+    if (is_recording())
+        push(static_cast<char>(phase), "frame", nanoseconds(std::chrono::steady_clock::now()), 0, id);
+}
+
+void mrt::Timeline::hold_flow(uint64_t id)
+{
+    if (is_recording())
+    {
+        if (auto const buffer = current_buffer())
+            buffer->held_flows.push_back(id);
+    }
+}
+
+auto mrt::Timeline::release_held_flows() -> std::vector<uint64_t>
+{
+    std::vector<uint64_t> result;
+
+    // Don't create a buffer just to find it is empty
+    auto const& cached = cached_buffer();
+    if (cached.instance == instance && cached.buffer)
+        result.swap(cached.buffer->held_flows);
+
+    return result;
+}
+
+void mrt::Timeline::end_flows(std::vector<uint64_t> const& ids)
+{
+    for (auto const id : ids)
+        flow(FlowPhase::end, id);
+}
+
+auto mrt::Timeline::cached_buffer() -> CachedBuffer&
+{
+    static thread_local CachedBuffer cached;
+    return cached;
+}
+
+auto mrt::Timeline::this_thread() -> ThreadBuffer*
+{
+    auto& cached = cached_buffer();
+    if (cached.instance == instance)
+        return cached.buffer;
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    // A thread id can be reused once a thread has exited
+    auto const self = std::this_thread::get_id();
+    auto buffer = std::find_if(threads.begin(), threads.end(), [&](auto const& t)
+        {
+            return t->thread == self && !t->exited->load(std::memory_order_acquire);
+        });
+
+    if (buffer == threads.end())
+    {
+        // The events are allocated in push(), as they are recorded, so this is small
+        try
+        {
+            threads.push_back(std::make_unique<ThreadBuffer>(events_per_thread, cached.exited));
+        }
+        catch (std::bad_alloc const&)
+        {
+            return nullptr;
+        }
+
+        char name[16]{};
+        pthread_getname_np(pthread_self(), name, sizeof name);
+        threads.back()->name = name;
+
+        buffer = threads.end() - 1;
+    }
+
+    cached.instance = instance;
+    cached.buffer = buffer->get();
+    return cached.buffer;
+}
+
+auto mrt::Timeline::current_buffer() -> ThreadBuffer*
+{
+    auto const buffer = this_thread();
+    if (!buffer)
+        return nullptr;
+
+    auto const current = epoch.load(std::memory_order_acquire);
+    if (buffer->epoch.load(std::memory_order_relaxed) != current)
+    {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->held_flows.clear();
+        buffer->epoch.store(current, std::memory_order_release);
+    }
+
+    return buffer;
+}
+
+void mrt::Timeline::push(char phase, char const* name, int64_t start, int64_t duration, uint64_t id)
+{
+    auto const buffer = current_buffer();
+    if (!buffer)
+        return;
+
+    auto const count = buffer->count.load(std::memory_order_relaxed);
+    if (count == buffer->capacity)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& chunk = buffer->chunks[count / events_per_chunk];
+    if (!chunk)
+    {
+        try
+        {
+            chunk.reset(new Event[std::min(events_per_chunk, buffer->capacity - count)]);
+        }
+        catch (std::bad_alloc const&)
+        {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    buffer->event(count) = Event{name, start, duration, id, phase};
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void mrt::Timeline::write_to(std::ostream& out) const
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const pid = getpid();
+    auto const origin = nanoseconds(started);
+    auto const current = epoch.load(std::memory_order_acquire);
+    uint64_t dropped = 0;
+    char const* separator = "\n";
+
+    out << "{\"traceEvents\":[";
+
+    for (auto const& thread : threads)
+    {
+        if (thread->epoch.load(std::memory_order_acquire) != current)
+            continue;
+
+        auto const count = thread->count.load(std::memory_order_acquire);
+        dropped += thread->dropped.load(std::memory_order_relaxed);
+
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << thread->tid
+            << ",\"args\":{\"name\":";
+        write_string(out, thread->name);
+        out << "}}";
+        separator = ",\n";
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            auto const& event = thread->event(i);
+
+            out << separator << "{\"name\":";
+            write_string(out, event.name);
+            out << ",\"cat\":\"mir\",\"ph\":\"" << event.phase << "\",\"ts\":";
+            write_microseconds(out, std::max<int64_t>(event.start - origin, 0));
+
+            if (event.phase == 'X')
+            {
+                out << ",\"dur\":";
+                write_microseconds(out, event.duration);
+            }
+            else
+            {
+                out << ",\"id\":" << event.id;
+                if (event.phase == static_cast<char>(FlowPhase::end))
+                    out << ",\"bp\":\"e\"";
+            }
+
+            out << ",\"pid\":" << pid << ",\"tid\":" << thread->tid << "}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+
+    if (!is_recording())
+        free_exited_threads(lock, false);
+}
+
+void mrt::Timeline::free_exited_threads(std::lock_guard<std::mutex> const&, bool keep_current) const
+{
+    auto const current = epoch.load(std::memory_order_acquire);
+
+    threads.erase(
+        std::remove_if(threads.begin(), threads.end(), [&](auto const& thread)
+            {
+                return thread->exited->load(std::memory_order_acquire) &&
+                    !(keep_current &&
+                        thread->epoch.load(std::memory_order_acquire) == current &&
+                        thread->count.load(std::memory_order_acquire) != 0);
+            }),
+        threads.end());
+}
+
+auto mrt::the_timeline() -> Timeline&
+{
+    static Timeline timeline;
+    return timeline;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_SUBMISSION_RING_H_
+#define MIR_FRONTEND_SUBMISSION_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mir
+{
+namespace frontend
+{
+/// Operations that a client can post through the submission ring instead of
+/// making a submit_buffer/release_buffers RPC
+enum class SubmissionRingOperation : uint32_t
+{
+    submit_buffer = 1,
+    release_buffer = 2
+};
+
+struct SubmissionRingEntry
+{
+    SubmissionRingOperation operation;
+    int32_t stream_id;
+    int32_t buffer_id;
+    uint32_t reserved;
+};
+
+/// A single-producer/single-consumer ring of SubmissionRingEntry living in
+/// memory shared between a client (the producer) and the server (the consumer).
+///
+/// The server creates the backing file and an eventfd and hands both to the
+/// client. The producer only signals the eventfd when the consumer has said
+/// it is going to sleep, so a stream of submissions costs at most one wakeup
+/// per batch rather than one socket round-trip per buffer.
+///
+/// The client can write anything to the shared memory, so the consumer keeps
+/// its own index and only takes the producer's as a hint.
+class SubmissionRing
+{
+public:
+    static uint32_t const capacity = 256;
+
+    /// The contents of the shared memory
+    struct Layout
+    {
+        alignas(64) std::atomic<uint32_t> head;     ///< Written by the consumer, as it consumes entries
+        alignas(64) std::atomic<uint32_t> tail;     ///< Written by the producer, as it posts entries
+        alignas(64) std::atomic<uint32_t> consumer_waiting;
+        SubmissionRingEntry entries[capacity];
+    };
+
+    static constexpr size_t mapping_size()
+    {
+        return sizeof(Layout);
+    }
+
+    /// \param mapping  a mapping of at least mapping_size() bytes
+    /// \param initialise true for the side that created the mapping
+    SubmissionRing(void* mapping, bool initialise) :
+        layout{static_cast<Layout*>(mapping)}
+    {
+        if (initialise)
+        {
+            layout->head.store(0, std::memory_order_relaxed);
+            layout->tail.store(0, std::memory_order_relaxed);
+            layout->consumer_waiting.store(1, std::memory_order_release);
+        }
+    }
+
+    /// Producer: append an entry. Returns false if the ring is full.
+    bool push(SubmissionRingEntry const& entry)
+    {
+        auto const tail = layout->tail.load(std::memory_order_relaxed);
+        auto const head = layout->head.load(std::memory_order_acquire);
+
+        if (tail - head >= capacity)
+            return false;
+
+        layout->entries[tail % capacity] = entry;
+        layout->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Producer: after one or more push()es, whether the consumer needs to be woken.
+    bool consumer_needs_wakeup()
+    {
+        // Pairs with prepare_to_wait(): either we see the consumer waiting,
+        // or it sees the entries we've just pushed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return layout->consumer_waiting.exchange(0, std::memory_order_acq_rel) != 0;
+    }
+
+    /// Consumer: call handler for up to max_entries pending entries, in order.
+    /// \return the number of entries handled
+    template<typename Handler>
+    size_t drain(Handler&& handler, uint32_t max_entries = capacity)
+    {
+        auto const tail = layout->tail.load(std::memory_order_acquire);
+        uint32_t const pending = tail - consumed;
+
+        // A producer that respects head can't get more than a ring ahead, so
+        // the entries can't be trusted: skip them rather than guess.
+        if (pending > capacity)
+        {
+            consumed = tail;
+            layout->head.store(consumed, std::memory_order_release);
+            return 0;
+        }
+
+        auto const available = pending < max_entries ? pending : max_entries;
+
+        for (auto i = 0u; i != available; ++i)
+        {
+            SubmissionRingEntry const entry = layout->entries[consumed % capacity];
+            layout->head.store(++consumed, std::memory_order_release);
+            handler(entry);
+        }
+
+        return available;
+    }
+
+    /// Consumer: announce that we're about to wait for a wakeup.
+    /// Returns false if entries arrived meanwhile and we should drain() again instead.
+    bool prepare_to_wait()
+    {
+        layout->consumer_waiting.store(1, std::memory_order_seq_cst);
+        return layout->tail.load(std::memory_order_seq_cst) == consumed;
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+        "std::atomic<uint32_t> must be lock-free to be shared between processes");
+
+    Layout* const layout;
+    uint32_t consumed{0};   ///< The consumer's index. Only used by the consumer.
+};
+}
+}
+
+#endif /* MIR_FRONTEND_SUBMISSION_RING_H_ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_LOGGER_H_
+#define MIR_LOGGING_ASYNC_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mir
+{
+namespace logging
+{
+/// Passes messages to another Logger from a background thread.
+///
+/// Logging copies the message into a fixed-size, lock-free queue and returns, so threads that log
+/// are not held up by a slow sink. If the queue is full the message is dropped, and the number
+/// dropped is logged once there is space. Critical messages are written before log() returns.
+class AsyncLogger : public Logger
+{
+public:
+    /// \param sink         the logger that messages are written to
+    /// \param capacity     the number of messages that can be waiting to be written
+    AsyncLogger(std::shared_ptr<Logger> const& sink, size_t capacity = 1024);
+
+    /// Writes any messages that are waiting
+    ~AsyncLogger();
+
+    void log(Severity severity, std::string const& message, std::string const& component) override;
+    void log(char const* component, Severity severity, char const* format, ...) override
+        __attribute__ ((format (printf, 4, 5)));
+
+    /// Waits until the messages logged before this call have been written
+    void flush();
+
+private:
+    struct Slot;
+
+    auto reserve(size_t& position) -> Slot*;
+    void commit(Slot& slot, size_t position);
+    auto has_pending() const -> bool;
+    void write_pending();
+    void run_writer();
+
+    std::shared_ptr<Logger> const sink;
+    size_t const capacity;
+    std::unique_ptr<Slot[]> const slots;
+
+    std::atomic<size_t> enqueue_position{0};
+    size_t dequeue_position{0};                 ///< Only used by the writer thread
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex mutex;
+    std::condition_variable wake_writer;
+    std::condition_variable written;
+    std::atomic<bool> writer_waiting{false};
+    size_t written_position{0};                 ///< Guarded by mutex
+    bool stopping{false};                       ///< Guarded by mutex
+
+    std::thread writer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_LOGGER_H_
@@ -142,6 +142,10 @@ public:
         mir::protobuf::SurfaceId const* request,
         mir::protobuf::PersistentSurfaceId* response,
         google::protobuf::Closure* done) = 0;
+    virtual void frame_timing(
+        mir::protobuf::FrameTimingRequest const* request,
+        mir::protobuf::FrameTiming* response,
+        google::protobuf::Closure* done) = 0;
     virtual void pong(
         mir::protobuf::PingEvent const* request,
         mir::protobuf::Void* response,
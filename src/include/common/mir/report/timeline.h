@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_TIMELINE_H_
+#define MIR_REPORT_TIMELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace report
+{
+namespace timeline
+{
+/// The phases of a flow: the arrows that link the spans that handled the same thing (e.g. a client
+/// buffer) on different threads. Flows attach to the span that is open when they are recorded.
+enum class FlowPhase : char
+{
+    begin = 's',
+    step = 't',
+    end = 'f'
+};
+
+/// Records spans of time spent on each thread, and the flows between them, for viewing as a timeline.
+///
+/// Each thread records into its own buffer, without locking, so recording usually costs a clock read
+/// and a store. Buffers grow in chunks, as threads record, up to a fixed size. While not recording,
+/// everything returns after checking a flag. The recording is written in Chrome trace-event JSON
+/// format, which chrome://tracing and ui.perfetto.dev can open.
+class Timeline
+{
+public:
+    /// \param events_per_thread    the number of events each thread can record, before the rest are dropped
+    explicit Timeline(size_t events_per_thread = 1 << 14);
+    ~Timeline();
+
+    auto is_recording() const -> bool { return recording.load(std::memory_order_relaxed); }
+
+    /// Discards the previous recording and starts a new one
+    void start();
+    void stop();
+
+    /// Writes the events recorded since start(). Writing while recording misses events recorded meanwhile.
+    /// Once stopped, this frees the buffers of threads that have exited, so their events are written once.
+    void write_to(std::ostream& out) const;
+
+    /// Records a span with \a name (which must outlive the Timeline) from \a start until now
+    void complete(char const* name, std::chrono::steady_clock::time_point start);
+
+    /// Records a phase of the flow \a id
+    void flow(FlowPhase phase, uint64_t id);
+
+    /// Keeps the flow \a id on this thread, for release_held_flows() to hand to a later span
+    void hold_flow(uint64_t id);
+    auto release_held_flows() -> std::vector<uint64_t>;
+    void end_flows(std::vector<uint64_t> const& ids);
+
+    Timeline(Timeline const&) = delete;
+    Timeline& operator=(Timeline const&) = delete;
+
+private:
+    struct Event;
+    struct ThreadBuffer;
+    struct CachedBuffer;
+
+    static auto cached_buffer() -> CachedBuffer&;
+    auto this_thread() -> ThreadBuffer*;
+    /// This thread's buffer, emptied if it holds an earlier recording
+    auto current_buffer() -> ThreadBuffer*;
+    void push(char phase, char const* name, int64_t start, int64_t duration, uint64_t id);
+    /// Frees the buffers of threads that have exited, keeping any with events of the current recording
+    void free_exited_threads(std::lock_guard<std::mutex> const&, bool keep_current) const;
+
+    uint64_t const instance;
+    size_t const events_per_thread;
+
+    std::atomic<bool> recording{false};
+    std::atomic<uint64_t> epoch{0};
+
+    mutable std::mutex mutex;
+    std::chrono::steady_clock::time_point started;                  ///< Guarded by mutex
+    mutable std::vector<std::unique_ptr<ThreadBuffer>> threads;     ///< Guarded by mutex
+};
+
+/// The timeline the server records into
+auto the_timeline() -> Timeline&;
+
+/// Records a span from construction to destruction, if the timeline is recording when constructed
+class Span
+{
+public:
+    explicit Span(char const* name, Timeline& timeline = the_timeline()) :
+        timeline{timeline.is_recording() ? &timeline : nullptr},
+        name{name},
+        start{this->timeline ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}}
+    {
+    }
+
+    ~Span()
+    {
+        if (timeline)
+            timeline->complete(name, start);
+    }
+
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+private:
+    Timeline* const timeline;
+    char const* const name;
+    std::chrono::steady_clock::time_point const start;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_TIMELINE_H_ */
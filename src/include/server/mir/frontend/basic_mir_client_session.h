@@ -80,7 +80,7 @@ private:
     std::atomic<int> next_id;
     std::mutex mutable surfaces_and_streams_mutex;
 
-    void send_display_config(graphics::DisplayConfiguration const& info);
+    void send_display_config(std::shared_ptr<graphics::DisplayConfiguration const> const& info);
 
     auto checked_find(frontend::SurfaceId id) const -> Surfaces::const_iterator;
     auto checked_find(std::shared_ptr<scene::Surface> const& surface) const -> Surfaces::const_iterator; ///< O(n)
@@ -23,6 +23,7 @@
 #include "mir/frontend/buffer_sink.h"
 #include "mir/events/event_builders.h"
 
+#include <memory>
 #include <vector>
 
 class MirInputConfig;
@@ -43,7 +44,7 @@ public:
 
     virtual void handle_event(EventUPtr&& event) = 0;
     virtual void handle_lifecycle_event(MirLifecycleState state) = 0;
-    virtual void handle_display_config_change(graphics::DisplayConfiguration const& config) = 0;
+    virtual void handle_display_config_change(std::shared_ptr<graphics::DisplayConfiguration const> const& config) = 0;
     virtual void send_ping(int32_t serial) = 0;
     virtual void handle_input_config_change(MirInputConfig const& config) = 0;
     virtual void handle_error(ClientVisibleError const& error) = 0;
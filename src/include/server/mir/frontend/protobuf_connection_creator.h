@@ -39,6 +39,8 @@ class DisplayServer;
 class SocketConnection;
 class MessageProcessor;
 class ProtobufMessageSender;
+class SubmissionRingDispatcher;
+class DisplayConfigurationMessageCache;
 }
 
 class ProtobufConnectionCreator : public ConnectionCreator
@@ -69,6 +71,8 @@ private:
     std::shared_ptr<MessageProcessorReport> const report;
     std::atomic<int> next_session_id;
     std::shared_ptr<detail::Connections<detail::SocketConnection>> const connections;
+    std::shared_ptr<detail::SubmissionRingDispatcher> const ring_dispatcher;
+    std::shared_ptr<detail::DisplayConfigurationMessageCache> const display_config_cache;
 };
 }
 }
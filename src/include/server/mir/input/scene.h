@@ -25,6 +25,10 @@
 
 namespace mir
 {
+namespace geometry
+{
+struct Rectangle;
+}
 namespace scene
 {
 class Observer;
@@ -63,6 +67,15 @@ protected:
     Scene() = default;
     Scene(Scene const&) = delete;
     Scene& operator=(Scene const&) = delete;
+
+public:
+    // Cheaper alternative to emit_scene_changed() for an input visualization that has only
+    // changed within damage (i.e. a cursor moving or changing image): only outputs showing
+    // that region need recomposing. Scenes that don't override this recompose everything.
+    virtual void emit_scene_damaged(geometry::Rectangle const& /*damage*/)
+    {
+        emit_scene_changed();
+    }
 };
 
 }
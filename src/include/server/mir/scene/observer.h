@@ -24,6 +24,7 @@
 
 namespace mir
 {
+namespace geometry { struct Rectangle; }
 namespace scene
 {
 class Surface;
@@ -63,6 +64,12 @@ protected:
     virtual ~Observer() = default;
     Observer(Observer const&) = delete;
     Observer& operator=(Observer const&) = delete;
+
+public:
+    /// Something other than a surface (such as a software cursor) has changed the
+    /// content of the scene within damage, and only that region needs recomposition.
+    /// Observers that don't override this treat it as scene_changed().
+    virtual void scene_damaged(geometry::Rectangle const& damage);
 };
 
 }
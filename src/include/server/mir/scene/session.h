@@ -56,6 +56,7 @@ namespace scene
 {
 class Surface;
 class SurfaceObserver;
+class SessionResources;
 struct SurfaceCreationParameters;
 
 /// A single connection to a client application
@@ -100,6 +101,9 @@ public:
     virtual void destroy_buffer_stream(std::shared_ptr<frontend::BufferStream> const& stream) = 0;
     virtual void configure_streams(Surface& surface, std::vector<shell::StreamSpecification> const& config) = 0;
 
+    /// The buffer memory, surfaces and streams the session is using, and the limits on them
+    virtual auto resources() const -> std::shared_ptr<SessionResources> = 0;
+
 protected:
     Session() = default;
     Session(Session const&) = delete;
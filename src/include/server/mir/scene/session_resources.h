@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_SESSION_RESOURCES_H_
+#define MIR_SCENE_SESSION_RESOURCES_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace graphics
+{
+class Buffer;
+}
+namespace scene
+{
+/// Limits on the resources each session may use. Zero means no limit.
+struct ResourceLimits
+{
+    size_t max_surfaces{0};
+    size_t max_buffer_streams{0};
+    size_t buffer_bytes_warning{0};     ///< Soft limit: a warning is logged when the session goes over it
+    size_t max_buffer_bytes{0};         ///< Hard limit: buffers that would go over it are refused
+};
+
+/// The resources a session is using
+struct ResourceUsage
+{
+    size_t surfaces{0};
+    size_t buffer_streams{0};
+    size_t buffers{0};                  ///< Client buffers the server holds (allocated or committed, not yet released)
+    size_t buffer_bytes{0};             ///< The memory those buffers use
+    uint64_t commits{0};                ///< Buffers the client has submitted since it connected
+    uint64_t throttled_frames{0};       ///< Frames the client was held back from drawing on surfaces that weren't visible
+};
+
+/// Accounts for the resources a session uses, and enforces the limits on them.
+///
+/// Buffers are accounted while the server holds them, which can be after the session has closed,
+/// so this is shared between the session and its buffers.
+class SessionResources : public std::enable_shared_from_this<SessionResources>
+{
+public:
+    explicit SessionResources(std::string const& session_name) : session_name{session_name} {}
+
+    void set_limits(ResourceLimits const& limits);
+
+    auto usage() const -> ResourceUsage
+    {
+        ResourceUsage result;
+        result.surfaces = surfaces.load(std::memory_order_relaxed);
+        result.buffer_streams = buffer_streams.load(std::memory_order_relaxed);
+        result.buffers = buffers.load(std::memory_order_relaxed);
+        result.buffer_bytes = buffer_bytes.load(std::memory_order_relaxed);
+        result.commits = commits.load(std::memory_order_relaxed);
+        result.throttled_frames = throttled_frames.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    /// \throws std::runtime_error if the session has as many surfaces as it is allowed
+    void add_surface();
+    void remove_surface();
+
+    /// \throws std::runtime_error if the session has as many buffer streams as it is allowed
+    void add_buffer_stream();
+    void remove_buffer_stream();
+
+    /// Accounts for \a buffer until the returned pointer (and all copies of it) are released
+    /// \throws std::runtime_error if the buffer would take the session over its buffer memory limit
+    auto track(std::shared_ptr<graphics::Buffer> const& buffer) -> std::shared_ptr<graphics::Buffer>;
+
+    void buffer_committed() { commits.fetch_add(1, std::memory_order_relaxed); }
+    void frame_throttled() { throttled_frames.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    void release(size_t bytes);
+
+    std::string const session_name;
+
+    std::atomic<size_t> max_surfaces{0};
+    std::atomic<size_t> max_buffer_streams{0};
+    std::atomic<size_t> buffer_bytes_warning{0};
+    std::atomic<size_t> max_buffer_bytes{0};
+
+    std::atomic<size_t> surfaces{0};
+    std::atomic<size_t> buffer_streams{0};
+    std::atomic<size_t> buffers{0};
+    std::atomic<size_t> buffer_bytes{0};
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> throttled_frames{0};
+};
+}
+}
+
+#endif /* MIR_SCENE_SESSION_RESOURCES_H_ */
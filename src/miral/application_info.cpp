@@ -20,6 +20,7 @@
 #include "miral/window.h"
 
 #include <mir/scene/session.h>
+#include <mir/scene/session_resources.h>
 
 struct miral::ApplicationInfo::Self
 {
@@ -69,6 +70,16 @@ auto miral::ApplicationInfo::windows() const -> std::vector <Window>&
     return self->windows;
 }
 
+auto miral::ApplicationInfo::resource_usage() const -> ApplicationResourceUsage
+{
+    if (!self->app)
+        return {};
+
+    auto const usage = self->app->resources()->usage();
+    return {
+        usage.surfaces, usage.buffer_streams, usage.buffers, usage.buffer_bytes, usage.commits, usage.throttled_frames};
+}
+
 auto miral::ApplicationInfo::userdata() const -> std::shared_ptr<void>
 {
     return self->userdata;
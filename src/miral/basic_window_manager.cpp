@@ -43,14 +43,17 @@ struct miral::BasicWindowManager::Locker
     ~Locker()
     {
         policy->advise_end();
+        self->snapshot_stale = true;
     }
 
     std::lock_guard<std::mutex> const lock;
+    BasicWindowManager* const self;
     WindowManagementPolicy* const policy;
 };
 
 miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self) :
     lock{self->mutex},
+    self{self},
     policy{self->policy.get()}
 {
     policy->advise_begin();
@@ -107,6 +110,7 @@ void miral::BasicWindowManager::remove_session(std::shared_ptr<scene::Session> c
     }
     policy->advise_delete_app(info->second);
     app_info.erase(session);
+    forget_published_snapshot();
 }
 
 auto miral::BasicWindowManager::add_surface(
@@ -251,6 +255,7 @@ void miral::BasicWindowManager::remove_window(Application const& application, mi
     // NB erase() invalidates info, but we want to keep access to "parent".
     auto const parent = info.parent();
     erase(info);
+    forget_published_snapshot();
 
     if (is_active_window)
     {
@@ -278,16 +283,8 @@ void miral::BasicWindowManager::refocus(
                 // select_active_window() calls set_focus_to() which updates mru_active_windows and changes window
                 auto const w = window;
 
-                for (auto const& workspace : workspaces_containing(w))
-                {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            return !(new_focus = select_active_window(w));
-                        }
-                    }
-                }
+                if (in_any_of(w, workspaces_containing_window))
+                    return !(new_focus = select_active_window(w));
 
                 return true;
             });
@@ -407,6 +404,7 @@ void miral::BasicWindowManager::handle_request_move(
     if (timestamp >= last_input_event_timestamp && last_input_event)
     {
         policy->handle_request_move(info_for(surface), mir_event_get_input_event(last_input_event));
+        snapshot_stale = true;
     }
 }
 
@@ -424,6 +422,7 @@ void miral::BasicWindowManager::handle_request_resize(
     if (timestamp >= last_input_event_timestamp && last_input_event)
     {
         policy->handle_request_resize(info_for(surface), mir_event_get_input_event(last_input_event), edge);
+        snapshot_stale = true;
     }
 }
 
@@ -665,6 +664,26 @@ auto miral::BasicWindowManager::workspaces_containing(Window const& window) cons
     return workspaces_containing_window;
 }
 
+auto miral::BasicWindowManager::in_any_of(
+    Window const& window,
+    std::vector<std::shared_ptr<Workspace>> const& workspaces) const -> bool
+{
+    // Compare ownership rather than lock()ing each weak_ptr: this is called for each candidate window
+    // when focus moves, and is worth keeping cheap when there are lots of windows.
+    auto const iter_pair = workspaces_to_windows.right.equal_range(window);
+
+    for (auto kv = iter_pair.first; kv != iter_pair.second; ++kv)
+    {
+        for (auto const& workspace : workspaces)
+        {
+            if (!kv->second.owner_before(workspace) && !workspace.owner_before(kv->second))
+                return true;
+        }
+    }
+
+    return false;
+}
+
 auto miral::BasicWindowManager::active_display_area() const -> std::shared_ptr<DisplayArea>
 {
     // If a window has input focus, return its display area
@@ -766,33 +785,15 @@ void miral::BasicWindowManager::focus_next_within_application()
         {
             while (++current != end(siblings))
             {
-                for (auto const& workspace : workspaces_containing(*current))
-                {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            if (prev != select_active_window(*current))
-                                return;
-                        }
-                    }
-                }
+                if (in_any_of(*current, workspaces_containing_window) && prev != select_active_window(*current))
+                    return;
             }
         }
 
         for (current = begin(siblings); *current != prev; ++current)
         {
-            for (auto const& workspace : workspaces_containing(*current))
-            {
-                for (auto const& ww : workspaces_containing_window)
-                {
-                    if (ww == workspace)
-                    {
-                        if (prev != select_active_window(*current))
-                            return;
-                    }
-                }
-            }
+            if (in_any_of(*current, workspaces_containing_window) && prev != select_active_window(*current))
+                return;
         }
 
         current = find(begin(siblings), end(siblings), prev);
@@ -823,33 +824,15 @@ void miral::BasicWindowManager::focus_prev_within_application()
         {
             while (++current != rend(siblings))
             {
-                for (auto const& workspace : workspaces_containing(*current))
-                {
-                    for (auto const& ww : workspaces_containing_window)
-                    {
-                        if (ww == workspace)
-                        {
-                            if (prev != select_active_window(*current))
-                                return;
-                        }
-                    }
-                }
+                if (in_any_of(*current, workspaces_containing_window) && prev != select_active_window(*current))
+                    return;
             }
         }
 
         for (current = rbegin(siblings); *current != prev; ++current)
         {
-            for (auto const& workspace : workspaces_containing(*current))
-            {
-                for (auto const& ww : workspaces_containing_window)
-                {
-                    if (ww == workspace)
-                    {
-                        if (prev != select_active_window(*current))
-                            return;
-                    }
-                }
-            }
+            if (in_any_of(*current, workspaces_containing_window) && prev != select_active_window(*current))
+                return;
         }
 
         current = find(rbegin(siblings), rend(siblings), prev);
@@ -1434,16 +1417,8 @@ void miral::BasicWindowManager::set_state(miral::WindowInfo& window_info, MirWin
                         if (candidate == window)
                             return true;
                         auto const w = candidate;
-                        for (auto const& workspace : workspaces_containing(w))
-                        {
-                            for (auto const& ww : workspaces_containing_window)
-                            {
-                                if (ww == workspace)
-                                {
-                                    return !(select_active_window(w));
-                                }
-                            }
-                        }
+                        if (in_any_of(w, workspaces_containing_window))
+                            return !(select_active_window(w));
 
                         return true;
                     });
@@ -1527,6 +1502,75 @@ void miral::BasicWindowManager::invoke_under_lock(std::function<void()> const& c
     callback();
 }
 
+auto miral::BasicWindowManager::snapshot() -> std::shared_ptr<WindowManagerSnapshot const>
+{
+    auto published = std::atomic_load(&published_snapshot);
+
+    if (published && !snapshot_stale)
+        return published;
+
+    // Readers shouldn't hold up the window manager: while the model is locked the last published
+    // snapshot is still a consistent view, so only block if there isn't one yet.
+    std::unique_lock<decltype(mutex)> lock{mutex, std::try_to_lock};
+
+    if (!lock.owns_lock())
+    {
+        if (published)
+            return published;
+
+        lock.lock();
+    }
+
+    if (snapshot_stale.exchange(false) || !published)
+    {
+        published = take_snapshot();
+        std::atomic_store(&published_snapshot, published);
+    }
+    else
+    {
+        // Another reader has taken a snapshot since we looked
+        published = std::atomic_load(&published_snapshot);
+    }
+
+    return published;
+}
+
+void miral::BasicWindowManager::forget_published_snapshot()
+{
+    // The snapshot holds Application and Window handles, which would keep what was removed alive
+    std::atomic_store(&published_snapshot, std::shared_ptr<WindowManagerSnapshot const>{});
+}
+
+auto miral::BasicWindowManager::take_snapshot() const -> std::shared_ptr<WindowManagerSnapshot const>
+{
+    auto const result = std::make_shared<WindowManagerSnapshot>();
+
+    result->active_window = allow_active_window ? mru_active_windows.top() : Window{};
+
+    result->applications.reserve(app_info.size());
+    for (auto const& app : app_info)
+        result->applications.push_back(app.second.application());
+
+    result->windows.reserve(window_info.size());
+    for (auto const& window : window_info)
+    {
+        auto const& info = window.second;
+        result->windows.push_back(WindowSnapshot{
+            info.window(),
+            info.window().application(),
+            info.name(),
+            info.type(),
+            info.state(),
+            info.depth_layer(),
+            info.window().top_left(),
+            info.window().size(),
+            info.parent(),
+            info.is_visible()});
+    }
+
+    return result;
+}
+
 auto miral::BasicWindowManager::select_active_window(Window const& hint) -> miral::Window
 {
     auto const prev_window = active_window();
@@ -1706,14 +1750,8 @@ auto miral::BasicWindowManager::can_activate_window_for_session_in_workspace(
             if (w.application() != session)
                 return true;
 
-            for (auto const& workspace : workspaces_containing(w))
-            {
-                for (auto const& ww : workspaces)
-                {
-                    if (ww == workspace)
-                        return !(new_focus = select_active_window(w));
-                }
-            }
+            if (in_any_of(w, workspaces))
+                return !(new_focus = select_active_window(w));
 
             return true;
         });
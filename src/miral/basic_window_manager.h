@@ -23,6 +23,7 @@
 
 #include "miral/window_management_policy.h"
 #include "miral/window_info.h"
+#include "miral/window_manager_snapshot.h"
 #include "active_outputs.h"
 #include "miral/application.h"
 #include "miral/application_info.h"
@@ -39,6 +40,7 @@
 #include <boost/bimap/multiset_of.hpp>
 #include <experimental/optional>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -193,6 +195,8 @@ public:
 
     void invoke_under_lock(std::function<void()> const& callback) override;
 
+    auto snapshot() -> std::shared_ptr<WindowManagerSnapshot const> override;
+
 private:
     /// An area for windows to be placed in
     struct DisplayArea
@@ -255,6 +259,12 @@ private:
 
     std::shared_ptr<DisplayConfigurationListeners> const display_config_monitor;
 
+    /// The last snapshot(), only accessed with std::atomic_load()/std::atomic_store().
+    /// Reset when an application or window is removed.
+    std::shared_ptr<WindowManagerSnapshot const> published_snapshot;
+    /// Set whenever the lock is released, as the model may have changed
+    std::atomic<bool> snapshot_stale{true};
+
     struct Locker;
 
     void update_event_timestamp(MirKeyboardEvent const* kev);
@@ -288,6 +298,8 @@ private:
     void refocus(Application const& application, Window const& parent,
                  std::vector<std::shared_ptr<Workspace>> const& workspaces_containing_window);
     auto workspaces_containing(Window const& window) const -> std::vector<std::shared_ptr<Workspace>>;
+    /// Whether window is in any of workspaces (without building the list of workspaces containing it)
+    auto in_any_of(Window const& window, std::vector<std::shared_ptr<Workspace>> const& workspaces) const -> bool;
     auto active_display_area() const -> std::shared_ptr<DisplayArea>;
     auto display_area_for(WindowInfo const& info) const -> std::shared_ptr<DisplayArea>;
     /// Returns the application zone area after shrinking it for the exclusive zone if needed
@@ -300,6 +312,9 @@ private:
     void advise_output_update(Output const& updated, Output const& original) override;
     void advise_output_delete(Output const& output) override;
     void update_windows_for_outputs();
+    auto take_snapshot() const -> std::shared_ptr<WindowManagerSnapshot const>;
+    /// Called when an application or window is removed, so the published snapshot doesn't keep it alive
+    void forget_published_snapshot();
 };
 }
 
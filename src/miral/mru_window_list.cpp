@@ -33,13 +33,28 @@ bool visible(miral::Window const& window)
 
 void miral::MRUWindowList::push(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
-    windows.push_back(window);
+    auto const position = positions.find(window);
+
+    if (position != end(positions))
+    {
+        // Moving the node keeps any iterator held by enumerate() valid
+        windows.splice(end(windows), windows, position->second);
+    }
+    else
+    {
+        positions.emplace(window, windows.insert(end(windows), window));
+    }
 }
 
 void miral::MRUWindowList::erase(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
+    auto const position = positions.find(window);
+
+    if (position != end(positions))
+    {
+        windows.erase(position->second);
+        positions.erase(position);
+    }
 }
 
 auto miral::MRUWindowList::top() const -> Window
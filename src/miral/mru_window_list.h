@@ -22,13 +22,18 @@
 #include <miral/window.h>
 
 #include <functional>
-#include <vector>
+#include <list>
+#include <map>
 
 namespace miral
 {
+/// The windows in most recently used order. push() and erase() are O(log n) in the number of windows.
 class MRUWindowList
 {
 public:
+    MRUWindowList() = default;
+    MRUWindowList(MRUWindowList const&) = delete;
+    MRUWindowList& operator=(MRUWindowList const&) = delete;
 
     void push(Window const& window);
     void erase(Window const& window);
@@ -39,7 +44,9 @@ public:
     void enumerate(Enumerator const& enumerator) const;
 
 private:
-    std::vector<Window> windows;
+    /// Least recently used first
+    std::list<Window> windows;
+    std::map<Window, std::list<Window>::iterator> positions;
 };
 }
 
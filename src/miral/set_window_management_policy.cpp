@@ -25,11 +25,6 @@
 
 namespace msh = mir::shell;
 
-namespace
-{
-char const* const trace_option = "window-management-trace";
-}
-
 miral::SetWindowManagementPolicy::SetWindowManagementPolicy(WindowManagementPolicyBuilder const& builder) :
     builder{builder}
 {
@@ -39,7 +34,7 @@ miral::SetWindowManagementPolicy::~SetWindowManagementPolicy() = default;
 
 void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
 {
-    server.add_configuration_option(trace_option, "log trace message", mir::OptionType::null);
+    add_window_management_trace_options(server);
 
     server.override_the_window_manager_builder([this, &server](msh::FocusController* focus_controller)
         -> std::shared_ptr<msh::WindowManager>
@@ -48,26 +43,11 @@ void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
 
             auto const persistent_surface_store = server.the_persistent_surface_store();
 
-            if (server.get_options()->is_set(trace_option))
-            {
-                auto trace_builder = [this](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
-                    {
-                        return std::make_unique<WindowManagementTrace>(tools, builder);
-                    };
-
-                return std::make_shared<BasicWindowManager>(
-                    focus_controller,
-                    display_layout,
-                    persistent_surface_store,
-                    *server.the_display_configuration_observer_registrar(),
-                    trace_builder);
-            }
-
             return std::make_shared<BasicWindowManager>(
                 focus_controller,
                 display_layout,
                 persistent_surface_store,
                 *server.the_display_configuration_observer_registrar(),
-                builder);
+                window_management_trace_builder(server, builder));
         });
 }
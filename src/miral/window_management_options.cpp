@@ -32,7 +32,6 @@ namespace msh = mir::shell;
 namespace
 {
 char const* const wm_option = "window-manager";
-char const* const trace_option = "window-management-trace";
 }
 
 void miral::WindowManagerOptions::operator()(mir::Server& server) const
@@ -51,7 +50,7 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
     description += "}]";
 
     server.add_configuration_option(wm_option, description, policies.begin()->name);
-    server.add_configuration_option(trace_option, "log trace message", mir::OptionType::null);
+    add_window_management_trace_options(server);
 
     server.override_the_window_manager_builder([this, &server](msh::FocusController* focus_controller)
         -> std::shared_ptr<msh::WindowManager>
@@ -66,27 +65,12 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
             {
                 if (selection == option.name)
                 {
-                    if (server.get_options()->is_set(trace_option))
-                    {
-                        auto trace_builder = [&option](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
-                            {
-                                return std::make_unique<WindowManagementTrace>(tools, option.build);
-                            };
-
-                        return std::make_shared<BasicWindowManager>(
-                            focus_controller,
-                            display_layout,
-                            persistent_surface_store,
-                            *server.the_display_configuration_observer_registrar(),
-                            trace_builder);
-                    }
-
                     return std::make_shared<BasicWindowManager>
                         (focus_controller,
                          display_layout,
                          persistent_surface_store,
                          *server.the_display_configuration_observer_registrar(),
-                         option.build);
+                         window_management_trace_builder(server, option.build));
                 }
             }
 
@@ -27,7 +27,11 @@
 #include <mir/scene/session.h>
 #include <mir/scene/surface.h>
 #include <mir/event_printer.h>
+#include <mir/main_loop.h>
+#include <mir/options/option.h>
+#include <mir/server.h>
 
+#include <csignal>
 #include <iomanip>
 #include <sstream>
 
@@ -43,12 +47,16 @@ catch (std::exception const& x)\
     std::stringstream out;\
     mir::report_exception(out);\
     mir::log_warning("%s throws %s", __func__, out.str().c_str());\
+    if (ring) dump(*ring, "exception");\
     throw;\
 }
 
 
 namespace
 {
+char const* const trace_option = "window-management-trace";
+char const* const trace_ring_option = "window-management-trace-ring";
+
 std::string const null_ptr{"(null)"};
 
 auto operator<< (std::ostream& out, miral::WindowSpecification::AspectRatio const& ratio) -> std::ostream&;
@@ -360,17 +368,65 @@ auto dump_of(miral::Zone const& zone) -> std::string
 
 miral::WindowManagementTrace::WindowManagementTrace(
     WindowManagerTools const& wrapped,
-    WindowManagementPolicyBuilder const& builder) :
+    WindowManagementPolicyBuilder const& builder,
+    bool log_calls,
+    std::shared_ptr<WindowManagementTraceRing> ring) :
     wrapped{wrapped},
+    log_calls{log_calls},
+    ring{std::move(ring)},
     policy(builder(WindowManagerTools{this}))
 {
 }
 
+void miral::add_window_management_trace_options(mir::Server& server)
+{
+    server.add_configuration_option(trace_option, "log trace message", mir::OptionType::null);
+    server.add_configuration_option(
+        trace_ring_option,
+        "Number of window management calls to keep in memory. They are logged on SIGUSR2,"
+        " or when a call throws. 0 disables this", 0);
+}
+
+auto miral::window_management_trace_builder(mir::Server& server, WindowManagementPolicyBuilder const& builder)
+-> WindowManagementPolicyBuilder
+{
+    auto const options = server.get_options();
+    auto const log_calls = options->is_set(trace_option);
+    auto const ring_size = options->get<int>(trace_ring_option);
+
+    std::shared_ptr<WindowManagementTraceRing> ring;
+
+    if (ring_size > 0)
+    {
+        ring = std::make_shared<WindowManagementTraceRing>(ring_size);
+        server.the_main_loop()->register_signal_handler({SIGUSR2}, [ring](int)
+            {
+                WindowManagementTrace::dump(*ring, "SIGUSR2");
+            });
+    }
+
+    if (!log_calls && !ring)
+        return builder;
+
+    return [builder, log_calls, ring](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
+        {
+            return std::make_unique<WindowManagementTrace>(tools, builder, log_calls, ring);
+        };
+}
+
+void miral::WindowManagementTrace::dump(WindowManagementTraceRing& ring, char const* reason)
+{
+    std::stringstream out;
+    ring.dump(out);
+    mir::log_info("Window management trace (%s):\n%s", reason, out.str().c_str());
+}
+
 auto miral::WindowManagementTrace::count_applications() const -> unsigned int
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto const result = wrapped.count_applications();
-    mir::log_info("%s -> %d", __func__, result);
+    if (log_calls) mir::log_info("%s -> %d", __func__, result);
     trace_count++;
     return result;
 }
@@ -378,8 +434,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::for_each_application(std::function<void(miral::ApplicationInfo&)> const& functor)
 try {
-    log_input();
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s", __func__);
     trace_count++;
     wrapped.for_each_application(functor);
 }
@@ -388,9 +445,10 @@ MIRAL_TRACE_EXCEPTION
 auto miral::WindowManagementTrace::find_application(std::function<bool(ApplicationInfo const& info)> const& predicate)
 -> Application
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto result = wrapped.find_application(predicate);
-    mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
+    if (log_calls) mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -398,9 +456,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::info_for(std::weak_ptr<mir::scene::Session> const& session) const -> ApplicationInfo&
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto& result = wrapped.info_for(session);
-    mir::log_info("%s -> %s", __func__, result.application()->name().c_str());
+    if (log_calls) mir::log_info("%s -> %s", __func__, result.application()->name().c_str());
     trace_count++;
     return result;
 }
@@ -408,9 +467,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::info_for(std::weak_ptr<mir::scene::Surface> const& surface) const -> WindowInfo&
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto& result = wrapped.info_for(surface);
-    mir::log_info("%s -> %s", __func__, result.name().c_str());
+    if (log_calls) mir::log_info("%s -> %s", __func__, result.name().c_str());
     trace_count++;
     return result;
 }
@@ -418,9 +478,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::info_for(Window const& window) const -> WindowInfo&
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) log_input();
     auto& result = wrapped.info_for(window);
-    mir::log_info("%s -> %s", __func__, result.name().c_str());
+    if (log_calls) mir::log_info("%s -> %s", __func__, result.name().c_str());
     trace_count++;
     return result;
 }
@@ -428,8 +489,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::ask_client_to_close(miral::Window const& window)
 try {
-    log_input();
-    mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
     trace_count++;
     wrapped.ask_client_to_close(window);
 }
@@ -437,9 +499,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::active_window() const -> Window
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto result = wrapped.active_window();
-    mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
+    if (log_calls) mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -447,9 +510,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::select_active_window(Window const& hint) -> Window
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, hint};
+    if (log_calls) log_input();
     auto result = wrapped.select_active_window(hint);
-    mir::log_info("%s hint=%s -> %s", __func__, dump_of(hint).c_str(), dump_of(result).c_str());
+    if (log_calls) mir::log_info("%s hint=%s -> %s", __func__, dump_of(hint).c_str(), dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -457,11 +521,15 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::window_at(mir::geometry::Point cursor) const -> Window
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto result = wrapped.window_at(cursor);
-    std::stringstream out;
-    out << cursor << " -> " << dump_of(result);
-    mir::log_info("%s cursor=%s", __func__, out.str().c_str());
+    if (log_calls)
+    {
+        std::stringstream out;
+        out << cursor << " -> " << dump_of(result);
+        mir::log_info("%s cursor=%s", __func__, out.str().c_str());
+    }
     trace_count++;
     return result;
 }
@@ -469,11 +537,15 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::active_output() -> mir::geometry::Rectangle const
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto result = wrapped.active_output();
-    std::stringstream out;
-    out << result;
-    mir::log_info("%s -> ", __func__, out.str().c_str());
+    if (log_calls)
+    {
+        std::stringstream out;
+        out << result;
+        mir::log_info("%s -> ", __func__, out.str().c_str());
+    }
     trace_count++;
     return result;
 }
@@ -481,9 +553,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::info_for_window_id(std::string const& id) const -> WindowInfo&
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
     auto& result = wrapped.info_for_window_id(id);
-    mir::log_info("%s id=%s -> %s", __func__, id.c_str(), dump_of(result).c_str());
+    if (log_calls) mir::log_info("%s id=%s -> %s", __func__, id.c_str(), dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -491,9 +564,10 @@ MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::id_for_window(Window const& window) const -> std::string
 try {
-    log_input();
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) log_input();
     auto result = wrapped.id_for_window(window);
-    mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), result.c_str());
+    if (log_calls) mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), result.c_str());
     trace_count++;
     return result;
 }
@@ -502,18 +576,23 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::place_and_size_for_state(
     WindowSpecification& modifications, WindowInfo const& window_info) const
 try {
-    log_input();
-    mir::log_info("%s modifications=%s window_info=%s", __func__, dump_of(modifications).c_str(), dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s modifications=%s window_info=%s", __func__, dump_of(modifications).c_str(), dump_of(window_info).c_str());
     wrapped.place_and_size_for_state(modifications, window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::drag_active_window(mir::geometry::Displacement movement)
 try {
-    log_input();
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s movement=%s", __func__, out.str().c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls)
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s movement=%s", __func__, out.str().c_str());
+    }
     trace_count++;
     wrapped.drag_active_window(movement);
 }
@@ -521,10 +600,14 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::drag_window(Window const& window, mir::geometry::Displacement& movement)
 try {
-    log_input();
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), out.str().c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) log_input();
+    if (log_calls)
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), out.str().c_str());
+    }
     trace_count++;
     wrapped.drag_window(window, movement);
 }
@@ -532,8 +615,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::focus_next_application()
 try {
-    log_input();
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_next_application();
 }
@@ -541,8 +625,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::focus_prev_application()
 try {
-    log_input();
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_next_application();
 }
@@ -550,8 +635,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::focus_next_within_application()
 try {
-    log_input();
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_next_within_application();
 }
@@ -559,8 +645,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::focus_prev_within_application()
 try {
-    log_input();
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_prev_within_application();
 }
@@ -568,8 +655,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::raise_tree(miral::Window const& root)
 try {
-    log_input();
-    mir::log_info("%s root=%s", __func__, dump_of(root).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, root};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s root=%s", __func__, dump_of(root).c_str());
     trace_count++;
     wrapped.raise_tree(root);
 }
@@ -577,8 +665,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::start_drag_and_drop(miral::WindowInfo& window_info, std::vector<uint8_t> const& handle)
 try {
-    log_input();
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     trace_count++;
     wrapped.start_drag_and_drop(window_info, handle);
 }
@@ -586,8 +675,9 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::end_drag_and_drop()
 try {
-    log_input();
-    mir::log_info("%s window_info=%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) log_input();
+    if (log_calls) mir::log_info("%s window_info=%s", __func__);
     trace_count++;
     wrapped.end_drag_and_drop();
 }
@@ -596,9 +686,11 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::modify_window(
     miral::WindowInfo& window_info, miral::WindowSpecification const& modifications)
 try {
-    log_input();
-    mir::log_info("%s window_info=%s, modifications=%s",
-                  __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) log_input();
+    if (log_calls)
+        mir::log_info("%s window_info=%s, modifications=%s",
+                      __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
     trace_count++;
     wrapped.modify_window(window_info, modifications);
 }
@@ -606,14 +698,24 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::invoke_under_lock(std::function<void()> const& callback)
 try {
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s", __func__);
     wrapped.invoke_under_lock(callback);
 }
 MIRAL_TRACE_EXCEPTION
 
+auto miral::WindowManagementTrace::snapshot() -> std::shared_ptr<WindowManagerSnapshot const>
+try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s", __func__);
+    return wrapped.snapshot();
+}
+MIRAL_TRACE_EXCEPTION
+
 auto miral::WindowManagementTrace::create_workspace() -> std::shared_ptr<Workspace>
 try {
-    mir::log_info("%s", __func__);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s", __func__);
     return wrapped.create_workspace();
 }
 MIRAL_TRACE_EXCEPTION
@@ -621,7 +723,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::add_tree_to_workspace(
     miral::Window const& window, std::shared_ptr<miral::Workspace> const& workspace)
 try {
-    mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
     wrapped.add_tree_to_workspace(window, workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -629,7 +732,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::remove_tree_from_workspace(
     miral::Window const& window, std::shared_ptr<miral::Workspace> const& workspace)
 try {
-    mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
     wrapped.remove_tree_from_workspace(window, workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -637,7 +741,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::move_workspace_content_to_workspace(
     std::shared_ptr<Workspace> const& to_workspace, std::shared_ptr<Workspace> const& from_workspace)
 try {
-    mir::log_info("%s to_workspace=%p, from_workspace=%p", __func__, to_workspace.get(), from_workspace.get());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s to_workspace=%p, from_workspace=%p", __func__, to_workspace.get(), from_workspace.get());
     wrapped.move_workspace_content_to_workspace(to_workspace, from_workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -645,7 +750,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::for_each_workspace_containing(
     miral::Window const& window, std::function<void(std::shared_ptr<miral::Workspace> const&)> const& callback)
 try {
-    mir::log_info("%s window=%s", __func__, dump_of(window).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window};
+    if (log_calls) mir::log_info("%s window=%s", __func__, dump_of(window).c_str());
     wrapped.for_each_workspace_containing(window, callback);
 }
 MIRAL_TRACE_EXCEPTION
@@ -653,7 +759,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::for_each_window_in_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::function<void(miral::Window const&)> const& callback)
 try {
-    mir::log_info("%s workspace =%p", __func__, workspace.get());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s workspace =%p", __func__, workspace.get());
     wrapped.for_each_window_in_workspace(workspace, callback);
 }
 MIRAL_TRACE_EXCEPTION
@@ -662,16 +769,19 @@ auto miral::WindowManagementTrace::place_new_window(
     ApplicationInfo const& app_info,
     WindowSpecification const& requested_specification) -> WindowSpecification
 try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
     auto const result = policy->place_new_window(app_info, requested_specification);
-    mir::log_info("%s app_info=%s, requested_specification=%s -> %s",
-              __func__, dump_of(app_info).c_str(), dump_of(requested_specification).c_str(), dump_of(result).c_str());
+    if (log_calls)
+        mir::log_info("%s app_info=%s, requested_specification=%s -> %s",
+                  __func__, dump_of(app_info).c_str(), dump_of(requested_specification).c_str(), dump_of(result).c_str());
     return result;
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_window_ready(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_window_ready(window_info);
 }
 MIRAL_TRACE_EXCEPTION
@@ -679,21 +789,25 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::handle_modify_window(
     miral::WindowInfo& window_info, miral::WindowSpecification const& modifications)
 try {
-    mir::log_info("%s window_info=%s, modifications=%s",
-                  __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls)
+        mir::log_info("%s window_info=%s, modifications=%s",
+                      __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
     policy->handle_modify_window(window_info, modifications);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_raise_window(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_raise_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_keyboard_event(MirKeyboardEvent const* event)
 try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
     log_input = [event, this]
         {
             mir::log_info("handle_keyboard_event event=%s", dump_of(event).c_str());
@@ -706,6 +820,7 @@ MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_touch_event(MirTouchEvent const* event)
 try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
     log_input = [event, this]
         {
             mir::log_info("handle_touch_event event=%s", dump_of(event).c_str());
@@ -718,6 +833,7 @@ MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_pointer_event(MirPointerEvent const* event)
 try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
     log_input = [event, this]
         {
             mir::log_info("handle_pointer_event event=%s", dump_of(event).c_str());
@@ -731,9 +847,13 @@ MIRAL_TRACE_EXCEPTION
 auto miral::WindowManagementTrace::confirm_inherited_move(WindowInfo const& window_info, Displacement movement)
 -> Rectangle
 try {
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s window_info=%s, movement=%s", __func__, dump_of(window_info).c_str(), out.str().c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls)
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s window_info=%s, movement=%s", __func__, dump_of(window_info).c_str(), out.str().c_str());
+    }
 
     return policy->confirm_inherited_move(window_info, movement);
 }
@@ -749,7 +869,7 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_end()
 try {
-    if (trace_count.load() > 0)
+    if (log_calls && trace_count.load() > 0)
         mir::log_info("====");
     policy->advise_end();
 }
@@ -757,84 +877,96 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_new_app(miral::ApplicationInfo& application)
 try {
-    mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
     policy->advise_new_app(application);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_delete_app(miral::ApplicationInfo const& application)
 try {
-    mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
     policy->advise_delete_app(application);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_new_window(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_new_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_focus_lost(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_focus_lost(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_focus_gained(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_focus_gained(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_state_change(miral::WindowInfo const& window_info, MirWindowState state)
 try {
-    mir::log_info("%s window_info=%s, state=%s", __func__, dump_of(window_info).c_str(), dump_of(state).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s, state=%s", __func__, dump_of(window_info).c_str(), dump_of(state).c_str());
     policy->advise_state_change(window_info, state);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_move_to(miral::WindowInfo const& window_info, mir::geometry::Point top_left)
 try {
-    mir::log_info("%s window_info=%s, top_left=%s", __func__, dump_of(window_info).c_str(), dump_of(top_left).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s, top_left=%s", __func__, dump_of(window_info).c_str(), dump_of(top_left).c_str());
     policy->advise_move_to(window_info, top_left);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_resize(miral::WindowInfo const& window_info, mir::geometry::Size const& new_size)
 try {
-    mir::log_info("%s window_info=%s, new_size=%s", __func__, dump_of(window_info).c_str(), dump_of(new_size).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s, new_size=%s", __func__, dump_of(window_info).c_str(), dump_of(new_size).c_str());
     policy->advise_resize(window_info, new_size);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_delete_window(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_delete_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_raise(std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(windows).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(windows).c_str());
     policy->advise_raise(windows);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_request_drag_and_drop(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_request_drag_and_drop(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_request_move(miral::WindowInfo& window_info, MirInputEvent const* input_event)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_request_move(window_info, input_event);
 }
 MIRAL_TRACE_EXCEPTION
@@ -842,7 +974,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::handle_request_resize(
     miral::WindowInfo& window_info, MirInputEvent const* input_event, MirResizeEdge edge)
 try {
-    mir::log_info("%s window_info=%s, edge=0x%1x", __func__, dump_of(window_info).c_str(), edge);
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
+    if (log_calls) mir::log_info("%s window_info=%s, edge=0x%1x", __func__, dump_of(window_info).c_str(), edge);
     policy->handle_request_resize(window_info, input_event, edge);
 }
 MIRAL_TRACE_EXCEPTION
@@ -850,7 +983,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::advise_adding_to_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
     policy->advise_adding_to_workspace(workspace, windows);
 }
 MIRAL_TRACE_EXCEPTION
@@ -858,7 +992,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::advise_removing_from_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
     policy->advise_removing_from_workspace(workspace, windows);
 }
 MIRAL_TRACE_EXCEPTION
@@ -869,51 +1004,59 @@ auto miral::WindowManagementTrace::confirm_placement_on_display(
     MirWindowState new_state,
     Rectangle const& new_placement) -> Rectangle
 try {
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__, window_info.window()};
     auto const& result = policy->confirm_placement_on_display(window_info, new_state, new_placement);
-    mir::log_info("%s window_info=%s, new_state= %s, new_placement= %s -> %s", __func__,
-        dump_of(window_info).c_str(), dump_of(new_state).c_str(), dump_of(new_placement).c_str(), dump_of(result).c_str());
+    if (log_calls)
+        mir::log_info("%s window_info=%s, new_state= %s, new_placement= %s -> %s", __func__,
+            dump_of(window_info).c_str(), dump_of(new_state).c_str(), dump_of(new_placement).c_str(), dump_of(result).c_str());
     return result;
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_output_create(Output const& output)
 try {
-    mir::log_info("%s output=%s", __func__, dump_of(output).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s output=%s", __func__, dump_of(output).c_str());
     return policy->advise_output_create(output);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_output_update(Output const& updated, Output const& original)
 try {
-    mir::log_info("%s updated=%s, original=%s", __func__, dump_of(updated).c_str(), dump_of(original).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s updated=%s, original=%s", __func__, dump_of(updated).c_str(), dump_of(original).c_str());
     return policy->advise_output_update(updated, original);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_output_delete(Output const& output)
 try {
-    mir::log_info("%s output=%s", __func__, dump_of(output).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s output=%s", __func__, dump_of(output).c_str());
     return policy->advise_output_delete(output);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_application_zone_create(Zone const& application_zone)
 try {
-    mir::log_info("%s application_zone=%s", __func__, dump_of(application_zone).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s application_zone=%s", __func__, dump_of(application_zone).c_str());
     return policy->advise_application_zone_create(application_zone);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_application_zone_update(Zone const& updated, Zone const& original)
 try {
-    mir::log_info("%s updated=%s, original=%s", __func__, dump_of(updated).c_str(), dump_of(original).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s updated=%s, original=%s", __func__, dump_of(updated).c_str(), dump_of(original).c_str());
     return policy->advise_application_zone_update(updated, original);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_application_zone_delete(Zone const& application_zone)
 try {
-    mir::log_info("%s application_zone=%s", __func__, dump_of(application_zone).c_str());
+    WindowManagementTraceRing::Recorder const recorder{ring.get(), __func__};
+    if (log_calls) mir::log_info("%s application_zone=%s", __func__, dump_of(application_zone).c_str());
     return policy->advise_application_zone_delete(application_zone);
 }
 MIRAL_TRACE_EXCEPTION
@@ -20,6 +20,7 @@
 #define MIRAL_WINDOW_MANAGEMENT_TRACE_H
 
 #include "window_manager_tools_implementation.h"
+#include "window_management_trace_ring.h"
 
 #include "miral/window_manager_tools.h"
 #include "miral/window_management_options.h"
@@ -27,14 +28,33 @@
 
 #include <atomic>
 
+namespace mir { class Server; }
+
 namespace miral
 {
+/// Adds the options that control tracing of window management calls
+void add_window_management_trace_options(mir::Server& server);
+
+/// Wraps builder in a WindowManagementTrace if the options ask for one.
+/// Must be called from the window manager builder (it registers a signal handler with the main loop).
+auto window_management_trace_builder(mir::Server& server, WindowManagementPolicyBuilder const& builder)
+-> WindowManagementPolicyBuilder;
+
 class WindowManagementTrace
     : public WindowManagementPolicy,
       WindowManagerToolsImplementation
 {
 public:
-    WindowManagementTrace(WindowManagerTools const& wrapped, WindowManagementPolicyBuilder const& builder);
+    /// \param log_calls   log every call as it happens (expensive, but complete)
+    /// \param ring        if not null, record every call here (cheap enough to leave on)
+    WindowManagementTrace(
+        WindowManagerTools const& wrapped,
+        WindowManagementPolicyBuilder const& builder,
+        bool log_calls,
+        std::shared_ptr<WindowManagementTraceRing> ring);
+
+    /// Logs the calls recorded in ring since it was last dumped
+    static void dump(WindowManagementTraceRing& ring, char const* reason);
 
 private:
     virtual auto count_applications() const -> unsigned int override;
@@ -77,6 +97,7 @@ private:
     virtual void modify_window(WindowInfo& window_info, WindowSpecification const& modifications) override;
 
     virtual void invoke_under_lock(std::function<void()> const& callback) override;
+    virtual auto snapshot() -> std::shared_ptr<WindowManagerSnapshot const> override;
 
     virtual auto place_new_window(
         ApplicationInfo const& app_info,
@@ -168,6 +189,8 @@ public:
 
 private:
     WindowManagerTools wrapped;
+    bool const log_calls;
+    std::shared_ptr<WindowManagementTraceRing> const ring;
     std::unique_ptr<miral::WindowManagementPolicy> const policy;
     std::atomic<unsigned> mutable trace_count;
     std::function<void()> log_input;
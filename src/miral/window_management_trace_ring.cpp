@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window_management_trace_ring.h"
+
+#include <miral/window.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace
+{
+thread_local unsigned call_depth{0};
+
+auto as_ns(miral::WindowManagementTraceRing::Clock::duration duration) -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+}
+
+/// Every field is atomic (and relaxed) so that dump() can read an entry while it is being
+/// rewritten: sequence is used as a seqlock to detect that and skip the entry.
+struct miral::WindowManagementTraceRing::Entry
+{
+    std::atomic<uint64_t> sequence{0};  ///< 0 while being written, otherwise the record's sequence + 1
+    std::atomic<char const*> call{nullptr};
+    std::atomic<uintptr_t> window{0};
+    std::atomic<unsigned> depth{0};
+    std::atomic<uint64_t> order{0};
+    std::atomic<int64_t> start_ns{0};
+    std::atomic<int64_t> duration_ns{0};
+};
+
+miral::WindowManagementTraceRing::WindowManagementTraceRing(size_t capacity) :
+    capacity{std::max<size_t>(capacity, 1)},
+    entries{new Entry[this->capacity]}
+{
+}
+
+miral::WindowManagementTraceRing::~WindowManagementTraceRing() = default;
+
+auto miral::WindowManagementTraceRing::start_call() -> uint64_t
+{
+    return next_call.fetch_add(1, std::memory_order_relaxed);
+}
+
+void miral::WindowManagementTraceRing::record(
+    char const* call,
+    uintptr_t window,
+    unsigned depth,
+    uint64_t order,
+    Clock::time_point start,
+    Clock::duration duration)
+{
+    auto const sequence = next_sequence.fetch_add(1, std::memory_order_relaxed);
+    auto& entry = entries[sequence % capacity];
+
+    entry.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.call.store(call, std::memory_order_relaxed);
+    entry.window.store(window, std::memory_order_relaxed);
+    entry.depth.store(depth, std::memory_order_relaxed);
+    entry.order.store(order, std::memory_order_relaxed);
+    entry.start_ns.store(as_ns(start - created), std::memory_order_relaxed);
+    entry.duration_ns.store(as_ns(duration), std::memory_order_relaxed);
+
+    entry.sequence.store(sequence + 1, std::memory_order_release);
+}
+
+void miral::WindowManagementTraceRing::dump(std::ostream& out)
+{
+    struct Record
+    {
+        char const* call;
+        uintptr_t window;
+        unsigned depth;
+        uint64_t order;
+        int64_t start_ns;
+        int64_t duration_ns;
+    };
+
+    std::lock_guard<decltype(dump_mutex)> lock{dump_mutex};
+
+    auto const last = next_sequence.load(std::memory_order_acquire);
+    auto const first = std::max(dumped_sequence, last > capacity ? last - capacity : uint64_t{0});
+
+    std::vector<Record> records;
+    records.reserve(last - first);
+
+    for (auto sequence = first; sequence != last; ++sequence)
+    {
+        auto const& entry = entries[sequence % capacity];
+
+        if (entry.sequence.load(std::memory_order_acquire) != sequence + 1)
+            continue;
+
+        Record const record{
+            entry.call.load(std::memory_order_relaxed),
+            entry.window.load(std::memory_order_relaxed),
+            entry.depth.load(std::memory_order_relaxed),
+            entry.order.load(std::memory_order_relaxed),
+            entry.start_ns.load(std::memory_order_relaxed),
+            entry.duration_ns.load(std::memory_order_relaxed)};
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.sequence.load(std::memory_order_relaxed) == sequence + 1)
+            records.push_back(record);
+    }
+
+    if (first != dumped_sequence)
+        out << (first - dumped_sequence) << " earlier record(s) overwritten\n";
+
+    auto const skipped = (last - first) - records.size();
+    if (skipped)
+        out << skipped << " record(s) overwritten while dumping\n";
+
+    dumped_sequence = last;
+
+    // Calls are recorded as they finish, so nested calls come before the call containing them. Sort
+    // by the order they started, as a coarse clock can give a call and those it makes the same start.
+    std::sort(begin(records), end(records),
+        [](Record const& lhs, Record const& rhs) { return lhs.order < rhs.order; });
+
+    auto const flags = out.flags();
+    auto const precision = out.precision();
+    for (auto const& record : records)
+    {
+        out << std::dec << std::fixed << std::setprecision(3) << std::setw(12) << record.start_ns/1e6 << "ms "
+            << std::string(2*record.depth, ' ') << record.call;
+
+        if (record.window)
+            out << " window=" << std::hex << std::showbase << record.window << std::noshowbase << std::dec;
+
+        out << " (" << record.duration_ns/1000 << "us)\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+auto miral::WindowManagementTraceRing::id_of(Window const& window) -> uintptr_t
+{
+    std::shared_ptr<mir::scene::Surface> const surface = window;
+    return reinterpret_cast<uintptr_t>(surface.get());
+}
+
+miral::WindowManagementTraceRing::Recorder::Recorder(WindowManagementTraceRing* ring, char const* call, uintptr_t window) :
+    ring{ring},
+    call{call},
+    window{window},
+    depth{ring ? call_depth++ : 0},
+    order{ring ? ring->start_call() : 0},
+    start{ring ? Clock::now() : Clock::time_point{}}
+{
+}
+
+miral::WindowManagementTraceRing::Recorder::Recorder(WindowManagementTraceRing* ring, char const* call, Window const& window) :
+    Recorder{ring, call, ring ? id_of(window) : 0}
+{
+}
+
+miral::WindowManagementTraceRing::Recorder::~Recorder()
+{
+    if (ring)
+    {
+        --call_depth;
+        ring->record(call, window, depth, order, start, Clock::now() - start);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_WINDOW_MANAGEMENT_TRACE_RING_H
+#define MIRAL_WINDOW_MANAGEMENT_TRACE_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace miral
+{
+class Window;
+
+/// A fixed-size, lock-free record of window management calls.
+///
+/// Recording a call stores a handful of integers (the name is a pointer to the caller's __func__)
+/// so that it is cheap enough to leave on. Nothing is formatted until the ring is dumped.
+class WindowManagementTraceRing
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit WindowManagementTraceRing(size_t capacity);
+    ~WindowManagementTraceRing();
+
+    /// Numbers calls in the order they start, as the clock may not tell calls apart
+    auto start_call() -> uint64_t;
+
+    /// \param call     must have static storage duration (e.g. __func__)
+    /// \param window   identifies the window the call was about (0 if none)
+    /// \param order    from start_call()
+    void record(
+        char const* call,
+        uintptr_t window,
+        unsigned depth,
+        uint64_t order,
+        Clock::time_point start,
+        Clock::duration duration);
+
+    /// Writes the records made since the last dump, in the order the calls started.
+    /// Records that are overwritten while they are being dumped are skipped.
+    void dump(std::ostream& out);
+
+    /// An identifier for window that can be recorded without keeping it alive
+    static auto id_of(Window const& window) -> uintptr_t;
+
+    /// Records a call (and the time it took) on destruction. Does nothing if ring is null.
+    class Recorder
+    {
+    public:
+        Recorder(WindowManagementTraceRing* ring, char const* call, uintptr_t window = 0);
+        Recorder(WindowManagementTraceRing* ring, char const* call, Window const& window);
+        ~Recorder();
+
+        Recorder(Recorder const&) = delete;
+        Recorder& operator=(Recorder const&) = delete;
+
+    private:
+        WindowManagementTraceRing* const ring;
+        char const* const call;
+        uintptr_t const window;
+        unsigned const depth;
+        uint64_t const order;
+        Clock::time_point const start;
+    };
+
+private:
+    struct Entry;
+
+    size_t const capacity;
+    std::unique_ptr<Entry[]> const entries;
+    std::atomic<uint64_t> next_sequence{0};
+    std::atomic<uint64_t> next_call{0};
+
+    std::mutex dump_mutex;
+    uint64_t dumped_sequence{0};
+    Clock::time_point const created{Clock::now()};
+};
+}
+
+#endif //MIRAL_WINDOW_MANAGEMENT_TRACE_RING_H
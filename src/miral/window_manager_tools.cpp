@@ -104,6 +104,9 @@ auto miral::WindowManagerTools::id_for_window(Window const& window) const -> std
 void miral::WindowManagerTools::invoke_under_lock(std::function<void()> const& callback)
 { tools->invoke_under_lock(callback); }
 
+auto miral::WindowManagerTools::snapshot() const -> std::shared_ptr<WindowManagerSnapshot const>
+{ return tools->snapshot(); }
+
 void miral::WindowManagerTools::place_and_size_for_state(
     WindowSpecification& modifications, WindowInfo const& window_info) const
 { tools->place_and_size_for_state(modifications, window_info); }
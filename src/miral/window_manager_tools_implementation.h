@@ -37,6 +37,7 @@ struct WindowInfo;
 struct ApplicationInfo;
 class WindowSpecification;
 class Workspace;
+struct WindowManagerSnapshot;
 
 // The interface through which the policy instructs the controller.
 class WindowManagerToolsImplementation
@@ -96,6 +97,7 @@ public:
  *  already holds the lock).
  *  @{ */
     virtual void invoke_under_lock(std::function<void()> const& callback) = 0;
+    virtual auto snapshot() -> std::shared_ptr<WindowManagerSnapshot const> = 0;
 /** @} */
 
     virtual ~WindowManagerToolsImplementation() = default;
@@ -46,6 +46,11 @@ void miral::X11Support::operator()(mir::Server& server) const
         "xwayland-path",
         "Path to Xwayland executable", "/usr/bin/Xwayland");
 
+    server.add_configuration_option(
+        "xwayland-idle-timeout",
+        "Seconds without X11 windows before Xwayland is stopped (it restarts on the next X11 connection)."
+        " 0 keeps it running", 0);
+
     server.add_configuration_option(
         x11_displayfd_opt,
         "file descriptor to write X11 DISPLAY number to when ready to connect", mir::OptionType::integer);
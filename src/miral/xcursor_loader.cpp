@@ -22,6 +22,7 @@
 
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
+#include <vector>
 
 #include <string.h>
 
@@ -67,11 +68,55 @@ public:
         return {image->xhot, image->yhot};
     }
 
+    std::chrono::milliseconds duration() const
+    {
+        return std::chrono::milliseconds{image->delay};
+    }
+
 private:
     _XcursorImage *image;
     std::shared_ptr<_XcursorImages> const save_resource;
 };
 
+// XCursor files store animations as consecutive images of the same size
+class XCursorAnimation : public mg::AnimatedCursorImage
+{
+public:
+    XCursorAnimation(std::vector<std::unique_ptr<XCursorImage>> frames)
+        : frames(std::move(frames))
+    {
+    }
+
+    void const* as_argb_8888() const override
+    {
+        return frames.front()->as_argb_8888();
+    }
+    geom::Size size() const override
+    {
+        return frames.front()->size();
+    }
+    geom::Displacement hotspot() const override
+    {
+        return frames.front()->hotspot();
+    }
+
+    size_t frame_count() const override
+    {
+        return frames.size();
+    }
+    mg::CursorImage const& frame(size_t index) const override
+    {
+        return *frames.at(index);
+    }
+    std::chrono::milliseconds frame_duration(size_t index) const override
+    {
+        return frames.at(index)->duration();
+    }
+
+private:
+    std::vector<std::unique_ptr<XCursorImage>> const frames;
+};
+
 std::string const
 xcursor_name_for_mir_cursor(std::string const& mir_cursor_name)
 {
@@ -167,18 +212,39 @@ void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images
             XcursorImagesDestroy(images);
         });
 
+    _XcursorImage* chosen = images->images[0];
     for (int i = 0; i < images->nimage; i++)
     {
         _XcursorImage *candidate = images->images[i];
         if (candidate->width == mi::default_cursor_size.width.as_uint32_t() &&
             candidate->height == mi::default_cursor_size.height.as_uint32_t())
         {
-            loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(candidate, saved_xcursor_library_resource);
-            return;
+            chosen = candidate;
+            break;
+        }
+    }
+
+    std::vector<std::unique_ptr<XCursorImage>> frames;
+    for (int i = 0; i < images->nimage; i++)
+    {
+        _XcursorImage *candidate = images->images[i];
+        if (candidate->size == chosen->size &&
+            candidate->width == chosen->width &&
+            candidate->height == chosen->height &&
+            candidate->delay > 0)
+        {
+            frames.push_back(std::make_unique<XCursorImage>(candidate, saved_xcursor_library_resource));
         }
     }
 
-    loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
+    if (frames.size() > 1)
+    {
+        loaded_images[std::string(images->name)] = std::make_shared<XCursorAnimation>(std::move(frames));
+    }
+    else
+    {
+        loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(chosen, saved_xcursor_library_resource);
+    }
 }
 
 void miral::XCursorLoader::load_cursor_theme(std::string const& theme_name)
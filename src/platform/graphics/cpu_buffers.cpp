@@ -275,7 +275,15 @@ auto mrs::alloc_buffer_with_content(
     MirPixelFormat src_format) -> std::shared_ptr<graphics::Buffer>
 {
     auto const buffer = allocator.alloc_software_buffer(size, src_format);
+    write_buffer_content(buffer, content, src_stride);
+    return buffer;
+}
 
+void mrs::write_buffer_content(
+    std::shared_ptr<graphics::Buffer> const& buffer,
+    unsigned char const* content,
+    mir::geometry::Stride const& src_stride)
+{
     auto mapping = as_write_mappable_buffer(buffer)->map_writeable();
     if (mapping->stride() == src_stride)
     {
@@ -286,7 +294,7 @@ auto mrs::alloc_buffer_with_content(
     {
         // Less happy path: the buffer has a different stride; we need to copy row-by-row
         auto const dest_stride = mapping->stride().as_uint32_t();
-        for (auto y = 0u; y < size.height.as_uint32_t(); ++y)
+        for (auto y = 0u; y < mapping->size().height.as_uint32_t(); ++y)
         {
             ::memcpy(
                 mapping->data() + (dest_stride * y),
@@ -294,6 +302,4 @@ auto mrs::alloc_buffer_with_content(
                 src_stride.as_uint32_t());
         }
     }
-    return buffer;
 }
-
@@ -48,6 +48,14 @@ char const* const mo::touchspots_opt              = "enable-touchspots";
 char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
+char const* const mo::log_level_opt               = "log-level";
+char const* const mo::async_logging_opt           = "async-logging";
+char const* const mo::metrics_socket_opt          = "metrics-socket";
+char const* const mo::timeline_file_opt           = "timeline-file";
+char const* const mo::client_surface_limit_opt    = "client-surface-limit";
+char const* const mo::client_buffer_stream_limit_opt = "client-buffer-stream-limit";
+char const* const mo::client_buffer_memory_warning_opt = "client-buffer-memory-warning";
+char const* const mo::client_buffer_memory_limit_opt = "client-buffer-memory-limit";
 char const* const mo::composite_delay_opt         = "composite-delay";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
 char const* const mo::x11_display_opt             = "enable-x11";
@@ -57,6 +65,7 @@ char const* const mo::enable_mirclient_opt        = "enable-mirclient";
 char const* const mo::off_opt_value = "off";
 char const* const mo::log_opt_value = "log";
 char const* const mo::lttng_opt_value = "lttng";
+char const* const mo::metrics_opt_value = "metrics";
 
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
@@ -161,21 +170,21 @@ mo::DefaultConfiguration::DefaultConfiguration(
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "Compositor reporting [{log,lttng,off}]")
+            "Compositor reporting [{log,lttng,metrics,off}]")
         (connector_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Connector report. [{log,lttng,off}]")
         (display_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the Display report. [{log,lttng,off}]")
+            "How to handle the Display report. [{log,lttng,metrics,off}]")
         (input_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle to Input report. [{log,lttng,off}]")
+            "How to handle to Input report. [{log,lttng,metrics,off}]")
         (legacy_input_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Legacy Input report. [{log,off}]")
         (seat_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle to Seat report. [{log,off}]")
         (session_mediator_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the SessionMediator report. [{log,lttng,off}]")
+            "How to handle the SessionMediator report. [{log,lttng,metrics,off}]")
         (msg_processor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the MessageProcessor report. [{log,lttng,off}]")
+            "How to handle the MessageProcessor report. [{log,lttng,metrics,off}]")
         (scene_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the scene report. [{log,lttng,off}]")
         (shared_library_prober_report_opt, po::value<std::string>()->default_value(log_opt_value),
@@ -187,6 +196,14 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "frames from clients before compositing). Higher values result in "
             "lower latency but risk causing frame skipping. "
             "Default: A negative value means decide automatically.")
+        (client_surface_limit_opt, po::value<int>()->default_value(0),
+            "The most surfaces each client may have. (0 for no limit)")
+        (client_buffer_stream_limit_opt, po::value<int>()->default_value(0),
+            "The most buffer streams each client may have. (0 for no limit)")
+        (client_buffer_memory_warning_opt, po::value<int>()->default_value(0),
+            "Log a warning when a client's buffers use more than this many MiB. (0 for no warning)")
+        (client_buffer_memory_limit_opt, po::value<int>()->default_value(0),
+            "Refuse buffers that would take a client's buffers over this many MiB. (0 for no limit)")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
         (offscreen_opt,
@@ -202,6 +219,19 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
             "This is only interesting for people doing Mir server or client development.")
+        (log_level_opt, po::value<std::string>()->default_value("debug"),
+            "The least severe messages to log [{critical,error,warning,info,debug}]. "
+            "Less severe messages are discarded before they are formatted.")
+        (metrics_socket_opt, po::value<std::string>(),
+            "Unix socket to serve metrics on, in OpenMetrics (Prometheus) text format. "
+            "Metrics are recorded by reports set to \"metrics\" (e.g. --compositor-report=metrics)")
+        (timeline_file_opt, po::value<std::string>(),
+            "File to write a timeline of client commits, compositing, page flips and input dispatch to, in "
+            "Chrome trace-event JSON format (for chrome://tracing or ui.perfetto.dev). "
+            "Send SIGRTMIN (kill -s RTMIN <pid>) to start recording, and again to stop and write the file.")
+        (async_logging_opt,
+            "Write log messages from a background thread, so that logging never waits for the log to be written. "
+            "(Messages are dropped, and the number dropped is logged, if they are logged faster than they can be written.)")
         (enable_mirclient_opt, "Enable deprecated mirclient socket (for running old clients)")
         (console_provider,
             po::value<std::string>()->default_value("auto"),
@@ -188,7 +188,12 @@ void mgc::MemoryBackedShmBuffer::write(unsigned char const* data, size_t data_si
 {
     if (data_size != stride_.as_uint32_t()*size().height.as_uint32_t())
         BOOST_THROW_EXCEPTION(std::logic_error("Size is not equal to number of pixels in buffer"));
+
+    // Buffers such as the software cursor's are rewritten in place, so the
+    // texture needs refreshing on the next bind()
+    std::lock_guard<decltype(uploaded_mutex)> lock{uploaded_mutex};
     memcpy(pixels.get(), data, data_size);
+    uploaded = false;
 }
 
 void mgc::MemoryBackedShmBuffer::read(std::function<void(unsigned char const*)> const& do_with_pixels)
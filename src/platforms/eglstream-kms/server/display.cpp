@@ -201,6 +201,20 @@ public:
         pending_flip = satisfied_promise.get_future();
     }
 
+    ~DisplayBuffer()
+    {
+        auto const stats = event_handler->flip_statistics(crtc_id);
+        if (stats.flips > 0)
+        {
+            mir::log_debug(
+                "CRTC %u: %u flips, mean flip latency %lldus, max %lldus",
+                crtc_id,
+                stats.flips,
+                static_cast<long long>(stats.total_latency.count() / stats.flips),
+                static_cast<long long>(stats.max_latency.count()));
+        }
+    }
+
     /* gl::RenderTarget */
     void make_current() override
     {
@@ -253,7 +267,13 @@ public:
 
     void post() override
     {
-        // Wait for the last flip to finish, if it hasn't already.
+        /*
+         * Wait for the last flip to finish, if it hasn't already.
+         *
+         * The output stream only holds one frame, so this has to complete before we can
+         * acquire the next one. As we only get here once the next frame has been rendered,
+         * that rendering has already overlapped the scan-out of the previous one.
+         */
         pending_flip.get();
 
         pending_flip = event_handler->expect_flip_event(
@@ -19,6 +19,8 @@
 #ifndef MIR_PLATFORM_EGLSTREAM_DRM_EVENT_HANDLER_H_
 #define MIR_PLATFORM_EGLSTREAM_DRM_EVENT_HANDLER_H_
 
+#include <chrono>
+#include <functional>
 #include <future>
 
 namespace mir
@@ -27,6 +29,14 @@ namespace graphics
 {
 namespace eglstream
 {
+/// Page flip latency (from expecting a flip to its completion event) on a single CRTC
+struct FlipStatistics
+{
+    unsigned int flips{0};
+    std::chrono::microseconds total_latency{0};
+    std::chrono::microseconds max_latency{0};
+};
+
 class DRMEventHandler
 {
 public:
@@ -42,6 +52,8 @@ public:
     virtual std::future<void> expect_flip_event(
         KMSCrtcId id,
         std::function<void(unsigned int frame_number, std::chrono::milliseconds frame_time)> on_flip) = 0;
+
+    virtual FlipStatistics flip_statistics(KMSCrtcId id) = 0;
 };
 }
 }
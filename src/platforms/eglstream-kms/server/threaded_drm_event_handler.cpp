@@ -26,16 +26,32 @@
 #include <xf86drmMode.h>
 #include <xf86drm.h>
 #include <poll.h>
+#include <sys/eventfd.h>
 #include <cstring>
 #include <algorithm>
+#include <system_error>
 
 #define MIR_LOG_COMPONENT "EGLStream KMS event handler"
 #include "mir/log.h"
 
 namespace mge = mir::graphics::eglstream;
 
+namespace
+{
+mir::Fd make_eventfd()
+{
+    mir::Fd fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create eventfd"}));
+    }
+    return fd;
+}
+}
+
 mge::ThreadedDRMEventHandler::ThreadedDRMEventHandler(mir::Fd drm_fd)
     : drm_fd{std::move(drm_fd)},
+      wakeup{make_eventfd()},
       dispatch_thread{[this]() { event_loop(); }}
 {
 
@@ -46,8 +62,10 @@ mge::ThreadedDRMEventHandler::~ThreadedDRMEventHandler()
     {
         std::lock_guard<std::mutex> lock{expectation_mutex};
         shutdown = true;
-        expectations_changed.notify_all();
+        expectation_added.notify_one();
     }
+    // Interrupts the wait even if there's a flip outstanding that will never complete
+    eventfd_write(wakeup, 1);
     if (dispatch_thread.joinable())
     {
         dispatch_thread.join();
@@ -56,34 +74,17 @@ mge::ThreadedDRMEventHandler::~ThreadedDRMEventHandler()
 
 void const* mge::ThreadedDRMEventHandler::drm_event_data() const
 {
-    return &pending_expectations;
-}
-
-namespace
-{
-class NotifyOnScopeExit
-{
-public:
-    NotifyOnScopeExit(std::condition_variable& notifier)
-        : notifier{notifier}
-    {
-    }
-
-    ~NotifyOnScopeExit()
-    {
-        notifier.notify_all();
-    }
-private:
-    std::condition_variable& notifier;
-};
+    return this;
 }
 
 std::future<void> mge::ThreadedDRMEventHandler::expect_flip_event(
     DRMEventHandler::KMSCrtcId id,
     std::function<void(unsigned int frame_number, std::chrono::milliseconds frame_time)> on_flip)
 {
-    NotifyOnScopeExit notifier{expectations_changed};
+    // The dispatch thread is waiting on the DRM fd (or, after an error, for an expectation)
     std::lock_guard<std::mutex> lock{expectation_mutex};
+    expectation_added.notify_one();
+    auto const now = std::chrono::steady_clock::now();
     // First check if there's an empty slot in the vector (there probably is)
     for (auto& slot : pending_expectations)
     {
@@ -92,16 +93,24 @@ std::future<void> mge::ThreadedDRMEventHandler::expect_flip_event(
             slot = FlipEventData {
                 id,
                 std::move(on_flip),
-                std::promise<void>{}
+                std::promise<void>{},
+                now
             };
             return slot->completion.get_future();
         }
     }
     // There isn't, we'll need to expand the vector…
-    pending_expectations.emplace_back(FlipEventData {id, std::move(on_flip), std::promise<void>{}});
+    pending_expectations.emplace_back(FlipEventData {id, std::move(on_flip), std::promise<void>{}, now});
     return pending_expectations.back()->completion.get_future();
 }
 
+mge::FlipStatistics mge::ThreadedDRMEventHandler::flip_statistics(KMSCrtcId id)
+{
+    std::lock_guard<std::mutex> lock{expectation_mutex};
+    auto const stats = statistics.find(id);
+    return stats != statistics.end() ? stats->second : FlipStatistics{};
+}
+
 void mge::ThreadedDRMEventHandler::event_loop() noexcept
 {
     drmEventContext ctx;
@@ -109,48 +118,39 @@ void mge::ThreadedDRMEventHandler::event_loop() noexcept
     ctx.version = 3;
     ctx.page_flip_handler2 = &flip_handler;
 
-    auto const any_pending_expectations =
-        [this]()
-        {
-            return std::any_of(
-                pending_expectations.begin(),
-                pending_expectations.end(),
-                [](auto const& slot) { return static_cast<bool>(slot); });
-        };
-
-    std::unique_lock<std::mutex> lock{expectation_mutex};
-    while (!shutdown)
+    enum { drm_event, wakeup_event };
+    pollfd events[2];
+    events[drm_event].fd = drm_fd;
+    events[drm_event].events = POLLIN;
+    events[wakeup_event].fd = wakeup;
+    events[wakeup_event].events = POLLIN;
+
+    while (true)
     {
-        if (!any_pending_expectations())
-        {
-            expectations_changed.wait(
-                lock,
-                [this, &any_pending_expectations]()
-                {
-                    return shutdown || any_pending_expectations();
-                });
-        }
+        // Wait without the lock held, so consumers can add expectations meanwhile
+        auto const result = ::poll(events, 2, -1);
+        auto const error = errno;
+
+        // We've got some events; take the lock and process them.
+        std::unique_lock<std::mutex> lock{expectation_mutex};
         if (shutdown)
         {
             return;
         }
 
-        /*
-         * We have some pending expectations.
-         * Drop the lock (consumers can only add expectations at this point) and wait for
-         * the DRM events
-         */
-        lock.unlock();
-
-        pollfd events;
-        events.fd = drm_fd;
-        events.events = POLLIN;
-        // TODO: Maybe have a non-infinite timeout here?
-        auto result = ::poll(&events, 1, -1);
-
-        // We've got some events; reclaim the lock and process them.
-        lock.lock();
-        if (result == -1 && errno != EINTR)
+        if (result == -1 && error == EINTR)
+        {
+            continue;
+        }
+
+        // A closed or broken DRM fd isn't reported by poll() failing, but in revents
+        auto const drm_fd_error =
+            result == -1 ? error :
+            events[drm_event].revents & POLLNVAL ? EBADF :
+            events[drm_event].revents & (POLLERR | POLLHUP) ? EIO :
+            0;
+
+        if (drm_fd_error)
         {
             // Error: abandon all the pending flips, then wait for further instructions
             for (auto& slot : pending_expectations)
@@ -161,7 +161,7 @@ void mge::ThreadedDRMEventHandler::event_loop() noexcept
                         std::make_exception_ptr(
                             boost::enable_error_info(
                                 std::system_error{
-                                    errno,
+                                    drm_fd_error,
                                     std::system_category(),
                                     "Error waiting for DRM event"})
                                 << boost::throw_file(__FILE__)
@@ -170,8 +170,29 @@ void mge::ThreadedDRMEventHandler::event_loop() noexcept
                     slot = {};
                 }
             }
+
+            // Polling again straight away would spin if the error persists (e.g. EBADF), so
+            // don't until someone is waiting for a flip
+            expectation_added.wait(lock, [this]
+                {
+                    return shutdown || std::any_of(
+                        pending_expectations.begin(), pending_expectations.end(),
+                        [](auto const& slot) { return static_cast<bool>(slot); });
+                });
+
+            if (shutdown)
+            {
+                return;
+            }
+            continue;
         }
-        else if (events.revents & POLLIN)
+
+        if (events[wakeup_event].revents & POLLIN)
+        {
+            eventfd_t ignored;
+            eventfd_read(wakeup, &ignored);
+        }
+        if (events[drm_event].revents & POLLIN)
         {
             drmHandleEvent(drm_fd, &ctx);
         }
@@ -190,11 +211,18 @@ void mge::ThreadedDRMEventHandler::flip_handler(
      * No need to lock (and indeed, locking would be incorrect) as this is only called from
      * drmHandleEvent() which is only called from event_loop, and is called while holding the lock
      */
-    auto pending_expectations = static_cast<std::vector<std::experimental::optional<FlipEventData>>*>(data);
-    for (auto& slot : *pending_expectations)
+    auto const self = static_cast<ThreadedDRMEventHandler*>(data);
+    for (auto& slot : self->pending_expectations)
     {
         if (slot && slot->id == crtc_id)
         {
+            auto const latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - slot->expected_at);
+            auto& stats = self->statistics[crtc_id];
+            stats.flips++;
+            stats.total_latency += latency;
+            stats.max_latency = std::max(stats.max_latency, latency);
+
             slot->callback(
                 frame_number,
                 std::chrono::seconds{sec} + std::chrono::milliseconds{usec});
@@ -25,9 +25,11 @@
 
 #include <functional>
 #include <vector>
+#include <unordered_map>
 #include <experimental/optional>
-#include <mutex>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace mir
 {
@@ -35,6 +37,11 @@ namespace graphics
 {
 namespace eglstream
 {
+/// Dispatches the flip events of every output on a DRM device from a single thread.
+///
+/// The thread is always waiting on the DRM fd, so expecting a flip is just a matter of
+/// recording it; the thread is only woken through its eventfd to shut down. (If waiting
+/// on the DRM fd fails, the thread waits for the next expectation before trying again.)
 class ThreadedDRMEventHandler : public DRMEventHandler
 {
 public:
@@ -47,6 +54,8 @@ public:
         KMSCrtcId id,
         std::function<void(unsigned int, std::chrono::milliseconds)> on_flip) override;
 
+    FlipStatistics flip_statistics(KMSCrtcId id) override;
+
 private:
     void event_loop() noexcept;
 
@@ -59,17 +68,20 @@ private:
         void* data) noexcept;
 
     mir::Fd const drm_fd;
+    mir::Fd const wakeup;
 
     struct FlipEventData
     {
         KMSCrtcId id;
         std::function<void(unsigned int, std::chrono::milliseconds)> callback;
         std::promise<void> completion;
+        std::chrono::steady_clock::time_point expected_at;
     };
     // We *could* do something fancy and lock-free, but a basic mutex will suffice for now
     std::mutex expectation_mutex;
-    std::condition_variable expectations_changed;
+    std::condition_variable expectation_added;
     std::vector<std::experimental::optional<FlipEventData>> pending_expectations;
+    std::unordered_map<KMSCrtcId, FlipStatistics> statistics;
 
     bool shutdown{false};
     std::thread dispatch_thread;
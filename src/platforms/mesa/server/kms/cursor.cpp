@@ -28,6 +28,7 @@
 
 #include <boost/exception/errinfo_errno.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 
@@ -97,18 +98,94 @@ gbm_device* gbm_create_device_checked(int fd)
     }
     return device;
 }
+
+// Enough for the frames of a typical animated cursor, in a couple of orientations
+size_t const max_cached_images = 16;
+
+// FNV-1a, which is plenty to tell cursor images apart
+uint64_t hash_of(std::vector<uint8_t> const& data)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto const byte : data)
+    {
+        hash ^= byte;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/*
+ * Copy a width x height block of pixels rotated for orientation. Rows are
+ * reversed whole (which vectorizes) and sideways rotations are done in
+ * small tiles so both source and destination stay in cache.
+ */
+void rotate_pixels(
+    uint32_t const* src, size_t src_stride,
+    uint32_t width, uint32_t height,
+    uint32_t* dest, size_t dest_stride,
+    MirOrientation orientation)
+{
+    uint32_t const tile = 8;
+
+    switch (orientation)
+    {
+    case mir_orientation_normal:
+        for (uint32_t y = 0; y != height; ++y)
+            std::copy_n(src + y*src_stride, width, dest + y*dest_stride);
+        break;
+
+    case mir_orientation_inverted:
+        for (uint32_t y = 0; y != height; ++y)
+        {
+            auto const src_row = src + ((height-1)-y)*src_stride;
+            std::reverse_copy(src_row, src_row + width, dest + y*dest_stride);
+        }
+        break;
+
+    case mir_orientation_left:
+        for (uint32_t row0 = 0; row0 < width; row0 += tile)
+        {
+            for (uint32_t col0 = 0; col0 < height; col0 += tile)
+            {
+                auto const row_end = std::min(row0 + tile, width);
+                auto const col_end = std::min(col0 + tile, height);
+                for (auto row = row0; row != row_end; ++row)
+                {
+                    for (auto col = col0; col != col_end; ++col)
+                        dest[row*dest_stride + col] = src[col*src_stride + (width-1)-row];
+                }
+            }
+        }
+        break;
+
+    case mir_orientation_right:
+        for (uint32_t row0 = 0; row0 < width; row0 += tile)
+        {
+            for (uint32_t col0 = 0; col0 < height; col0 += tile)
+            {
+                auto const row_end = std::min(row0 + tile, width);
+                auto const col_end = std::min(col0 + tile, height);
+                for (auto row = row0; row != row_end; ++row)
+                {
+                    for (auto col = col0; col != col_end; ++col)
+                        dest[row*dest_stride + col] = src[((height-1)-col)*src_stride + row];
+                }
+            }
+        }
+        break;
+    }
+}
 }
 
-mgm::Cursor::GBMBOWrapper::GBMBOWrapper(int fd, MirOrientation orientation) :
-    device{gbm_create_device_checked(fd)},
+mgm::Cursor::GBMBOWrapper::GBMBOWrapper(std::shared_ptr<gbm_device> const& device, int fd) :
+    device{device},
     buffer{
         gbm_bo_create(
-            device,
+            device.get(),
             get_drm_cursor_width(fd),
             get_drm_cursor_height(fd),
             GBM_FORMAT_ARGB8888,
-            GBM_BO_USE_CURSOR | GBM_BO_USE_WRITE)},
-    current_orientation{orientation}
+            GBM_BO_USE_CURSOR | GBM_BO_USE_WRITE)}
 {
     if (!buffer) BOOST_THROW_EXCEPTION(std::runtime_error("failed to create gbm buffer"));
 }
@@ -120,28 +197,22 @@ inline mgm::Cursor::GBMBOWrapper::operator gbm_bo*()
 
 inline mgm::Cursor::GBMBOWrapper::~GBMBOWrapper()
 {
-    if (device)
-        gbm_device_destroy(device);
     if (buffer)
         gbm_bo_destroy(buffer);
 }
 
 mgm::Cursor::GBMBOWrapper::GBMBOWrapper(GBMBOWrapper&& from)
-    : device{from.device},
-      buffer{from.buffer},
-      current_orientation{from.current_orientation}
+    : device{std::move(from.device)},
+      buffer{from.buffer}
 {
     from.buffer = nullptr;
-    from.device = nullptr;
 }
 
-auto mir::graphics::mesa::Cursor::GBMBOWrapper::change_orientation(MirOrientation new_orientation) -> bool
+mgm::Cursor::OutputBuffers::OutputBuffers(uint32_t id, int drm_fd) :
+    id{id},
+    drm_fd{drm_fd},
+    device{gbm_create_device_checked(drm_fd), &gbm_device_destroy}
 {
-    if (current_orientation == new_orientation)
-        return false;
-
-    current_orientation = new_orientation;
-    return true;
 }
 
 mgm::Cursor::Cursor(
@@ -162,7 +233,7 @@ mgm::Cursor::Cursor(
                 [this, &kms_conf](auto const& output)
                 {
                     // I'm not sure why g++ needs the explicit "this->" but it does - alan_g
-                    this->buffer_for_output(*kms_conf.get_output_for(output.id));
+                    this->buffers_for_output(*kms_conf.get_output_for(output.id));
                 });
         });
 
@@ -192,9 +263,9 @@ void mgm::Cursor::write_buffer_data_locked(
 
 void mgm::Cursor::pad_and_write_image_data_locked(
     std::lock_guard<std::mutex> const& lg,
-    GBMBOWrapper& buffer)
+    gbm_bo* buffer,
+    MirOrientation orientation)
 {
-    auto const orientation = buffer.orientation();
     bool const sideways = orientation == mir_orientation_left || orientation == mir_orientation_right;
 
     auto const min_width  = sideways ? min_buffer_width : min_buffer_height;
@@ -202,77 +273,22 @@ void mgm::Cursor::pad_and_write_image_data_locked(
 
     auto const image_width = std::min(min_width, size.width.as_uint32_t());
     auto const image_height = std::min(min_height, size.height.as_uint32_t());
-    auto const image_stride = size.width.as_uint32_t() * 4;
+    auto const image_stride = size.width.as_uint32_t();  // in pixels
 
     auto const buffer_stride = std::max(min_width*4, gbm_bo_get_stride(buffer));  // in bytes
     auto const buffer_height = std::max(min_height, gbm_bo_get_height(buffer));
     size_t const padded_size = buffer_stride * buffer_height;
 
-    auto padded = std::unique_ptr<uint8_t[]>(new uint8_t[padded_size]);
-    size_t rhs_padding = buffer_stride - 4*image_width;
-
-    auto const filler = 0; // 0x3f; is useful to make buffer visible for debugging
-    uint8_t const* src = argb8888.data();
-    uint8_t* dest = &padded[0];
-
-    switch (orientation)
-    {
-    case mir_orientation_normal:
-        for (unsigned int y = 0; y < image_height; y++)
-        {
-            memcpy(dest, src, 4*image_width);
-            memset(dest + 4*image_width, filler, rhs_padding);
-            dest += buffer_stride;
-            src += image_stride;
-        }
-
-        memset(dest, 0, buffer_stride * (buffer_height - image_height));
-        break;
-
-    case mir_orientation_inverted:
-        for (unsigned int row = 0; row != image_height; ++row)
-        {
-            memset(dest+row*buffer_stride+4*image_width, filler, rhs_padding);
-
-            for (unsigned int col = 0; col != image_width; ++col)
-            {
-                memcpy(dest+row*buffer_stride+4*col, src + ((image_height-1)-row)*image_stride + 4*((image_width-1)-col), 4);
-            }
-        }
-
-        memset(dest+image_height*buffer_stride, filler, buffer_stride * (buffer_height - image_height));
-        break;
-
-    case mir_orientation_left:
-        for (unsigned int row = 0; row != image_width; ++row)
-        {
-            memset(dest+row*buffer_stride+4*image_height, filler, rhs_padding);
-
-            for (unsigned int col = 0; col != image_height; ++col)
-            {
-                memcpy(dest+row*buffer_stride+4*col, src + ((image_width-1)-row)*4 + image_stride*col, 4);
-            }
-        }
-
-        memset(dest+image_width*buffer_stride, filler, buffer_stride * (buffer_height - image_width));
-        break;
-
-    case mir_orientation_right:
-        for (unsigned int row = 0; row != image_width; ++row)
-        {
-            memset(dest+row*buffer_stride+4*image_height, filler, rhs_padding);
+    // Zero (transparent) fill does the padding; 0x3f is useful to make the buffer visible for debugging
+    auto padded = std::unique_ptr<uint32_t[]>(new uint32_t[(padded_size + 3) / 4]());
 
-            for (unsigned int col = 0; col != image_height; ++col)
-            {
-                memcpy(dest+row*buffer_stride+4*col, src + row*4 + image_stride*((image_height-1)-col), 4);
-            }
-        }
-
-        memset(dest+image_width*buffer_stride, filler, buffer_stride * (buffer_height - image_width));
-        break;
-    }
+    rotate_pixels(
+        reinterpret_cast<uint32_t const*>(argb8888.data()), image_stride,
+        image_width, image_height,
+        padded.get(), buffer_stride / 4,
+        orientation);
 
-    write_buffer_data_locked(lg, buffer, &padded[0], padded_size);
+    write_buffer_data_locked(lg, buffer, padded.get(), padded_size);
 }
 
 void mgm::Cursor::show(CursorImage const& cursor_image)
@@ -284,12 +300,16 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
     argb8888.resize(size.width.as_uint32_t() * size.height.as_uint32_t() * 4);
     memcpy(argb8888.data(), cursor_image.as_argb_8888(), argb8888.size());
 
+    image_hash = hash_of(argb8888);
+
     hotspot = cursor_image.hotspot();
     {
         auto locked_buffers = buffers.lock();
-        for (auto& tuple : *locked_buffers)
+        for (auto& output_buffers : *locked_buffers)
         {
-            pad_and_write_image_data_locked(lg, std::get<2>(tuple));
+            auto const orientation =
+                output_buffers->current ? output_buffers->current->orientation : mir_orientation_normal;
+            output_buffers->current = &image_for_locked(lg, *output_buffers, orientation);
         }
     }
 
@@ -405,16 +425,15 @@ void mgm::Cursor::place_cursor_at_locked(
             // work on radeon and intel. There also seems to be precedent in weston for
             // implementing hotspot in this fashion.
             output.move_cursor(position_on_output - hotspot_displacement);
-            auto& buffer = buffer_for_output(output);
+            auto& output_buffers = buffers_for_output(output);
+            auto& image = image_for_locked(lg, output_buffers, orientation);
 
-            auto const changed_orientation = buffer.change_orientation(orientation);
+            auto const changed_buffer = &image != output_buffers.current;
+            output_buffers.current = &image;
 
-            if (changed_orientation)
-                pad_and_write_image_data_locked(lg, buffer);
-
-            if (force_state || !output.has_cursor() || changed_orientation)
+            if (force_state || !output.has_cursor() || changed_buffer)
             {
-                if (!output.set_cursor(buffer) || !output.has_cursor())
+                if (!output.set_cursor(image.buffer) || !output.has_cursor())
                     set_on_all_outputs = false;
             }
         }
@@ -430,30 +449,111 @@ void mgm::Cursor::place_cursor_at_locked(
     last_set_failed = !set_on_all_outputs;
 }
 
-mgm::Cursor::GBMBOWrapper& mgm::Cursor::buffer_for_output(KMSOutput const& output)
+auto mgm::Cursor::buffers_for_output(KMSOutput const& output) -> OutputBuffers&
 {
     auto const drm_fd = output.drm_fd();
     auto const id = output.id();
     auto locked_buffers = buffers.lock();
 
-    for (auto& bo : *locked_buffers)
+    for (auto& output_buffers : *locked_buffers)
     {
         // We use both id and drm_fd as identifier as we're not sure of the uniqueness of either
-        if (std::get<0>(bo) == id && std::get<1>(bo) == drm_fd)
-            return std::get<2>(bo);
+        if (output_buffers->id == id && output_buffers->drm_fd == drm_fd)
+            return *output_buffers;
     }
 
-    locked_buffers->push_back(image_buffer{id, drm_fd, GBMBOWrapper{drm_fd, mir_orientation_normal}});
+    locked_buffers->push_back(std::make_unique<OutputBuffers>(id, drm_fd));
+    auto& output_buffers = *locked_buffers->back();
+
+    output_buffers.images.push_back(
+        std::make_unique<CachedImage>(GBMBOWrapper{output_buffers.device, drm_fd}));
+    auto& bo = output_buffers.images.back()->buffer;
 
-    GBMBOWrapper& bo = std::get<2>(locked_buffers->back());
+    bool min_size_changed = false;
     if (gbm_bo_get_width(bo) < min_buffer_width)
     {
         min_buffer_width = gbm_bo_get_width(bo);
+        min_size_changed = true;
     }
     if (gbm_bo_get_height(bo) < min_buffer_height)
     {
         min_buffer_height = gbm_bo_get_height(bo);
+        min_size_changed = true;
+    }
+
+    // Images are padded/cropped to the minimum size, so anything cached is now wrong
+    if (min_size_changed)
+    {
+        for (auto& other : *locked_buffers)
+        {
+            for (auto& image : other->images)
+                image->written = false;
+        }
+    }
+
+    return output_buffers;
+}
+
+auto mgm::Cursor::image_for_locked(
+    std::lock_guard<std::mutex> const& lg,
+    OutputBuffers& output_buffers,
+    MirOrientation orientation) -> CachedImage&
+{
+    auto& images = output_buffers.images;
+
+    auto const cached = std::find_if(begin(images), end(images), [&](auto const& image)
+        {
+            return image->written &&
+                image->image_hash == image_hash &&
+                image->image_size == size &&
+                image->orientation == orientation;
+        });
+
+    if (cached != end(images))
+    {
+        (*cached)->last_used = ++use_count;
+        return **cached;
+    }
+
+    // Prefer an unused buffer, then a new one, then the least recently used
+    // (other than the one on screen, which the hardware may still be scanning out)
+    CachedImage* target = nullptr;
+    auto const unwritten = std::find_if(begin(images), end(images), [&](auto const& image)
+        { return !image->written && image.get() != output_buffers.current; });
+
+    if (unwritten != end(images))
+    {
+        target = unwritten->get();
+    }
+    else if (images.size() < max_cached_images)
+    {
+        images.push_back(std::make_unique<CachedImage>(GBMBOWrapper{output_buffers.device, output_buffers.drm_fd}));
+        target = images.back().get();
+    }
+    else
+    {
+        for (auto const& image : images)
+        {
+            if (image.get() != output_buffers.current &&
+                (!target || image->last_used < target->last_used))
+            {
+                target = image.get();
+            }
+        }
     }
 
-    return bo;
+    // Only possible with a single buffer: rewrite the one on screen
+    if (!target)
+        target = output_buffers.current;
+
+    target->written = false;
+    pad_and_write_image_data_locked(lg, target->buffer, orientation);
+
+    target->written = true;
+    target->image_hash = image_hash;
+    target->image_size = size;
+    target->orientation = orientation;
+    target->last_used = ++use_count;
+
+    return *target;
 }
@@ -86,6 +86,8 @@ public:
 private:
     enum ForceCursorState { UpdateState, ForceState };
     struct GBMBOWrapper;
+    struct CachedImage;
+    struct OutputBuffers;
     void for_each_used_output(std::function<void(KMSOutput& output, DisplayConfigurationOutput const& conf)> const& f);
     void place_cursor_at(geometry::Point position, ForceCursorState force_state);
     void place_cursor_at_locked(std::lock_guard<std::mutex> const&, geometry::Point position, ForceCursorState force_state);
@@ -96,11 +98,18 @@ private:
         size_t count);
     void pad_and_write_image_data_locked(
         std::lock_guard<std::mutex> const&,
-        GBMBOWrapper& buffer);
+        gbm_bo* buffer,
+        MirOrientation orientation);
     void clear(std::lock_guard<std::mutex> const&);
 
-    GBMBOWrapper& buffer_for_output(KMSOutput const& output);
-    
+    OutputBuffers& buffers_for_output(KMSOutput const& output);
+
+    /// The buffer holding the current image in \a orientation, writing it if not already cached
+    CachedImage& image_for_locked(
+        std::lock_guard<std::mutex> const&,
+        OutputBuffers& output_buffers,
+        MirOrientation orientation);
+
     std::mutex guard;
 
     KMSOutputContainer& output_container;
@@ -108,31 +117,52 @@ private:
     geometry::Displacement hotspot;
     geometry::Size size;
     std::vector<uint8_t> argb8888;
+    uint64_t image_hash{0};
+    uint64_t use_count{0};
 
     bool visible;
     bool last_set_failed;
 
     struct GBMBOWrapper
     {
-        GBMBOWrapper(int fd, MirOrientation orientation);
+        GBMBOWrapper(std::shared_ptr<gbm_device> const& device, int fd);
         operator gbm_bo*();
 
-        auto orientation() const -> MirOrientation { return current_orientation; }
-        auto change_orientation(MirOrientation new_orientation) -> bool;
-
         ~GBMBOWrapper();
 
         GBMBOWrapper(GBMBOWrapper&& from);
     private:
-        gbm_device* device;
+        std::shared_ptr<gbm_device> device;
         gbm_bo* buffer;
-        MirOrientation current_orientation;
         GBMBOWrapper(GBMBOWrapper const&) = delete;
         GBMBOWrapper& operator=(GBMBOWrapper const&) = delete;
     };
 
-    using image_buffer = std::tuple<uint32_t, int, GBMBOWrapper>;
-    Mutex<std::vector<image_buffer>> buffers;
+    /// A cursor buffer holding one image, padded and rotated for one orientation
+    struct CachedImage
+    {
+        explicit CachedImage(GBMBOWrapper&& buffer) : buffer{std::move(buffer)} {}
+
+        GBMBOWrapper buffer;
+        bool written{false};
+        uint64_t image_hash{0};
+        geometry::Size image_size;
+        MirOrientation orientation{mir_orientation_normal};
+        uint64_t last_used{0};
+    };
+
+    struct OutputBuffers
+    {
+        OutputBuffers(uint32_t id, int drm_fd);
+
+        uint32_t const id;
+        int const drm_fd;
+        std::shared_ptr<gbm_device> const device;
+        std::vector<std::unique_ptr<CachedImage>> images;
+        CachedImage* current{nullptr};
+    };
+
+    Mutex<std::vector<std::unique_ptr<OutputBuffers>>> buffers;
 
     uint32_t min_buffer_width;
     uint32_t min_buffer_height;
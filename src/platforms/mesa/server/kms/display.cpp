@@ -45,7 +45,9 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mgm = mir::graphics::mesa;
 namespace mg = mir::graphics;
@@ -53,6 +55,27 @@ namespace geom = mir::geometry;
 
 namespace
 {
+/// Reports how long each step of applying a display configuration takes
+class ConfigurationPhaseTimer
+{
+public:
+    ConfigurationPhaseTimer(mg::DisplayReport& report)
+        : report{report},
+          phase_start{std::chrono::steady_clock::now()}
+    {
+    }
+
+    void phase_done(char const* phase)
+    {
+        auto const now = std::chrono::steady_clock::now();
+        report.report_configuration_phase(phase, now - phase_start);
+        phase_start = now;
+    }
+
+private:
+    mg::DisplayReport& report;
+    std::chrono::steady_clock::time_point phase_start;
+};
 
 class GBMGLContext : public mir::renderer::gl::Context
 {
@@ -303,15 +326,20 @@ void mgm::Display::resume()
     {
         std::lock_guard<std::mutex> lg{configuration_mutex};
 
+        ConfigurationPhaseTimer timer{*listener};
+
         /*
          * After resuming (e.g. because we switched back to the display server VT)
-         * we need to reset the CRTCs. For active displays we schedule a CRTC reset
-         * on the next swap. For connected but unused outputs we clear the CRTC.
+         * we need to reset the CRTCs. Active displays go straight back to showing
+         * their last frame (falling back to a CRTC reset on the next swap), so
+         * there's something on screen while the compositor catches up. For
+         * connected but unused outputs we clear the CRTC.
          */
         for (auto& db_ptr : display_buffers)
-            db_ptr->schedule_set_crtc();
+            db_ptr->restore_last_frame();
 
         clear_connected_unused_outputs();
+        timer.phase_done("restore last frames on resume");
     }
 
     if (auto c = cursor.lock()) c->resume();
@@ -418,8 +446,13 @@ bool mgm::Display::apply_if_configuration_preserves_display_buffers(
 
 mg::Frame mgm::Display::last_frame_on(unsigned output_id) const
 {
-    auto output = current_display_configuration.get_output_for(
-        DisplayConfigurationOutputId{static_cast<int>(output_id)});
+    // Called from IPC threads, so the configuration may be changing under us
+    std::shared_ptr<KMSOutput> output;
+    {
+        std::lock_guard<std::mutex> lg{configuration_mutex};
+        output = current_display_configuration.get_output_for(
+            DisplayConfigurationOutputId{static_cast<int>(output_id)});
+    }
     return output->last_frame();
 }
 
@@ -450,6 +483,44 @@ void add_to_drm_device_group(
         grouping.push_back(std::vector<std::shared_ptr<mgm::KMSOutput>>{std::move(output)});
     }
 }
+
+auto outputs_of(mg::OverlappingOutputGroup const& group) -> std::vector<mg::DisplayConfigurationOutput>
+{
+    std::vector<mg::DisplayConfigurationOutput> outputs;
+    group.for_each_output(
+        [&](mg::DisplayConfigurationOutput const& output)
+        {
+            outputs.push_back(output);
+        });
+    return outputs;
+}
+
+/*
+ * Whether a display buffer set up for outputs can carry on unchanged showing outputs_now.
+ * mg::operator==() ignores the power mode, gamma and pixel format, but those are only
+ * applied to outputs while setting up a display buffer, so they must match too.
+ */
+auto can_keep(
+    std::vector<mg::DisplayConfigurationOutput> const& outputs,
+    std::vector<mg::DisplayConfigurationOutput> const& outputs_now) -> bool
+{
+    if (outputs != outputs_now)
+        return false;
+
+    for (size_t i = 0; i != outputs.size(); ++i)
+    {
+        if (outputs[i].power_mode != outputs_now[i].power_mode ||
+            outputs[i].current_format != outputs_now[i].current_format ||
+            outputs[i].gamma.red != outputs_now[i].gamma.red ||
+            outputs[i].gamma.green != outputs_now[i].gamma.green ||
+            outputs[i].gamma.blue != outputs_now[i].gamma.blue)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
 }
 
 void mgm::Display::configure_locked(
@@ -462,9 +533,38 @@ void mgm::Display::configure_locked(
         (&kms_conf != &current_display_configuration) &&
         compatible(kms_conf, current_display_configuration)};
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers_new;
+    std::vector<std::vector<DisplayConfigurationOutput>> display_buffer_outputs_new;
+    ConfigurationPhaseTimer timer{*listener};
+
+    OverlappingOutputGrouping grouping{kms_conf};
+
+    /*
+     * Even when the configuration as a whole isn't compatible (eg: an output has
+     * been plugged in) most groups of outputs are often exactly as they were
+     * (including their power mode and gamma).
+     * Keep the display buffers of those running, rather than blanking and
+     * modesetting them again along with the outputs that have changed.
+     */
+    std::vector<bool> retained(display_buffers.size(), false);
+    std::unordered_set<int> retained_output_ids;
 
     if (!comp)
     {
+        grouping.for_each_group(
+            [&](OverlappingOutputGroup const& group)
+            {
+                auto const outputs = outputs_of(group);
+                for (size_t i = 0; i != display_buffers.size(); ++i)
+                {
+                    if (can_keep(display_buffer_outputs[i], outputs))
+                    {
+                        retained[i] = true;
+                        for (auto const& output : outputs)
+                            retained_output_ids.insert(output.id.as_value());
+                    }
+                }
+            });
+
         /*
          * Notice for a little while here we will have duplicate
          * DisplayBuffers attached to each output, and the display_buffers_new
@@ -473,58 +573,85 @@ void mgm::Display::configure_locked(
          * sure we wait for all pending page flips to finish before the
          * display_buffers_new are created and take control of the outputs.
          */
-        for (auto& db : display_buffers)
-            db->wait_for_page_flip();
+        for (size_t i = 0; i != display_buffers.size(); ++i)
+        {
+            if (!retained[i])
+                display_buffers[i]->wait_for_page_flip();
+        }
+        timer.phase_done("wait for page flips");
 
-        /* Reset the state of all outputs */
+        /* Reset the state of all changed outputs */
         kms_conf.for_each_output(
             [&](DisplayConfigurationOutput const& conf_output)
             {
+                if (retained_output_ids.count(conf_output.id.as_value()))
+                    return;
+
                 auto kms_output = current_display_configuration.get_output_for(conf_output.id);
                 kms_output->clear_cursor();
                 kms_output->reset();
             });
+        timer.phase_done("reset outputs");
     }
 
     /* Set up used outputs */
-    OverlappingOutputGrouping grouping{kms_conf};
     auto group_idx = 0;
 
     grouping.for_each_group(
         [&](OverlappingOutputGroup const& group)
         {
             auto bounding_rect = group.bounding_rectangle();
+            auto const group_outputs = outputs_of(group);
+
+            if (!comp)
+            {
+                bool kept{false};
+                for (size_t i = 0; i != display_buffers.size(); ++i)
+                {
+                    if (retained[i] && can_keep(display_buffer_outputs[i], group_outputs))
+                    {
+                        display_buffers_new.push_back(std::move(display_buffers[i]));
+                        display_buffer_outputs_new.push_back(group_outputs);
+                        retained[i] = false;
+                        kept = true;
+                    }
+                }
+                if (kept)
+                    return;
+            }
+
             // Each vector<KMSOutput> is a single GPU memory domain
             std::vector<std::vector<std::shared_ptr<KMSOutput>>> kms_output_groups;
             glm::mat2 transformation;
             geom::Size current_mode_resolution;
 
-            group.for_each_output(
-                [&](DisplayConfigurationOutput const& conf_output)
-                {
-                    auto kms_output = current_display_configuration.get_output_for(conf_output.id);
+            for (auto const& conf_output : group_outputs)
+            {
+                auto kms_output = current_display_configuration.get_output_for(conf_output.id);
 
-                    auto const mode_index = kms_conf.get_kms_mode_index(conf_output.id,
-                                                                  conf_output.current_mode_index);
-                    kms_output->configure(conf_output.top_left - bounding_rect.top_left, mode_index);
-                    if (!comp)
-                    {
-                        kms_output->set_power_mode(conf_output.power_mode);
-                        kms_output->set_gamma(conf_output.gamma);
-                        add_to_drm_device_group(kms_output_groups, std::move(kms_output));
-                    }
+                auto const mode_index = kms_conf.get_kms_mode_index(conf_output.id,
+                                                              conf_output.current_mode_index);
+                kms_output->configure(conf_output.top_left - bounding_rect.top_left, mode_index);
+                kms_output->set_variable_refresh(conf_output.vrr_capable && conf_output.vrr_enabled);
+                if (!comp)
+                {
+                    kms_output->set_power_mode(conf_output.power_mode);
+                    kms_output->set_gamma(conf_output.gamma);
+                    add_to_drm_device_group(kms_output_groups, std::move(kms_output));
+                }
 
-                    /*
-                     * Presently OverlappingOutputGroup guarantees all grouped
-                     * outputs have the same transformation.
-                     */
-                    transformation = conf_output.transformation();
-                    if (conf_output.current_mode_index < conf_output.modes.size())
-                        current_mode_resolution = conf_output.modes[conf_output.current_mode_index].size;
-                });
+                /*
+                 * Presently OverlappingOutputGroup guarantees all grouped
+                 * outputs have the same transformation.
+                 */
+                transformation = conf_output.transformation();
+                if (conf_output.current_mode_index < conf_output.modes.size())
+                    current_mode_resolution = conf_output.modes[conf_output.current_mode_index].size;
+            }
 
             if (comp)
             {
+                display_buffer_outputs[group_idx] = group_outputs;
                 display_buffers[group_idx++]->set_transformation(transformation,
                                                                  bounding_rect);
             }
@@ -564,17 +691,25 @@ void mgm::Display::configure_locked(
                         transformation);
 
                     display_buffers_new.push_back(std::move(db));
+                    display_buffer_outputs_new.push_back(group_outputs);
                 }
             }
         });
 
     if (!comp)
+    {
         display_buffers = std::move(display_buffers_new);
+        display_buffer_outputs = std::move(display_buffer_outputs_new);
+    }
+    timer.phase_done("set up outputs");
 
     /* Store applied configuration */
     current_display_configuration = kms_conf;
 
     if (!comp)
+    {
         /* Clear connected but unused outputs */
         clear_connected_unused_outputs();
+        timer.phase_done("clear unused outputs");
+    }
 }
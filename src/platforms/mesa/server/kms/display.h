@@ -113,6 +113,9 @@ private:
     mir::udev::Monitor monitor;
     helpers::EGLHelper shared_egl;
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers;
+    /// The configuration of the outputs each of display_buffers was created for, so that
+    /// reconfiguring can keep (and not modeset) the ones that haven't changed
+    std::vector<std::vector<DisplayConfigurationOutput>> display_buffer_outputs;
     std::shared_ptr<KMSOutputContainer> const output_container;
     mutable RealKMSDisplayConfiguration current_display_configuration;
     mutable std::atomic<bool> dirty_configuration;
@@ -24,6 +24,7 @@
 #include "gbm_buffer.h"
 #include "mir/fatal.h"
 #include "mir/log.h"
+#include "mir/report/timeline.h"
 #include "native_buffer.h"
 #include "display_helpers.h"
 #include "egl_helper.h"
@@ -47,6 +48,7 @@ namespace mg = mir::graphics;
 namespace mgm = mir::graphics::mesa;
 namespace geom = mir::geometry;
 namespace mgmh = mir::graphics::mesa::helpers;
+namespace mrt = mir::report::timeline;
 
 mgm::GBMOutputSurface::FrontBuffer::FrontBuffer()
     : surf{nullptr},
@@ -439,7 +441,11 @@ mgm::DisplayBuffer::DisplayBuffer(
       area(area),
       transform{transformation},
       needs_set_crtc{false},
-      page_flips_pending{false}
+      page_flips_pending{false},
+      // Until we've measured some frames, be pessimistic about composited
+      // frames and assume bypassed ones need only kernel flip scheduling.
+      composite_render_time{std::chrono::milliseconds{50}},
+      bypass_render_time{std::chrono::milliseconds{5}}
 {
     listener->report_successful_setup_of_native_resources();
 
@@ -525,6 +531,9 @@ void mgm::DisplayBuffer::set_transformation(glm::mat2 const& t, geometry::Rectan
 
 bool mgm::DisplayBuffer::overlay(RenderableList const& renderable_list)
 {
+    frame_start = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    frame_started = true;
+
     glm::mat2 static const no_transformation(1);
     if (transform == no_transformation &&
        (bypass_option == mgm::BypassOption::allowed))
@@ -585,6 +594,62 @@ void mgm::DisplayBuffer::set_crtc(FBHandle const& forced_frame)
     }
 }
 
+namespace
+{
+/// Beyond this many refresh intervals since an output's last flip its vblanks aren't extrapolated
+int const max_extrapolated_vblanks{4};
+
+/*
+ * Cloned outputs don't wait for the page flip in post(), so when the next
+ * frame is needed has to be predicted from each output's last flip. The
+ * frame just scheduled is shown once every output has reached a vblank, and
+ * the next frame has to be ready by the first vblank (of any output) after that.
+ */
+auto next_cloned_frame_deadline(
+    std::vector<std::shared_ptr<mgm::KMSOutput>> const& outputs,
+    mir::time::PosixTimestamp const& now) -> std::experimental::optional<mir::time::PosixTimestamp>
+{
+    struct Vblanks
+    {
+        mir::time::PosixTimestamp next;
+        std::chrono::nanoseconds interval;
+    };
+    std::vector<Vblanks> vblanks;
+
+    auto all_flipped = now;
+    for (auto const& output : outputs)
+    {
+        auto const interval = std::chrono::nanoseconds{std::chrono::seconds{1}} / std::max(output->max_refresh_rate(), 1);
+        auto const last_flip = output->last_frame().ust;
+
+        // An output that hasn't flipped recently (or at all) has no vblanks we can predict
+        if (last_flip.clock_id != now.clock_id ||
+            last_flip > now ||
+            now - last_flip > max_extrapolated_vblanks * interval)
+        {
+            return std::experimental::nullopt;
+        }
+
+        auto const next = last_flip + ((now - last_flip) / interval + 1) * interval;
+        vblanks.push_back({next, interval});
+        all_flipped = std::max(all_flipped, next);
+    }
+
+    std::experimental::optional<mir::time::PosixTimestamp> deadline;
+    for (auto const& output : vblanks)
+    {
+        auto vblank = output.next;
+        if (vblank <= all_flipped)
+            vblank = vblank + ((all_flipped - vblank) / output.interval + 1) * output.interval;
+
+        if (!deadline || vblank < deadline.value())
+            deadline = vblank;
+    }
+
+    return deadline;
+}
+}
+
 void mgm::DisplayBuffer::post()
 {
     /*
@@ -615,6 +680,10 @@ void mgm::DisplayBuffer::post()
     if (!needs_set_crtc && !schedule_page_flip(*bufobj))
         needs_set_crtc = true;
 
+    // The client buffers composited into this frame are shown when it flips
+    if (page_flips_pending)
+        scheduled_flows = mrt::the_timeline().release_held_flows();
+
     /*
      * Fallback blitting: Not pretty, since it may tear. VirtualBox seems
      * to need to do this on every frame. [will complete in this thread]
@@ -625,12 +694,18 @@ void mgm::DisplayBuffer::post()
         needs_set_crtc = false;
     }
 
-    using namespace std;  // For operator""ms()
+    auto const submitted = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    bool const bypassed = static_cast<bool>(bypass_buf);
 
-    // Predicted worst case render time for the next frame...
-    auto predicted_render_time = 50ms;
+    if (resumed_at)
+    {
+        listener->report_configuration_phase(
+            "resume to first new frame",
+            std::chrono::steady_clock::now() - resumed_at.value());
+        resumed_at = std::experimental::nullopt;
+    }
 
-    if (bypass_buf)
+    if (bypassed)
     {
         /*
          * For composited frames we defer wait_for_page_flip till just before
@@ -643,10 +718,6 @@ void mgm::DisplayBuffer::post()
          */
         scheduled_bypass_frame = bypass_buf;
         wait_for_page_flip();
-
-        // It's very likely the next frame will be bypassed like this one so
-        // we only need time for kernel page flip scheduling...
-        predicted_render_time = 5ms;
     }
     else
     {
@@ -657,27 +728,77 @@ void mgm::DisplayBuffer::post()
          */
         if (outputs.size() == 1)
             wait_for_page_flip();
-
-        /*
-         * TODO: If you're optimistic about your GPU performance and/or
-         *       measure it carefully you may wish to set predicted_render_time
-         *       to a lower value here for lower latency.
-         *
-         *predicted_render_time = 9ms; // e.g. about the same as Weston
-         */
     }
 
     // Buffer lifetimes are managed exclusively by scheduled*/visible* now
     bypass_buf = nullptr;
     bypass_bufobj = nullptr;
 
-    recommend_sleep = 0ms;
+    auto& render_time = bypassed ? bypass_render_time : composite_render_time;
+    auto const min_frame_interval =
+        std::chrono::nanoseconds{std::chrono::seconds{1}} / std::max(outputs.front()->max_refresh_rate(), 1);
+
+    if (frame_started)
+    {
+        // Time the CPU spent getting the frame to the kernel...
+        auto sample = submitted - frame_start;
+
+        /*
+         * ...and, if we've waited for the flip, any GPU time that held it
+         * beyond the first vblank after submission. (The kernel won't flip
+         * to a buffer until rendering to it has finished.)
+         */
+        if (!page_flips_pending)
+        {
+            auto const flipped = outputs.front()->last_frame().ust;
+            if (flipped.clock_id == submitted.clock_id && flipped > submitted)
+            {
+                auto const flip_latency = flipped - submitted;
+                if (flip_latency > min_frame_interval)
+                    sample += flip_latency - min_frame_interval;
+            }
+        }
+
+        render_time.record(sample);
+        frame_started = false;
+    }
+
+    // Predicted worst case render time for the next frame, assuming it is
+    // likely to be bypassed (or not) like this one...
+    auto const predicted_render_time = render_time.estimate();
+
+    /*
+     * With variable refresh the output waits for our flip rather than the
+     * other way round, so sleeping would only delay the next frame.
+     */
+    bool const variable_refresh = std::any_of(outputs.begin(), outputs.end(),
+        [](auto const& output) { return output->variable_refresh_active(); });
+
+    recommend_sleep = std::chrono::milliseconds::zero();
+    if (variable_refresh)
+        return;
+
     if (outputs.size() == 1)
     {
-        auto const& output = outputs.front();
-        auto const min_frame_interval = 1000ms / output->max_refresh_rate();
+        // We've just waited for the flip, so the next vblank is a frame away
         if (predicted_render_time < min_frame_interval)
-            recommend_sleep = min_frame_interval - predicted_render_time;
+        {
+            recommend_sleep = std::chrono::duration_cast<std::chrono::milliseconds>(
+                min_frame_interval - predicted_render_time);
+        }
+    }
+    else
+    {
+        auto const now = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+        if (auto const deadline = next_cloned_frame_deadline(outputs, now))
+        {
+            auto const available = deadline.value() - now;
+            if (predicted_render_time < available)
+            {
+                recommend_sleep = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    available - predicted_render_time);
+            }
+        }
     }
 }
 
@@ -705,10 +826,15 @@ void mgm::DisplayBuffer::wait_for_page_flip()
 {
     if (page_flips_pending)
     {
+        mrt::Span const span{"page flip"};
+
         for (auto& output : outputs)
             output->wait_for_page_flip();
 
         page_flips_pending = false;
+
+        mrt::the_timeline().end_flows(scheduled_flows);
+        scheduled_flows.clear();
     }
 
     if (scheduled_bypass_frame || scheduled_composite_frame)
@@ -744,6 +870,35 @@ void mgm::DisplayBuffer::schedule_set_crtc()
     needs_set_crtc = true;
 }
 
+void mgm::DisplayBuffer::restore_last_frame()
+{
+    resumed_at = std::chrono::steady_clock::now();
+
+    /*
+     * Everything needed to scan out the last composited frame (the GBM
+     * surface, its front buffer and the framebuffer for it) is kept across
+     * a VT switch, so we only need to point the CRTCs back at it. The last
+     * bypass buffer belongs to a client and may be gone, so in that case
+     * wait for the next frame.
+     */
+    needs_set_crtc = true;
+    if (visible_bypass_frame || !visible_composite_frame)
+        return;
+
+    if (auto const fb = outputs.front()->fb_for(visible_composite_frame))
+    {
+        bool restored{true};
+        for (auto& output : outputs)
+        {
+            if (!output->set_crtc(*fb))
+                restored = false;
+        }
+
+        // If any output failed, try again with the next frame
+        needs_set_crtc = !restored;
+    }
+}
+
 mg::NativeDisplayBuffer* mgm::DisplayBuffer::native_display_buffer()
 {
     return this;
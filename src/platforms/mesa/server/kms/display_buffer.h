@@ -25,10 +25,14 @@
 #include "display_helpers.h"
 #include "egl_helper.h"
 #include "platform_common.h"
+#include "render_time_estimator.h"
+#include "mir/time/posix_timestamp.h"
 
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <experimental/optional>
 
 namespace mir
 {
@@ -126,6 +130,13 @@ public:
     void schedule_set_crtc();
     void wait_for_page_flip();
 
+    /**
+     * Puts the last composited frame straight back on the outputs (eg: on
+     * resuming from a VT switch) rather than leaving them blank until the
+     * next frame has been composited.
+     */
+    void restore_last_frame();
+
 private:
     bool schedule_page_flip(FBHandle const& bufobj);
     void set_crtc(FBHandle const&);
@@ -155,6 +166,19 @@ private:
     std::atomic<bool> needs_set_crtc;
     std::chrono::milliseconds recommend_sleep{0};
     bool page_flips_pending;
+    std::vector<uint64_t> scheduled_flows;  ///< Timeline flows of the client buffers in the scheduled frame
+
+    /*
+     * Measured time from the start of a frame (overlay()) until it was
+     * ready to flip, used to predict how late we can start the next one.
+     */
+    RenderTimeEstimator composite_render_time;
+    RenderTimeEstimator bypass_render_time;
+    time::PosixTimestamp frame_start;
+    bool frame_started{false};
+
+    /// Set by restore_last_frame(), so the first new frame after resuming can be timed
+    std::experimental::optional<std::chrono::steady_clock::time_point> resumed_at;
 };
 
 }
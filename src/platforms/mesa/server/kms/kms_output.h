@@ -76,6 +76,21 @@ public:
 
     virtual void set_power_mode(MirPowerMode mode) = 0;
     virtual void set_gamma(GammaCurves const& gamma) = 0;
+
+    /**
+     * Request variable refresh (VRR_ENABLED) on this output's CRTC, if the
+     * hardware supports it.
+     *
+     * The request is remembered and (re)applied whenever the output gets a CRTC.
+     */
+    virtual void set_variable_refresh(bool enabled) = 0;
+
+    /**
+     * Whether the output is currently refreshing when frames are flipped
+     * rather than at fixed intervals.
+     */
+    virtual bool variable_refresh_active() const = 0;
+
     virtual Frame last_frame() const = 0;
 
     /**
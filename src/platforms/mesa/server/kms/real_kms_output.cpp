@@ -183,6 +183,7 @@ bool mgm::RealKMSOutput::set_crtc(FBHandle const& fb)
     }
 
     using_saved_crtc = false;
+    apply_variable_refresh();
     return true;
 }
 
@@ -398,6 +399,56 @@ void mgm::RealKMSOutput::set_gamma(mg::GammaCurves const& gamma)
     // TODO: return bool in future? Then do what with it?
 }
 
+void mgm::RealKMSOutput::set_variable_refresh(bool enabled)
+{
+    variable_refresh_requested = enabled;
+
+    if (current_crtc)
+        apply_variable_refresh();
+}
+
+bool mgm::RealKMSOutput::variable_refresh_active() const
+{
+    return variable_refresh_active_;
+}
+
+void mgm::RealKMSOutput::apply_variable_refresh()
+{
+    mgk::ObjectProperties const crtc_props{drm_fd_, current_crtc->crtc_id, DRM_MODE_OBJECT_CRTC};
+
+    if (!crtc_props.has_property("VRR_ENABLED"))
+    {
+        variable_refresh_active_ = false;
+        return;
+    }
+
+    if ((crtc_props["VRR_ENABLED"] != 0) == variable_refresh_requested)
+    {
+        variable_refresh_active_ = variable_refresh_requested;
+        return;
+    }
+
+    auto const ret = drmModeObjectSetProperty(
+        drm_fd_,
+        current_crtc->crtc_id,
+        DRM_MODE_OBJECT_CRTC,
+        crtc_props.id_for("VRR_ENABLED"),
+        variable_refresh_requested ? 1 : 0);
+
+    if (ret)
+    {
+        mir::log_warning(
+            "Failed to %s variable refresh on output %s: %s",
+            variable_refresh_requested ? "enable" : "disable",
+            mgk::connector_name(connector).c_str(),
+            strerror(-ret));
+        variable_refresh_active_ = false;
+        return;
+    }
+
+    variable_refresh_active_ = variable_refresh_requested;
+}
+
 void mgm::RealKMSOutput::refresh_hardware_state()
 {
     connector = kms::get_connector(drm_fd_, connector->connector_id);
@@ -623,6 +674,13 @@ void mgm::RealKMSOutput::update_from_hardware_state(
     output.subpixel_arrangement = kms_subpixel_to_mir_subpixel(connector->subpixel);
     output.gamma = gamma;
     output.edid = edid;
+
+    mgk::ObjectProperties const connector_props{
+        drm_fd_, connector->connector_id, DRM_MODE_OBJECT_CONNECTOR};
+    output.vrr_capable =
+        connected &&
+        connector_props.has_property("vrr_capable") &&
+        connector_props["vrr_capable"] != 0;
 }
 
 mgm::FBHandle* mgm::RealKMSOutput::fb_for(gbm_bo* bo) const
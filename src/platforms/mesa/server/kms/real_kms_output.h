@@ -23,6 +23,7 @@
 #include "kms_output.h"
 #include "kms-utils/drm_mode_resources.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -63,6 +64,8 @@ public:
 
     void set_power_mode(MirPowerMode mode) override;
     void set_gamma(GammaCurves const& gamma) override;
+    void set_variable_refresh(bool enabled) override;
+    bool variable_refresh_active() const override;
 
     Frame last_frame() const override;
 
@@ -76,6 +79,7 @@ public:
 private:
     bool ensure_crtc();
     void restore_saved_crtc();
+    void apply_variable_refresh();
 
     int const drm_fd_;
     std::shared_ptr<PageFlipper> const page_flipper;
@@ -93,6 +97,9 @@ private:
 
     std::mutex power_mutex;
 
+    bool variable_refresh_requested{false};
+    std::atomic<bool> variable_refresh_active_{false};
+
     AtomicFrame last_frame_;
 };
 
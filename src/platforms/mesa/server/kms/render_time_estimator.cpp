@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render_time_estimator.h"
+
+#include <algorithm>
+
+namespace mgm = mir::graphics::mesa;
+
+namespace
+{
+// Frames slower than this percentile of recent ones will miss their vblank
+int const percentile = 95;
+
+// Allowance for the compositor thread oversleeping or being scheduled late
+std::chrono::nanoseconds const scheduling_margin = std::chrono::milliseconds{2};
+}
+
+mgm::RenderTimeEstimator::RenderTimeEstimator(std::chrono::nanoseconds initial_estimate)
+    : initial_estimate{initial_estimate}
+{
+}
+
+void mgm::RenderTimeEstimator::record(std::chrono::nanoseconds render_time)
+{
+    samples[next_sample] = std::max(render_time, std::chrono::nanoseconds::zero());
+    next_sample = (next_sample + 1) % window_size;
+    sample_count = std::min(sample_count + 1, window_size);
+}
+
+std::chrono::nanoseconds mgm::RenderTimeEstimator::estimate() const
+{
+    if (sample_count < min_samples)
+        return initial_estimate;
+
+    auto recent = samples;
+    auto const end = recent.begin() + sample_count;
+    auto const nth = recent.begin() + (sample_count - 1) * percentile / 100;
+    std::nth_element(recent.begin(), nth, end);
+
+    return *nth + scheduling_margin;
+}
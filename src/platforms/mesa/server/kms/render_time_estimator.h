@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_MESA_RENDER_TIME_ESTIMATOR_H_
+#define MIR_GRAPHICS_MESA_RENDER_TIME_ESTIMATOR_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace mir
+{
+namespace graphics
+{
+namespace mesa
+{
+
+/**
+ * Predicts how long the next frame will take to get from the start of
+ * compositing to a page flip, from a rolling window of measured frames.
+ *
+ * The prediction is a high percentile of recent frames plus a margin for
+ * scheduling jitter. Until enough frames have been measured it is the
+ * (conservative) initial estimate.
+ */
+class RenderTimeEstimator
+{
+public:
+    explicit RenderTimeEstimator(std::chrono::nanoseconds initial_estimate);
+
+    void record(std::chrono::nanoseconds render_time);
+    std::chrono::nanoseconds estimate() const;
+
+    static size_t const window_size = 64;
+    static size_t const min_samples = 8;
+
+private:
+    std::chrono::nanoseconds const initial_estimate;
+    std::array<std::chrono::nanoseconds, window_size> samples;
+    size_t sample_count{0};
+    size_t next_sample{0};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_MESA_RENDER_TIME_ESTIMATOR_H_ */
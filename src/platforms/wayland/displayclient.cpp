@@ -16,11 +16,16 @@
  */
 
 #include "displayclient.h"
+#include "passthrough.h"
 #include "mir/graphics/egl_error.h"
 #include <mir/graphics/pixel_format_utils.h>
+#include <mir/graphics/renderable.h>
+#include <mir/renderer/sw/pixel_source.h>
+#include <mir/anonymous_shm_file.h>
 
 #include <wayland-client.h>
 #include <wayland-egl.h>
+#include MIR_SERVER_GL_H
 
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -32,8 +37,152 @@
 #include <stdlib.h>
 #include <system_error>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace mgw = mir::graphics::wayland;
+namespace geom = mir::geometry;
+
+namespace
+{
+/// Events from the host (dispatched on the Wayland thread) that the compositor waits for
+struct HostEvents
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+// The host needn't send frame events while we're hidden, so don't wait longer than this
+std::chrono::milliseconds const host_frame_timeout{100};
+
+/// A host wl_shm buffer that a client's pixels are copied into, so that the
+/// host can composite them directly
+class HostShmBuffer
+{
+public:
+    HostShmBuffer(HostEvents& events, wl_shm* shm, geom::Size size, geom::Stride stride, uint32_t format) :
+        events{events},
+        size{size},
+        stride{stride},
+        format{format},
+        shm_file{static_cast<size_t>(stride.as_int() * size.height.as_int())}
+    {
+        auto const pool = wl_shm_create_pool(shm, shm_file.fd(), stride.as_int() * size.height.as_int());
+        buffer = wl_shm_pool_create_buffer(
+            pool, 0, size.width.as_int(), size.height.as_int(), stride.as_int(), format);
+        wl_shm_pool_destroy(pool);
+
+        static wl_buffer_listener const listener{
+            [](void* data, wl_buffer*) { static_cast<HostShmBuffer*>(data)->released(); }
+        };
+        wl_buffer_add_listener(buffer, &listener, this);
+    }
+
+    ~HostShmBuffer()
+    {
+        wl_buffer_destroy(buffer);
+    }
+
+    HostShmBuffer(HostShmBuffer const&) = delete;
+    HostShmBuffer& operator=(HostShmBuffer const&) = delete;
+
+    bool matches(geom::Size size, geom::Stride stride, uint32_t format) const
+    {
+        return this->size == size && this->stride == stride && this->format == format;
+    }
+
+    void released()
+    {
+        {
+            std::lock_guard<std::mutex> lock{events.mutex};
+            busy = false;
+        }
+        events.changed.notify_all();
+    }
+
+    HostEvents& events;
+    geom::Size const size;
+    geom::Stride const stride;
+    uint32_t const format;
+    mir::AnonymousShmFile shm_file;
+    wl_buffer* buffer;
+
+    /// Set while the host may be reading from the buffer
+    std::atomic<bool> busy{false};
+};
+
+/// A host subsurface of an output, used to show one client buffer
+struct Plane
+{
+    Plane(wl_compositor* compositor, wl_subcompositor* subcompositor, wl_surface* parent) :
+        surface{wl_compositor_create_surface(compositor)},
+        subsurface{wl_subcompositor_get_subsurface(subcompositor, surface, parent)}
+    {
+        // Input goes to the parent (which is what the rest of DisplayClient expects)
+        auto const empty_region = wl_compositor_create_region(compositor);
+        wl_surface_set_input_region(surface, empty_region);
+        wl_region_destroy(empty_region);
+    }
+
+    ~Plane()
+    {
+        buffers.clear();
+        wl_subsurface_destroy(subsurface);
+        wl_surface_destroy(surface);
+    }
+
+    Plane(Plane const&) = delete;
+    Plane& operator=(Plane const&) = delete;
+
+    /// A buffer the host isn't using, or nullptr if they're all in use
+    auto free_buffer(HostEvents& events, wl_shm* shm, geom::Size size, geom::Stride stride, uint32_t format) -> HostShmBuffer*
+    {
+        // Buffers for a different size of client are no longer any use
+        buffers.erase(
+            std::remove_if(begin(buffers), end(buffers),
+                [&](auto const& b) { return !b->busy && !b->matches(size, stride, format); }),
+            end(buffers));
+
+        for (auto const& b : buffers)
+        {
+            if (!b->busy && b->matches(size, stride, format))
+                return b.get();
+        }
+
+        if (buffers.size() < max_buffers)
+        {
+            buffers.push_back(std::make_unique<HostShmBuffer>(events, shm, size, stride, format));
+            return buffers.back().get();
+        }
+
+        return nullptr;
+    }
+
+    static size_t const max_buffers = 3;
+
+    wl_surface* const surface;
+    wl_subsurface* const subsurface;
+    std::vector<std::unique_ptr<HostShmBuffer>> buffers;
+    bool visible{false};
+};
+
+auto shm_format_for(MirPixelFormat format) -> uint32_t
+{
+    switch (format)
+    {
+    case mir_pixel_format_argb_8888:
+        return WL_SHM_FORMAT_ARGB8888;
+
+    case mir_pixel_format_xrgb_8888:
+        return WL_SHM_FORMAT_XRGB8888;
+
+    default:
+        return 0;
+    }
+}
+}
 
 class mgw::DisplayClient::Output  :
     public DisplaySyncGroup,
@@ -92,6 +241,22 @@ public:
     EGLContext eglctx{EGL_NO_CONTEXT};
     EGLSurface eglsurface{EGL_NO_SURFACE};
 
+    /*
+     * Client buffers forwarded to the host as subsurfaces (bottom first).
+     * While passthrough is set the (black) EGL surface is only a backdrop.
+     */
+    HostEvents host_events;
+    std::vector<std::unique_ptr<Plane>> planes;
+    bool passthrough{false};
+    bool needs_commit{false};
+
+    /// The frame callback of our last passthrough commit (guarded by host_events.mutex)
+    wl_callback* frame_callback{nullptr};
+
+    static wl_callback_listener const frame_listener;
+
+    void hide_planes(size_t from);
+
     std::function<void(Output const&)> on_done;
 
     // DisplaySyncGroup implementation
@@ -242,6 +407,14 @@ mgw::DisplayClient::Output::Output(
 
 mgw::DisplayClient::Output::~Output()
 {
+    {
+        std::lock_guard<std::mutex> lock{host_events.mutex};
+        if (frame_callback)
+            wl_callback_destroy(frame_callback);
+    }
+
+    planes.clear();
+
     if (output)
         wl_output_destroy(output);
 
@@ -297,8 +470,40 @@ void mgw::DisplayClient::Output::for_each_display_buffer(std::function<void(Disp
     f(*this);
 }
 
+wl_callback_listener const mgw::DisplayClient::Output::frame_listener = {
+    [](void* data, wl_callback* callback, uint32_t /*time*/)
+    {
+        auto const output = static_cast<Output*>(data);
+        {
+            std::lock_guard<std::mutex> lock{output->host_events.mutex};
+            wl_callback_destroy(callback);
+            output->frame_callback = nullptr;
+        }
+        output->host_events.changed.notify_all();
+    }
+};
+
 void mgw::DisplayClient::Output::post()
 {
+    if (needs_commit)
+    {
+        {
+            // Nothing else paces passthrough frames (as eglSwapBuffers() does for GL)
+            std::unique_lock<std::mutex> lock{host_events.mutex};
+            host_events.changed.wait_for(lock, host_frame_timeout, [this] { return !frame_callback; });
+
+            if (frame_callback)
+                wl_callback_destroy(frame_callback);
+
+            frame_callback = wl_surface_frame(surface);
+            wl_callback_add_listener(frame_callback, &frame_listener, this);
+        }
+
+        // Applies the (synchronized) subsurface state set up in overlay()
+        wl_surface_commit(surface);
+        wl_display_flush(owner->display);
+        needs_commit = false;
+    }
 }
 
 auto mgw::DisplayClient::Output::recommended_sleep() const -> std::chrono::milliseconds
@@ -311,9 +516,111 @@ auto mgw::DisplayClient::Output::view_area() const -> geometry::Rectangle
     return dcout.extents();
 }
 
-bool mgw::DisplayClient::Output::overlay(mir::graphics::RenderableList const&)
+bool mgw::DisplayClient::Output::overlay(mir::graphics::RenderableList const& renderlist)
 {
-    return false;
+    auto const fall_back_to_gl = [this]
+        {
+            if (passthrough)
+            {
+                // Hidden when the next eglSwapBuffers() commits the parent
+                hide_planes(0);
+                passthrough = false;
+            }
+            return false;
+        };
+
+    if (!owner->subcompositor || !owner->shm)
+        return fall_back_to_gl();
+
+    auto const candidates = passthrough_planes(renderlist, view_area(), dcout.scale);
+
+    if (candidates.empty())
+        return fall_back_to_gl();
+
+    while (planes.size() < candidates.size())
+        planes.push_back(std::make_unique<Plane>(owner->compositor, owner->subcompositor, surface));
+
+    // Don't touch any plane until we know all of them can be updated
+    std::vector<HostShmBuffer*> host_buffers(candidates.size(), nullptr);
+    for (auto i = 0u; i != candidates.size(); ++i)
+    {
+        auto const& candidate = candidates[i];
+        auto& host_buffer = host_buffers[i];
+        auto const get_free_buffer = [&]
+            {
+                host_buffer = planes[i]->free_buffer(
+                    host_events,
+                    owner->shm,
+                    candidate.buffer->size(),
+                    candidate.pixels->stride(),
+                    shm_format_for(candidate.buffer->pixel_format()));
+                return host_buffer != nullptr;
+            };
+
+        if (!get_free_buffer())
+        {
+            // The host is still showing earlier frames, but will release one once it shows the last.
+            // (Dropping to GL here would just flip between GL and passthrough every frame.)
+            std::unique_lock<std::mutex> lock{host_events.mutex};
+            if (!host_events.changed.wait_for(lock, host_frame_timeout, get_free_buffer))
+                return fall_back_to_gl();
+        }
+    }
+
+    if (!passthrough)
+    {
+        // The EGL surface is now only a backdrop for the planes
+        make_current();
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        swap_buffers();
+        passthrough = true;
+    }
+
+    wl_surface* below = surface;
+    for (auto i = 0u; i != candidates.size(); ++i)
+    {
+        auto const& candidate = candidates[i];
+        auto const& plane = *planes[i];
+        auto const host_buffer = host_buffers[i];
+
+        candidate.pixels->read([host_buffer](unsigned char const* pixels)
+            {
+                memcpy(
+                    host_buffer->shm_file.base_ptr(),
+                    pixels,
+                    host_buffer->stride.as_int() * host_buffer->size.height.as_int());
+            });
+
+        host_buffer->busy = true;
+        wl_surface_attach(plane.surface, host_buffer->buffer, 0, 0);
+        wl_surface_damage(plane.surface, 0, 0, host_buffer->size.width.as_int(), host_buffer->size.height.as_int());
+        wl_subsurface_set_position(plane.subsurface, candidate.position.x.as_int(), candidate.position.y.as_int());
+        wl_subsurface_place_above(plane.subsurface, below);
+        wl_surface_commit(plane.surface);
+
+        planes[i]->visible = true;
+        below = plane.surface;
+    }
+
+    hide_planes(candidates.size());
+    needs_commit = true;
+
+    return true;
+}
+
+void mgw::DisplayClient::Output::hide_planes(size_t from)
+{
+    for (auto i = from; i < planes.size(); ++i)
+    {
+        auto& plane = *planes[i];
+        if (plane.visible)
+        {
+            wl_surface_attach(plane.surface, nullptr, 0, 0);
+            wl_surface_commit(plane.surface);
+            plane.visible = false;
+        }
+    }
 }
 
 auto mgw::DisplayClient::Output::transformation() const -> glm::mat2
@@ -479,6 +786,11 @@ void mgw::DisplayClient::new_global(
                     [self](Output const& output) { self->on_new_output(&output); },
                     [self](Output const& output) { self->on_output_changed(&output); })));
     }
+    else if (strcmp(interface, "wl_subcompositor") == 0)
+    {
+        self->subcompositor = static_cast<decltype(self->subcompositor)>(
+            wl_registry_bind(registry, id, &wl_subcompositor_interface, std::min(version, 1u)));
+    }
     else if (strcmp(interface, "wl_shell") == 0)
     {
         self->shell = static_cast<decltype(self->shell)>(wl_registry_bind(registry, id, &wl_shell_interface, std::min(version, 1u)));
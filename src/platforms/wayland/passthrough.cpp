@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "passthrough.h"
+
+#include <mir/graphics/buffer.h>
+#include <mir/renderer/sw/pixel_source.h>
+
+namespace mgw = mir::graphics::wayland;
+namespace geom = mir::geometry;
+
+namespace
+{
+// The formats wl_shm is required to support
+bool host_can_show(MirPixelFormat format)
+{
+    return format == mir_pixel_format_argb_8888 || format == mir_pixel_format_xrgb_8888;
+}
+}
+
+auto mgw::passthrough_planes(RenderableList const& renderlist, geom::Rectangle const& area, float scale)
+    -> std::vector<PassthroughPlane>
+{
+    if (scale != 1.0f || renderlist.empty() || renderlist.size() > max_passthrough_planes)
+        return {};
+
+    std::vector<PassthroughPlane> planes;
+    planes.reserve(renderlist.size());
+
+    glm::mat4 const identity{1};
+    for (auto const& renderable : renderlist)
+    {
+        auto buffer = renderable->buffer();
+        auto const pixels = dynamic_cast<renderer::software::PixelSource*>(buffer.get());
+        auto const position = renderable->screen_position();
+        auto const clip = renderable->clip_area();
+
+        // Anything the host can't show exactly as we would needs GL
+        if (!pixels || !host_can_show(buffer->pixel_format()) ||
+            renderable->alpha() != 1.0f ||
+            renderable->transformation() != identity ||
+            position.size != buffer->size() ||
+            !area.contains(position) ||
+            (clip && !clip.value().contains(position)))
+        {
+            return {};
+        }
+
+        planes.push_back({std::move(buffer), pixels, position.top_left - as_displacement(area.top_left)});
+    }
+
+    return planes;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_PLATFORM_WAYLAND_PASSTHROUGH_H_
+#define MIR_PLATFORM_WAYLAND_PASSTHROUGH_H_
+
+#include <mir/graphics/renderable.h>
+#include <mir/geometry/rectangle.h>
+#include <mir/geometry/displacement.h>
+
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace renderer { namespace software { class PixelSource; } }
+namespace graphics
+{
+class Buffer;
+
+namespace wayland
+{
+/// A client buffer that the host can show, unmodified, on a subsurface
+struct PassthroughPlane
+{
+    std::shared_ptr<Buffer> buffer;
+    renderer::software::PixelSource* pixels;
+    geometry::Point position;   ///< Relative to the output
+};
+
+// Beyond this it's cheaper for the host if we composite
+size_t const max_passthrough_planes = 8;
+
+/// The renderables as planes (bottom first), or none if they need compositing with GL
+auto passthrough_planes(RenderableList const& renderlist, geometry::Rectangle const& area, float scale)
+    -> std::vector<PassthroughPlane>;
+}
+}
+}
+
+#endif  // MIR_PLATFORM_WAYLAND_PASSTHROUGH_H_
@@ -28,14 +28,18 @@
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/graphics/transformation.h"
 #include "mir/compositor/display_buffer_compositor.h"
+#include "mir/scene/legacy_scene_change_notification.h"
 #include "mir/geometry/rectangles.h"
 #include "mir/raii.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
+
 namespace mc = mir::compositor;
 namespace mf = mir::frontend;
 namespace mg = mir::graphics;
+namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
 namespace
@@ -82,17 +86,28 @@ public:
       display_buffer_compositor{db_compositor_factory.create_compositor_for(*display_buffer)},
       virtual_output{make_virtual_output(display, capture_region)},
       queue_size(capture_size),
-      mirror_mode(mirror_mode)
+      mirror_mode(mirror_mode),
+      capture_region{capture_region},
+      damaged{true},
+      damage_observer{std::make_shared<ms::LegacySceneChangeNotification>(
+          [this] { damaged = true; },
+          [this](int, geom::Rectangle const& damage)
+          {
+              if (this->capture_region.overlaps(damage))
+                  damaged = true;
+          })}
     {
         for (auto buffer : buffers)
             free_queue.schedule(buffer);
 
         scene->register_compositor(this);
+        scene->add_observer(damage_observer);
         if (virtual_output)
             virtual_output->enable();
     }
     ~ScreencastSessionContext()
     {
+        scene->remove_observer(damage_observer);
         scene->unregister_compositor(this);
     }
 
@@ -102,11 +117,16 @@ public:
         if (queue_size != display_buffer->renderbuffer_size())
             display_buffer->set_renderbuffer_size(queue_size);
 
+        // Nothing in the capture region has changed: the last capture is still current
+        if (last_captured_buffer && !damaged)
+            return last_captured_buffer;
+
         //FIXME:: the client needs a better way to express it is no longer
         //using the last captured buffer
         if (last_captured_buffer)
             free_queue.schedule(last_captured_buffer);
 
+        damaged = false;
         display_buffer_compositor->composite(scene->scene_elements_for(this));
 
         last_captured_buffer = ready_queue.next_buffer();
@@ -116,6 +136,11 @@ public:
     void capture(std::shared_ptr<mg::Buffer> const& buffer)
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
+
+        // The client is asking us to refill the buffer we last filled, and it's still current
+        if (buffer == last_filled_buffer.lock() && !damaged)
+            return;
+
         if (buffer->size() != display_buffer->renderbuffer_size())
             display_buffer->set_renderbuffer_size(buffer->size());
        
@@ -138,12 +163,15 @@ public:
         for(auto i = 0u; i < scheduled; i++)
             free_queue.schedule(free_queue.next_buffer());
 
+        damaged = false;
+        last_filled_buffer.reset();
         display_buffer_compositor->composite(scene->scene_elements_for(this));
         if (buffer != ready_queue.next_buffer())
             throw std::runtime_error("unable to capture to buffer");
 
         display_buffer->set_transformation(mg::transformation(mirror_mode));
         display_buffer->commit();
+        last_filled_buffer = buffer;
     }
 
 private:
@@ -156,8 +184,14 @@ private:
     std::unique_ptr<compositor::DisplayBufferCompositor> display_buffer_compositor;
     std::unique_ptr<graphics::VirtualOutput> virtual_output;
     std::shared_ptr<mg::Buffer> last_captured_buffer;
+    std::weak_ptr<mg::Buffer> last_filled_buffer;
     geom::Size queue_size;
     MirMirrorMode mirror_mode;
+
+    geom::Rectangle const capture_region;
+    // Set by the scene when anything that could show up in the capture changes
+    std::atomic<bool> damaged;
+    std::shared_ptr<ms::LegacySceneChangeNotification> const damage_observer;
 };
 
 
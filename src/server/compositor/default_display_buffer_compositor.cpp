@@ -26,6 +26,7 @@
 #include "mir/graphics/buffer.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/renderer/renderer.h"
+#include "mir/report/timeline.h"
 #include "occlusion.h"
 #include <mutex>
 #include <cstdlib>
@@ -33,6 +34,7 @@
 
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
+namespace mrt = mir::report::timeline;
 
 mc::DefaultDisplayBufferCompositor::DefaultDisplayBufferCompositor(
     mg::DisplayBuffer& display_buffer,
@@ -46,6 +48,7 @@ mc::DefaultDisplayBufferCompositor::DefaultDisplayBufferCompositor(
 
 void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& scene_elements)
 {
+    mrt::Span const span{"composite"};
     report->began_frame(this);
 
     auto const& view_area = display_buffer.view_area();
@@ -72,6 +75,18 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
      */
     scene_elements.clear();  // Those in use are still in renderable_list
 
+    // Link each client commit to the page flip that shows it
+    auto& timeline = mrt::the_timeline();
+    if (timeline.is_recording())
+    {
+        for (auto const& renderable : renderable_list)
+        {
+            auto const id = renderable->buffer()->id().as_value();
+            timeline.flow(mrt::FlowPhase::step, id);
+            timeline.hold_flow(id);
+        }
+    }
+
     if (display_buffer.overlay(renderable_list))
     {
         report->renderables_in_frame(this, renderable_list);
@@ -81,7 +96,10 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
     {
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
-        renderer->render(renderable_list);
+        {
+            mrt::Span const span{"render"};
+            renderer->render(renderable_list);
+        }
 
         report->renderables_in_frame(this, renderable_list);
         report->rendered_frame(this);
@@ -31,6 +31,7 @@
 #include "mir/raii.h"
 #include "mir/unwind_helpers.h"
 #include "mir/thread_name.h"
+#include "mir/report/timeline.h"
 
 #include <thread>
 #include <chrono>
@@ -42,6 +43,7 @@ using namespace std::literals::chrono_literals;
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
+namespace mrt = mir::report::timeline;
 
 namespace mir
 {
@@ -138,9 +140,21 @@ public:
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
-                        compositor->composite(scene->scene_elements_for(compositor.get()));
+                        SceneElementSequence elements;
+                        {
+                            mrt::Span const span{"scene snapshot"};
+                            elements = scene->scene_elements_for(compositor.get());
+                        }
+                        compositor->composite(std::move(elements));
+                    }
+                    {
+                        mrt::Span const span{"swap"};
+                        group.post();
+
+                        // Platforms that trace page flips have taken the flows of the frames they flipped
+                        auto& timeline = mrt::the_timeline();
+                        timeline.end_flows(timeline.release_held_flows());
                     }
-                    group.post();
 
                     /*
                      * "Predictive bypass" optimization: If the last frame was
@@ -148,6 +162,10 @@ public:
                      * beneficial to sleep for most of the next frame. This reduces
                      * the latency between snapshotting the scene and post()
                      * completing by almost a whole frame.
+                     *
+                     * Outputs with variable refresh active recommend no sleep:
+                     * they refresh when we flip, so we composite as soon as
+                     * a client has a frame ready.
                      */
                     auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
                                  force_sleep : group.recommended_sleep();
@@ -21,6 +21,7 @@
 #include "queueing_schedule.h"
 #include "dropping_schedule.h"
 #include "mir/graphics/buffer.h"
+#include "mir/report/timeline.h"
 #include <boost/throw_exception.hpp>
 
 namespace mc = mir::compositor;
@@ -28,6 +29,7 @@ namespace geom = mir::geometry;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
+namespace mrt = mir::report::timeline;
 
 enum class mc::Stream::ScheduleMode {
     Queueing,
@@ -53,6 +55,9 @@ void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
+    mrt::Span const span{"client commit"};
+    mrt::the_timeline().flow(mrt::FlowPhase::begin, buffer->id().as_value());
+
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
         first_frame_posted = true;
@@ -87,6 +92,7 @@ void mc::Stream::set_frame_posted_callback(
 
 std::shared_ptr<mg::Buffer> mc::Stream::lock_compositor_buffer(void const* id)
 {
+    mrt::Span const span{"buffer acquire"};
     return arbiter->compositor_acquire(id);
 }
 
@@ -28,6 +28,7 @@
 #include "mir/frontend/wayland.h"
 
 #include "mir/logging/dumb_console_logger.h"
+#include "mir/logging/async_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
 #include "mir/frontend/session_authorizer.h"
@@ -226,9 +227,14 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
-            return std::make_shared<ml::DumbConsoleLogger>();
+            auto const console_logger = std::make_shared<ml::DumbConsoleLogger>();
+
+            if (the_options()->is_set(options::async_logging_opt))
+                return std::make_shared<ml::AsyncLogger>(console_logger);
+
+            return console_logger;
         });
 }
 
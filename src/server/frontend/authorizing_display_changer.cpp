@@ -124,3 +124,9 @@ mf::AuthorizingDisplayChanger::cancel_base_configuration_preview(std::shared_ptr
     // has already been authorised to change configuration.
     changer->cancel_base_configuration_preview(session);
 }
+
+mg::Frame mf::AuthorizingDisplayChanger::last_frame_on(unsigned output_id) const
+{
+    // Frame timing is not privileged: any client may sync to the display
+    return changer->last_frame_on(output_id);
+}
@@ -62,6 +62,7 @@ public:
         std::shared_ptr<graphics::DisplayConfiguration> const&) override;
     void cancel_base_configuration_preview(
         std::shared_ptr<scene::Session> const& session) override;
+    graphics::Frame last_frame_on(unsigned output_id) const override;
 
 private:
     std::shared_ptr<frontend::DisplayChanger> const changer;
@@ -83,7 +83,7 @@ public:
         std::shared_ptr<mg::DisplayConfiguration const> const& config) override
     {
         if (session == this->session->session_)
-            this->session->send_display_config(*config);
+            this->session->send_display_config(config);
     }
 
 private:
@@ -206,9 +206,9 @@ void mf::BasicMirClientSession::destroy_buffer_stream(BufferStreamId id)
     session_->destroy_buffer_stream(stream);
 }
 
-void mf::BasicMirClientSession::send_display_config(mg::DisplayConfiguration const& info)
+void mf::BasicMirClientSession::send_display_config(std::shared_ptr<mg::DisplayConfiguration const> const& info)
 {
-    output_cache.update_from(info);
+    output_cache.update_from(*info);
 
     event_sink->handle_display_config_change(info);
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "display_configuration_message_cache.h"
+#include "protobuf_buffer_packer.h"
+
+#include "mir/graphics/display_configuration.h"
+
+#include "mir_protobuf_wire.pb.h"
+#include "mir_protobuf.pb.h"
+
+namespace mg = mir::graphics;
+namespace mfd = mir::frontend::detail;
+namespace mp = mir::protobuf;
+
+namespace
+{
+auto serialize(mg::DisplayConfiguration const& config) -> std::shared_ptr<mfd::DisplayConfigurationMessageCache::Message const>
+{
+    mp::EventSequence seq;
+    mfd::pack_protobuf_display_configuration(*seq.mutable_display_configuration(), config);
+
+    mp::wire::Result result;
+    seq.SerializeToString(result.add_events());
+
+#if GOOGLE_PROTOBUF_VERSION >= 3010000
+    auto const size = result.ByteSizeLong();
+#else
+    auto const size = result.ByteSize();
+#endif
+    auto message = std::make_shared<mfd::DisplayConfigurationMessageCache::Message>(size);
+    result.SerializeWithCachedSizesToArray(message->data());
+
+    return message;
+}
+
+bool same_object(std::weak_ptr<mg::DisplayConfiguration const> const& lhs, std::shared_ptr<mg::DisplayConfiguration const> const& rhs)
+{
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+}
+}
+
+mfd::DisplayConfigurationMessageCache::DisplayConfigurationMessageCache() = default;
+mfd::DisplayConfigurationMessageCache::~DisplayConfigurationMessageCache() = default;
+
+auto mfd::DisplayConfigurationMessageCache::message_for(
+    std::shared_ptr<mg::DisplayConfiguration const> const& config) -> std::shared_ptr<Message const>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (cached_message && same_object(cached_config, config) && *cached_snapshot == *config)
+        return cached_message;
+
+    cached_message = serialize(*config);
+    cached_config = config;
+    cached_snapshot = config->clone();
+
+    return cached_message;
+}
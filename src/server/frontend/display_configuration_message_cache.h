@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_DISPLAY_CONFIGURATION_MESSAGE_CACHE_H_
+#define MIR_FRONTEND_DISPLAY_CONFIGURATION_MESSAGE_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+class DisplayConfiguration;
+}
+namespace frontend
+{
+namespace detail
+{
+/// Serialized display configuration events, shared between connections.
+///
+/// A configuration change is broadcast to every client as the same
+/// DisplayConfiguration object, so we pack and serialize it once and send
+/// every client the same bytes.
+class DisplayConfigurationMessageCache
+{
+public:
+    /// A wire::Result carrying a single EventSequence, ready to send
+    using Message = std::vector<uint8_t>;
+
+    DisplayConfigurationMessageCache();
+    ~DisplayConfigurationMessageCache();
+
+    std::shared_ptr<Message const> message_for(
+        std::shared_ptr<graphics::DisplayConfiguration const> const& config);
+
+private:
+    std::mutex mutex;
+    std::weak_ptr<graphics::DisplayConfiguration const> cached_config;
+    // Guards against the (shared, but not immutable) configuration being modified in place
+    std::unique_ptr<graphics::DisplayConfiguration const> cached_snapshot;
+    std::shared_ptr<Message const> cached_message;
+};
+}
+}
+}
+
+#endif /* MIR_FRONTEND_DISPLAY_CONFIGURATION_MESSAGE_CACHE_H_ */
@@ -29,6 +29,7 @@
 #include "mir/input/mir_keyboard_config.h"
 #include "message_sender.h"
 #include "protobuf_buffer_packer.h"
+#include "display_configuration_message_cache.h"
 
 #include "mir/graphics/buffer.h"
 #include "mir/client_visible_error.h"
@@ -44,9 +45,11 @@ namespace mi = mir::input;
 
 mfd::EventSender::EventSender(
     std::shared_ptr<MessageSender> const& socket_sender,
-    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer) :
+    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer,
+    std::shared_ptr<DisplayConfigurationMessageCache> const& display_config_cache) :
     sender(socket_sender),
-    buffer_packer(buffer_packer)
+    buffer_packer(buffer_packer),
+    display_config_cache(display_config_cache)
 {
 }
 
@@ -62,14 +65,12 @@ void mfd::EventSender::handle_event(EventUPtr&& event)
 }
 
 void mfd::EventSender::handle_display_config_change(
-    graphics::DisplayConfiguration const& display_config)
+    std::shared_ptr<graphics::DisplayConfiguration const> const& display_config)
 {
-    mp::EventSequence seq;
-
-    auto protobuf_config = seq.mutable_display_configuration();
-    mfd::pack_protobuf_display_configuration(*protobuf_config, display_config);
+    // Every client gets the same configuration, so share the work of serializing it
+    auto const message = display_config_cache->message_for(display_config);
 
-    send_event_sequence(seq, {});
+    send(reinterpret_cast<char const*>(message->data()), message->size(), {});
 }
 
 void mfd::EventSender::handle_lifecycle_event(
@@ -121,9 +122,14 @@ void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, FdSets const&
 #endif
     result.SerializeWithCachedSizesToArray(send_buffer.data());
 
+    send(reinterpret_cast<char*>(send_buffer.data()), send_buffer.size(), fds);
+}
+
+void mfd::EventSender::send(char const* data, size_t length, FdSets const& fds)
+{
     try
     {
-        sender->send(reinterpret_cast<char*>(send_buffer.data()), send_buffer.size(), fds);
+        sender->send(data, length, fds);
     }
     catch (std::exception const& error)
     {
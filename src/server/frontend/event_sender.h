@@ -37,15 +37,18 @@ class MessageSender;
 namespace detail
 {
 
+class DisplayConfigurationMessageCache;
+
 class EventSender : public  mir::frontend::EventSink
 {
 public:
     explicit EventSender(
         std::shared_ptr<MessageSender> const& socket_sender,
-        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer);
+        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer,
+        std::shared_ptr<DisplayConfigurationMessageCache> const& display_config_cache);
     void handle_event(EventUPtr&& event) override;
     void handle_lifecycle_event(MirLifecycleState state) override;
-    void handle_display_config_change(graphics::DisplayConfiguration const& config) override;
+    void handle_display_config_change(std::shared_ptr<graphics::DisplayConfiguration const> const& config) override;
     void handle_error(ClientVisibleError const& error) override;
     void handle_input_config_change(MirInputConfig const& config) override;
     void send_ping(int32_t serial) override;
@@ -56,10 +59,12 @@ public:
 
 private:
     void send_event_sequence(protobuf::EventSequence&, FdSets const&);
+    void send(char const* data, size_t length, FdSets const&);
     void send_buffer(protobuf::EventSequence&, graphics::Buffer&, graphics::BufferIpcMsgType);
 
     std::shared_ptr<MessageSender> const sender;
     std::shared_ptr<graphics::PlatformIpcOperations> const buffer_packer;
+    std::shared_ptr<DisplayConfigurationMessageCache> const display_config_cache;
 };
 
 }
@@ -25,6 +25,8 @@
 #include "protobuf_responder.h"
 #include "socket_messenger.h"
 #include "socket_connection.h"
+#include "submission_ring_consumer.h"
+#include "display_configuration_message_cache.h"
 
 #include "protobuf_ipc_factory.h"
 #include "mir/frontend/session_authorizer.h"
@@ -43,7 +45,9 @@ mf::ProtobufConnectionCreator::ProtobufConnectionCreator(
     operations(operations),
     report(report),
     next_session_id(0),
-    connections(std::make_shared<mfd::Connections<mfd::SocketConnection>>())
+    connections(std::make_shared<mfd::Connections<mfd::SocketConnection>>()),
+    ring_dispatcher(std::make_shared<mfd::SubmissionRingDispatcher>()),
+    display_config_cache(std::make_shared<mfd::DisplayConfigurationMessageCache>())
 {
 }
 
@@ -62,18 +66,22 @@ namespace
 class ProtobufEventFactory : public mf::EventSinkFactory
 {
 public:
-    ProtobufEventFactory(std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations)
-        : ops{operations}
+    ProtobufEventFactory(
+        std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
+        std::shared_ptr<mfd::DisplayConfigurationMessageCache> const& display_config_cache)
+        : ops{operations},
+          display_config_cache{display_config_cache}
     {
     }
 
     std::unique_ptr<mf::EventSink>
     create_sink(std::shared_ptr<mf::MessageSender> const& messenger)
     {
-        return std::make_unique<mf::detail::EventSender>(messenger, ops);
+        return std::make_unique<mf::detail::EventSender>(messenger, ops, display_config_cache);
     };
 private:
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const ops;
+    std::shared_ptr<mfd::DisplayConfigurationMessageCache> const display_config_cache;
 };
 }
 
@@ -95,7 +103,7 @@ void mf::ProtobufConnectionCreator::create_connection_for(
             message_sender,
             ipc_factory->make_ipc_server(
                 creds,
-                std::make_shared<ProtobufEventFactory>(operations),
+                std::make_shared<ProtobufEventFactory>(operations, display_config_cache),
                 messenger,
                 connection_context),
             report);
@@ -115,5 +123,6 @@ mf::ProtobufConnectionCreator::create_processor(
     return std::make_shared<detail::ProtobufMessageProcessor>(
         sender,
         display_server,
-        report);
+        report,
+        ring_dispatcher);
 }
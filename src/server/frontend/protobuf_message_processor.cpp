@@ -18,6 +18,8 @@
 
 #include "display_server.h"
 #include "protobuf_message_processor.h"
+#include "recycling_message_pool.h"
+#include "submission_ring_consumer.h"
 #include "mir/cookie/authority.h"
 #include "mir/frontend/message_processor_report.h"
 #include "mir/frontend/protobuf_message_sender.h"
@@ -47,10 +49,27 @@ mfd::ProtobufMessageProcessor::ProtobufMessageProcessor(
     std::shared_ptr<ProtobufMessageSender> const& sender,
     std::shared_ptr<DisplayServer> const& display_server,
     std::shared_ptr<MessageProcessorReport> const& report) :
+    ProtobufMessageProcessor(sender, display_server, report, nullptr)
+{
+}
+
+mfd::ProtobufMessageProcessor::ProtobufMessageProcessor(
+    std::shared_ptr<ProtobufMessageSender> const& sender,
+    std::shared_ptr<DisplayServer> const& display_server,
+    std::shared_ptr<MessageProcessorReport> const& report,
+    std::shared_ptr<SubmissionRingDispatcher> const& ring_dispatcher) :
     sender(sender),
     display_server(display_server),
-    report(report)
+    report(report),
+    ring_dispatcher(ring_dispatcher),
+    void_responses{std::make_shared<RecyclingMessagePool<protobuf::Void>>()}
+{
+}
+
+mfd::ProtobufMessageProcessor::~ProtobufMessageProcessor() noexcept
 {
+    if (submission_ring)
+        ring_dispatcher->remove(*submission_ring);
 }
 
 namespace mir
@@ -76,6 +95,14 @@ ParameterMessage parse_parameter(Invocation const& invocation)
     return request;
 }
 
+// Parses into an existing message, reusing whatever it has already allocated
+template<class ParameterMessage>
+void parse_parameter_into(Invocation const& invocation, ParameterMessage& request)
+{
+    if (!request.ParseFromString(invocation.parameters()))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to parse message parameters!"));
+}
+
 class CallbackClosure : public google::protobuf::Closure
 {
 public:
@@ -104,9 +131,9 @@ void invoke(
         ResponseType* response,
         ::google::protobuf::Closure* done),
     unsigned int invocation_id,
-    RequestType* request)
+    RequestType* request,
+    std::shared_ptr<ResponseType> const& result_message)
 {
-    auto const result_message = std::make_shared<ResponseType>();
 
     std::weak_ptr<ProtobufMessageProcessor> weak_mp = mp;
     auto const response_callback = [weak_mp, invocation_id, result_message]
@@ -191,6 +218,14 @@ bool mfd::ProtobufMessageProcessor::dispatch(
     Invocation const& invocation,
     std::vector<mir::Fd> const& side_channel_fds)
 {
+    // Serialize with entries arriving through the submission ring
+    std::lock_guard<decltype(dispatch_mutex)> lock{dispatch_mutex};
+
+    // Anything the client posted to the ring before this call must be handled first. That is at
+    // most a ring's worth, as the client can't post more until we've consumed them.
+    if (submission_ring)
+        drain_submission_ring(SubmissionRing::capacity);
+
     report->received_invocation(display_server.get(), invocation.id(), invocation.method_name());
 
     bool result = true;
@@ -209,11 +244,20 @@ bool mfd::ProtobufMessageProcessor::dispatch(
         }
         else if ("submit_buffer" == invocation.method_name())
         {
-            auto request = parse_parameter<mir::protobuf::BufferRequest>(invocation);
+            // submit_buffer is by far the most frequent call, so both the request and
+            // response are recycled rather than allocated afresh for each invocation.
+            // The request is only read synchronously by DisplayServer::submit_buffer().
+            auto& request = submit_buffer_request;
+            parse_parameter_into(invocation, request);
             request.mutable_buffer()->clear_fd();
             for (auto& fd : side_channel_fds)
                 request.mutable_buffer()->add_fd(fd);
-            invoke(shared_from_this(), display_server.get(), &DisplayServer::submit_buffer, invocation.id(), &request);
+            invoke(shared_from_this(), display_server.get(), &DisplayServer::submit_buffer, invocation.id(), &request,
+                   void_responses->acquire());
+        }
+        else if ("create_submission_ring" == invocation.method_name())
+        {
+            create_submission_ring(invocation);
         }
         else if ("allocate_buffers" == invocation.method_name())
         {
@@ -236,7 +280,7 @@ bool mfd::ProtobufMessageProcessor::dispatch(
                 request.add_fd(fd);
 
             invoke(shared_from_this(), display_server.get(), &DisplayServer::platform_operation,
-                   invocation.id(), &request);
+                   invocation.id(), &request, std::make_shared<mir::protobuf::PlatformOperationMessage>());
         }
         else if ("configure_display" == invocation.method_name())
         {
@@ -337,6 +381,10 @@ bool mfd::ProtobufMessageProcessor::dispatch(
         {
             invoke(this, display_server.get(), &protobuf::DisplayServer::request_persistent_surface_id, invocation);
         }
+        else if ("frame_timing" == invocation.method_name())
+        {
+            invoke(this, display_server.get(), &protobuf::DisplayServer::frame_timing, invocation);
+        }
         else if ("preview_base_display_configuration" == invocation.method_name())
         {
             invoke(this, display_server.get(), &protobuf::DisplayServer::preview_base_display_configuration, invocation);
@@ -391,6 +439,9 @@ void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id,
 
 void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id, mir::protobuf::Connection* response)
 {
+    if (ring_dispatcher && !response->has_error() && !response->has_structured_error())
+        response->set_submission_ring_supported(true);
+
     if (response->has_platform())
         sender->send_response(id, response, {extract_fds_from(response->mutable_platform())});
     else
@@ -436,3 +487,101 @@ void mfd::ProtobufMessageProcessor::send_response(
 {
     sender->send_response(id, response.get(), {extract_fds_from(response.get())});
 }
+
+void mfd::ProtobufMessageProcessor::create_submission_ring(Invocation const& invocation)
+{
+    mir::protobuf::SocketFD response;
+
+    if (!ring_dispatcher)
+    {
+        response.set_error("Server does not support submission rings");
+    }
+    else if (submission_ring)
+    {
+        response.set_error("Connection already has a submission ring");
+    }
+    else
+    {
+        std::weak_ptr<ProtobufMessageProcessor> const weak_self = shared_from_this();
+        submission_ring = std::make_shared<SubmissionRingConsumer>(
+            [weak_self]
+            {
+                if (auto const self = weak_self.lock())
+                {
+                    std::lock_guard<decltype(dispatch_mutex)> lock{self->dispatch_mutex};
+                    self->drain_submission_ring(SubmissionRingConsumer::max_entries_per_wakeup);
+                }
+            });
+
+        response.add_fd(submission_ring->ring_fd());
+        response.add_fd(submission_ring->wakeup_fd());
+        ring_dispatcher->add(submission_ring);
+    }
+
+    send_response(invocation.id(), &response);
+}
+
+void mfd::ProtobufMessageProcessor::drain_submission_ring(uint32_t max_entries)
+{
+    submission_ring->drain(
+        [this](SubmissionRingEntry const& entry) { handle_ring_entry(entry); },
+        max_entries);
+}
+
+namespace
+{
+/// Ring entries have no invocation id, so are reported with one no client uses
+int const ring_invocation_id{-1};
+}
+
+void mfd::ProtobufMessageProcessor::handle_ring_entry(SubmissionRingEntry const& entry)
+{
+    char const* const method =
+        entry.operation == SubmissionRingOperation::release_buffer ? "release_buffers" : "submit_buffer";
+
+    report->received_invocation(display_server.get(), ring_invocation_id, method);
+
+    // There's nobody to send an error to: the client didn't wait for a
+    // response. So, just as for a failed asynchronous submit_buffer, it is only reported.
+    bool result = true;
+    try
+    {
+        protobuf::Void ignored_response;
+        CallbackClosure ignore_done{[]{}};
+
+        switch (entry.operation)
+        {
+        case SubmissionRingOperation::submit_buffer:
+        {
+            auto& request = submit_buffer_request;
+            request.Clear();
+            request.mutable_id()->set_value(entry.stream_id);
+            request.mutable_buffer()->set_buffer_id(entry.buffer_id);
+            display_server->submit_buffer(&request, &ignored_response, &ignore_done);
+            break;
+        }
+
+        case SubmissionRingOperation::release_buffer:
+        {
+            protobuf::BufferRelease request;
+            request.mutable_id()->set_value(entry.stream_id);
+            request.add_buffers()->set_buffer_id(entry.buffer_id);
+            display_server->release_buffers(&request, &ignored_response, &ignore_done);
+            break;
+        }
+
+        default:
+            report->unknown_method(display_server.get(), ring_invocation_id,
+                "submission ring operation " + std::to_string(static_cast<unsigned>(entry.operation)));
+            result = false;
+            break;
+        }
+    }
+    catch (std::exception const& error)
+    {
+        report->exception_handled(display_server.get(), ring_invocation_id, error);
+        result = false;
+    }
+
+    report->completed_invocation(display_server.get(), ring_invocation_id, result);
+}
@@ -25,6 +25,7 @@
 #include <google/protobuf/stubs/common.h>
 
 #include <memory>
+#include <mutex>
 
 namespace google { namespace protobuf { class MessageLite; } }
 namespace mir
@@ -32,11 +33,15 @@ namespace mir
 namespace frontend
 {
 class MessageProcessorReport;
+struct SubmissionRingEntry;
 
 namespace detail
 {
 class DisplayServer;
 class ProtobufMessageSender;
+template<typename Message> class RecyclingMessagePool;
+class SubmissionRingConsumer;
+class SubmissionRingDispatcher;
 
 class ProtobufMessageProcessor : public MessageProcessor,
                                  public std::enable_shared_from_this<ProtobufMessageProcessor>
@@ -47,7 +52,14 @@ public:
         std::shared_ptr<DisplayServer> const& display_server,
         std::shared_ptr<MessageProcessorReport> const& report);
 
-    ~ProtobufMessageProcessor() noexcept {}
+    /// \param ring_dispatcher if not null, clients may create a submission ring
+    ProtobufMessageProcessor(
+        std::shared_ptr<ProtobufMessageSender> const& sender,
+        std::shared_ptr<DisplayServer> const& display_server,
+        std::shared_ptr<MessageProcessorReport> const& report,
+        std::shared_ptr<SubmissionRingDispatcher> const& ring_dispatcher);
+
+    ~ProtobufMessageProcessor() noexcept;
 
     void client_pid(int pid) override;
 
@@ -63,10 +75,19 @@ public:
 
 private:
     bool dispatch(Invocation const& invocation, std::vector<mir::Fd> const& side_channel_fds) override;
+    void create_submission_ring(Invocation const& invocation);
+    void drain_submission_ring(uint32_t max_entries);
+    void handle_ring_entry(SubmissionRingEntry const& entry);
 
     std::shared_ptr<ProtobufMessageSender> const sender;
     std::shared_ptr<DisplayServer> const display_server;
     std::shared_ptr<MessageProcessorReport> const report;
+    std::shared_ptr<SubmissionRingDispatcher> const ring_dispatcher;
+
+    std::mutex dispatch_mutex;
+    std::shared_ptr<SubmissionRingConsumer> submission_ring;
+    protobuf::BufferRequest submit_buffer_request;
+    std::shared_ptr<RecyclingMessagePool<protobuf::Void>> const void_responses;
 };
 }
 }
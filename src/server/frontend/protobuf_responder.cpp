@@ -22,6 +22,10 @@
 #include "mir/frontend/client_constants.h"
 #include "mir/variable_length_array.h"
 #include "socket_messenger.h"
+#include "mir_protobuf_wire.pb.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 
 namespace mfd = mir::frontend::detail;
 
@@ -38,28 +42,35 @@ void mfd::ProtobufResponder::send_response(
     google::protobuf::MessageLite* response,
     FdSets const& fd_sets)
 {
-    mir::VariableLengthArray<serialization_buffer_size>
+    using google::protobuf::io::CodedOutputStream;
+    using google::protobuf::internal::WireFormatLite;
+
 #if GOOGLE_PROTOBUF_VERSION >= 3010000
-        send_response_buffer{static_cast<size_t>(response->ByteSizeLong())};
+    auto const response_size = static_cast<uint32_t>(response->ByteSizeLong());
 #else
-        send_response_buffer{static_cast<size_t>(response->ByteSize())};
+    auto const response_size = static_cast<uint32_t>(response->ByteSize());
 #endif
 
-    response->SerializeWithCachedSizesToArray(send_response_buffer.data());
+    // Hand-encode the wire::Result envelope ({id = 1, response = 2}) around
+    // the response so that it is serialized exactly once, straight into the
+    // outbound buffer, rather than via an intermediate std::string copy.
+    auto const id_tag = WireFormatLite::MakeTag(
+        mir::protobuf::wire::Result::kIdFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+    auto const response_tag = WireFormatLite::MakeTag(
+        mir::protobuf::wire::Result::kResponseFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
 
-    {
-        std::lock_guard<decltype(result_guard)> lock{result_guard};
+    size_t const envelope_size =
+        CodedOutputStream::VarintSize32(id_tag) + CodedOutputStream::VarintSize32(id) +
+        CodedOutputStream::VarintSize32(response_tag) + CodedOutputStream::VarintSize32(response_size);
 
-        send_response_result.set_id(id);
-        send_response_result.set_response(send_response_buffer.data(), send_response_buffer.size());
+    mir::VariableLengthArray<serialization_buffer_size> send_response_buffer{envelope_size + response_size};
 
-#if GOOGLE_PROTOBUF_VERSION >= 3010000
-        send_response_buffer.resize(send_response_result.ByteSizeLong());
-#else
-        send_response_buffer.resize(send_response_result.ByteSize());
-#endif
-        send_response_result.SerializeWithCachedSizesToArray(send_response_buffer.data());
-    }
+    auto target = send_response_buffer.data();
+    target = CodedOutputStream::WriteVarint32ToArray(id_tag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(id, target);
+    target = CodedOutputStream::WriteVarint32ToArray(response_tag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(response_size, target);
+    response->SerializeWithCachedSizesToArray(target);
 
     sender->send(reinterpret_cast<char*>(send_response_buffer.data()), send_response_buffer.size(), fd_sets);
     resource_cache->free_resource(response);
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_RECYCLING_MESSAGE_POOL_H_
+#define MIR_FRONTEND_RECYCLING_MESSAGE_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace frontend
+{
+namespace detail
+{
+/// A per-connection free list of protobuf messages.
+///
+/// Messages handed out by acquire() are Clear()ed and returned to the pool
+/// when the last reference is dropped (which may happen on any thread), so
+/// repeated strings and sub-messages keep their allocations between calls.
+/// If the pool has been destroyed by then the message is simply deleted.
+template<typename Message>
+class RecyclingMessagePool : public std::enable_shared_from_this<RecyclingMessagePool<Message>>
+{
+public:
+    explicit RecyclingMessagePool(size_t max_free = 4) : max_free{max_free} {}
+
+    std::shared_ptr<Message> acquire()
+    {
+        std::unique_ptr<Message> message;
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!free_messages.empty())
+            {
+                message = std::move(free_messages.back());
+                free_messages.pop_back();
+            }
+        }
+
+        if (!message)
+            message = std::make_unique<Message>();
+
+        std::weak_ptr<RecyclingMessagePool> const weak_pool = this->shared_from_this();
+        return {
+            message.release(),
+            [weak_pool](Message* message)
+            {
+                if (auto const pool = weak_pool.lock())
+                    pool->recycle(std::unique_ptr<Message>{message});
+                else
+                    delete message;
+            }};
+    }
+
+private:
+    void recycle(std::unique_ptr<Message> message)
+    {
+        message->Clear();
+
+        std::lock_guard<std::mutex> lock{mutex};
+        if (free_messages.size() < max_free)
+            free_messages.push_back(std::move(message));
+    }
+
+    size_t const max_free;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Message>> free_messages;
+};
+}
+}
+}
+
+#endif /* MIR_FRONTEND_RECYCLING_MESSAGE_POOL_H_ */
@@ -28,6 +28,7 @@
 #include "mir/scene/coordinate_translator.h"
 #include "mir/scene/application_not_responding_detector.h"
 #include "mir/scene/session.h"
+#include "mir/scene/session_resources.h"
 #include "mir/frontend/display_changer.h"
 #include "resource_cache.h"
 #include "mir_toolkit/common.h"
@@ -465,6 +466,9 @@ void mf::SessionMediator::submit_buffer(
 
     stream->submit_buffer(std::make_shared<AutoSendBuffer>(b, executor, event_sink));
 
+    if (auto const scene_session = weak_scene_session.lock())
+        scene_session->resources()->buffer_committed();
+
     done->Run();
 }
 
@@ -535,6 +539,10 @@ void mf::SessionMediator::allocate_buffers(
                 }
             }
 
+            // Refuses the buffer if it would take the client over its limit
+            if (auto const scene_session = weak_scene_session.lock())
+                buffer = scene_session->resources()->track(buffer);
+
             if (request->has_id())
             {
                 auto const stream_id = mf::BufferStreamId{request->id().value()};
@@ -1266,6 +1274,23 @@ void mf::SessionMediator::request_persistent_surface_id(
     done->Run();
 }
 
+void mf::SessionMediator::frame_timing(
+    mir::protobuf::FrameTimingRequest const* request,
+    mir::protobuf::FrameTiming* response,
+    google::protobuf::Closure* done)
+{
+    if (!weak_mir_client_session.lock())
+        BOOST_THROW_EXCEPTION(std::logic_error("Invalid application session"));
+
+    auto const frame = display_changer->last_frame_on(request->output_id());
+
+    response->set_msc(frame.msc);
+    response->set_ust(frame.ust.nanoseconds.count());
+    response->set_clock_id(frame.ust.clock_id);
+
+    done->Run();
+}
+
 void mf::SessionMediator::pack_protobuf_buffer(
     protobuf::Buffer& protobuf_buffer,
     graphics::Buffer* graphics_buffer,
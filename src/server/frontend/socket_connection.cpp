@@ -97,7 +97,6 @@ try
         BOOST_THROW_EXCEPTION(std::runtime_error(error.message()));
     }
 
-    mir::protobuf::wire::Invocation invocation;
     invocation.ParseFromArray(body.data(), body.size());
 
     int const v = invocation.has_protocol_version() ?
@@ -21,6 +21,7 @@
 #define MIR_FRONTEND_DETAIL_SOCKET_CONNECTION_H_
 
 #include "mir/frontend/connections.h"
+#include "mir_protobuf_wire.pb.h"
 
 #include <boost/asio.hpp>
 
@@ -63,6 +64,9 @@ private:
     static size_t const header_size = 2;
     char header[header_size];
     std::vector<char> body;
+    // Reused for every message on this connection so the parsed strings keep
+    // their allocations between invocations
+    mir::protobuf::wire::Invocation invocation;
 
     int client_pid = 0;
 };
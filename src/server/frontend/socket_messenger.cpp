@@ -17,8 +17,6 @@
  */
 
 #include "socket_messenger.h"
-#include "mir/frontend/client_constants.h"
-#include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
 #include "mir/raii.h"
 
@@ -27,6 +25,7 @@
 #include <errno.h>
 #include <string.h>
 
+#include <array>
 #include <stdexcept>
 
 namespace mf = mir::frontend;
@@ -74,11 +73,15 @@ mf::SessionCredentials mfd::SocketMessenger::client_creds()
 void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& fd_set)
 {
     static size_t const header_size{2};
-    mir::VariableLengthArray<mf::serialization_buffer_size> whole_message{header_size + length};
+    unsigned char const header[header_size] = {
+        static_cast<unsigned char>((length >> 8) & 0xff),
+        static_cast<unsigned char>((length >> 0) & 0xff)};
 
-    whole_message.data()[0] = static_cast<unsigned char>((length >> 8) & 0xff);
-    whole_message.data()[1] = static_cast<unsigned char>((length >> 0) & 0xff);
-    std::copy(data, data + length, whole_message.data() + header_size);
+    // Gather the header and the (already serialized) body into a single
+    // write rather than copying the body into a combined message buffer.
+    std::array<ba::const_buffer, 2> const whole_message{{
+        ba::buffer(header, header_size),
+        ba::buffer(data, length)}};
 
     std::unique_lock<std::mutex> lg(message_lock);
 
@@ -87,7 +90,7 @@ void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& f
     // function has completed (if it would be executed asynchronously.
     // NOTE: we rely on this synchronous behavior as per the comment in
     // mf::SessionMediator::create_surface
-    ba::write(*socket, ba::buffer(whole_message.data(), whole_message.size()));
+    ba::write(*socket, whole_message);
 
     for (auto const& fds : fd_set)
         mir::send_fds(socket_fd, fds);
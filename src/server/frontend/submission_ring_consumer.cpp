@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "submission_ring_consumer.h"
+
+#include "mir/dispatch/multiplexing_dispatchable.h"
+#include "mir/dispatch/threaded_dispatcher.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace mfd = mir::frontend::detail;
+namespace md = mir::dispatch;
+
+namespace
+{
+mir::Fd make_eventfd()
+{
+    mir::Fd fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create eventfd"}));
+    }
+    return fd;
+}
+}
+
+mfd::SubmissionRingConsumer::SubmissionRingConsumer(std::function<void()> const& on_wakeup) :
+    shm{SubmissionRing::mapping_size()},
+    ring{shm.base_ptr(), true},
+    wakeup{make_eventfd()},
+    on_wakeup{on_wakeup}
+{
+}
+
+mir::Fd mfd::SubmissionRingConsumer::ring_fd() const
+{
+    return Fd{IntOwnedFd{shm.fd()}};
+}
+
+mir::Fd mfd::SubmissionRingConsumer::wakeup_fd() const
+{
+    return wakeup;
+}
+
+void mfd::SubmissionRingConsumer::process()
+{
+    eventfd_t ignored;
+    eventfd_read(wakeup, &ignored);
+
+    on_wakeup();
+}
+
+void mfd::SubmissionRingConsumer::drain(Handler const& handler, uint32_t max_entries)
+{
+    ring.drain(handler, max_entries);
+
+    if (!ring.prepare_to_wait())
+        eventfd_write(wakeup, 1);
+}
+
+mfd::SubmissionRingDispatcher::SubmissionRingDispatcher() :
+    multiplexer{std::make_shared<md::MultiplexingDispatchable>()}
+{
+}
+
+mfd::SubmissionRingDispatcher::~SubmissionRingDispatcher() noexcept = default;
+
+void mfd::SubmissionRingDispatcher::add(std::shared_ptr<SubmissionRingConsumer> const& consumer)
+{
+    std::weak_ptr<SubmissionRingConsumer> const weak_consumer{consumer};
+
+    multiplexer->add_watch(
+        consumer->wakeup_fd(),
+        [weak_consumer]
+        {
+            if (auto const consumer = weak_consumer.lock())
+                consumer->process();
+        });
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    if (!thread)
+        thread = std::make_unique<md::ThreadedDispatcher>("Mir/IPC ring", multiplexer);
+}
+
+void mfd::SubmissionRingDispatcher::remove(SubmissionRingConsumer const& consumer)
+{
+    multiplexer->remove_watch(consumer.wakeup_fd());
+}
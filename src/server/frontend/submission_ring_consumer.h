@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_SUBMISSION_RING_CONSUMER_H_
+#define MIR_FRONTEND_SUBMISSION_RING_CONSUMER_H_
+
+#include "mir/frontend/submission_ring.h"
+#include "mir/anonymous_shm_file.h"
+#include "mir/fd.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace mir
+{
+namespace dispatch
+{
+class MultiplexingDispatchable;
+class ThreadedDispatcher;
+}
+namespace frontend
+{
+namespace detail
+{
+/// The server end of a client's SubmissionRing
+class SubmissionRingConsumer
+{
+public:
+    using Handler = std::function<void(SubmissionRingEntry const&)>;
+
+    /// \param on_wakeup called (on the ring thread) when the client signals
+    ///                  that entries are pending; expected to call drain()
+    explicit SubmissionRingConsumer(std::function<void()> const& on_wakeup);
+
+    /// The shared memory backing the ring, to be sent to the client
+    Fd ring_fd() const;
+    /// The eventfd the client signals when entries are pending
+    Fd wakeup_fd() const;
+
+    /// The most entries handled per wakeup, so that a busy client can't hold up the other rings
+    static uint32_t const max_entries_per_wakeup = 64;
+
+    /// Called when wakeup_fd() is readable
+    void process();
+
+    /// Pass up to max_entries of what the client has posted to handler, in order. If more are
+    /// pending, wakeup_fd() is signalled again so they are handled after the other rings.
+    /// Callers must ensure only one thread drains at a time.
+    void drain(Handler const& handler, uint32_t max_entries);
+
+private:
+    AnonymousShmFile shm;
+    SubmissionRing ring;
+    Fd const wakeup;
+    std::function<void()> const on_wakeup;
+};
+
+/// Watches the wakeup fds of all SubmissionRingConsumers on a single
+/// "Mir/IPC ring" thread, started when the first ring is created.
+class SubmissionRingDispatcher
+{
+public:
+    SubmissionRingDispatcher();
+    ~SubmissionRingDispatcher() noexcept;
+
+    void add(std::shared_ptr<SubmissionRingConsumer> const& consumer);
+    void remove(SubmissionRingConsumer const& consumer);
+
+private:
+    std::shared_ptr<dispatch::MultiplexingDispatchable> const multiplexer;
+
+    std::mutex mutex;
+    std::unique_ptr<dispatch::ThreadedDispatcher> thread;
+};
+}
+}
+}
+
+#endif /* MIR_FRONTEND_SUBMISSION_RING_CONSUMER_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_callback_throttle.h"
+
+namespace mf = mir::frontend;
+
+mf::FrameCallbackThrottle::FrameCallbackThrottle(
+    wl_event_loop* loop,
+    std::chrono::milliseconds interval,
+    std::function<void(bool throttled)> send) :
+    loop{loop},
+    interval{interval},
+    send{std::move(send)}
+{
+}
+
+mf::FrameCallbackThrottle::~FrameCallbackThrottle()
+{
+    if (timer)
+        wl_event_source_remove(timer);
+}
+
+void mf::FrameCallbackThrottle::set_visible(bool visible)
+{
+    this->visible = visible;
+
+    if (visible && timer_armed)
+    {
+        // A timeout of zero disarms the timer
+        wl_event_source_timer_update(timer, 0);
+        timer_armed = false;
+    }
+}
+
+void mf::FrameCallbackThrottle::send_when_due()
+{
+    if (visible)
+    {
+        send(false);
+        return;
+    }
+
+    if (timer_armed)
+        return;
+
+    if (!timer)
+        timer = wl_event_loop_add_timer(loop, &timer_expired, this);
+
+    wl_event_source_timer_update(timer, interval.count());
+    timer_armed = true;
+}
+
+int mf::FrameCallbackThrottle::timer_expired(void* data)
+{
+    auto const self = static_cast<FrameCallbackThrottle*>(data);
+    self->timer_armed = false;
+    self->send(true);
+    return 0;
+}
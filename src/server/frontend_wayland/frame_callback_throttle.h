@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_FRAME_CALLBACK_THROTTLE_H
+#define MIR_FRONTEND_FRAME_CALLBACK_THROTTLE_H
+
+#include <wayland-server-core.h>
+
+#include <chrono>
+#include <functional>
+
+namespace mir
+{
+namespace frontend
+{
+/// Decides when a surface's frame callbacks are sent: straight away while it is visible, otherwise from
+/// a timer on the Wayland event loop, so a client nobody can see doesn't draw at full rate
+class FrameCallbackThrottle
+{
+public:
+    /// \param send  sends the frame callbacks. Its argument is true if they were held back by the throttle.
+    FrameCallbackThrottle(wl_event_loop* loop, std::chrono::milliseconds interval, std::function<void(bool throttled)> send);
+    ~FrameCallbackThrottle();
+
+    /// Becoming visible stops the timer. It is up to the caller to then send any callbacks that are due.
+    void set_visible(bool visible);
+    auto is_visible() const -> bool { return visible; }
+
+    /// Called when there are frame callbacks to send: sends them now if visible, otherwise when the timer
+    /// expires (starting it if it isn't already running)
+    void send_when_due();
+
+private:
+    FrameCallbackThrottle(FrameCallbackThrottle const&) = delete;
+    FrameCallbackThrottle& operator=(FrameCallbackThrottle const&) = delete;
+
+    static int timer_expired(void* data);
+
+    wl_event_loop* const loop;
+    std::chrono::milliseconds const interval;
+    std::function<void(bool throttled)> const send;
+
+    bool visible{true};
+    wl_event_source* timer{nullptr};    ///< Created the first time it is needed
+    bool timer_armed{false};
+};
+}
+}
+
+#endif // MIR_FRONTEND_FRAME_CALLBACK_THROTTLE_H
@@ -38,7 +38,7 @@ void mf::NullEventSink::handle_lifecycle_event(MirLifecycleState /*state*/)
 {
 }
 
-void mf::NullEventSink::handle_display_config_change(graphics::DisplayConfiguration const& /*config*/)
+void mf::NullEventSink::handle_display_config_change(std::shared_ptr<graphics::DisplayConfiguration const> const& /*config*/)
 {
 }
 
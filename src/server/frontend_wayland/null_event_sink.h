@@ -34,7 +34,7 @@ public:
 
     void handle_lifecycle_event(MirLifecycleState state) override;
 
-    void handle_display_config_change(graphics::DisplayConfiguration const& config) override;
+    void handle_display_config_change(std::shared_ptr<graphics::DisplayConfiguration const> const& config) override;
 
     void send_ping(int32_t serial) override;
 
@@ -20,6 +20,7 @@
 #include "wayland_surface_observer.h"
 #include "wl_seat.h"
 #include "wayland_utils.h"
+#include "wl_surface.h"
 #include "window_wl_surface_role.h"
 #include "wayland_input_dispatcher.h"
 
@@ -40,6 +41,7 @@ mf::WaylandSurfaceObserver::WaylandSurfaceObserver(
     WindowWlSurfaceRole* window)
     : seat{seat},
       window{window},
+      surface{surface},
       input_dispatcher{std::make_unique<WaylandInputDispatcher>(seat, surface)},
       window_size{geometry::Size{0,0}},
       destroyed{std::make_shared<bool>(false)}
@@ -72,6 +74,13 @@ void mf::WaylandSurfaceObserver::attrib_changed(ms::Surface const*, MirWindowAtt
             });
         break;
 
+    case mir_window_attrib_visibility:
+        run_on_wayland_thread_unless_destroyed([this, value]()
+            {
+                surface->set_visible(value == mir_window_visibility_exposed);
+            });
+        break;
+
     default:;
     }
 }
@@ -83,6 +83,7 @@ public:
 private:
     WlSeat* const seat; // only used by run_on_wayland_thread_unless_destroyed()
     WindowWlSurfaceRole* const window;
+    WlSurface* const surface;
     std::unique_ptr<WaylandInputDispatcher> const input_dispatcher;
 
     geometry::Size window_size;
@@ -120,6 +120,11 @@ void mf::WlSubsurface::parent_has_committed()
     }
 }
 
+void mf::WlSubsurface::parent_visibility_changed(bool visible)
+{
+    surface->set_visible(visible);
+}
+
 auto mf::WlSubsurface::subsurface_at(geom::Point point) -> std::experimental::optional<WlSurface*>
 {
     return surface->subsurface_at(point);
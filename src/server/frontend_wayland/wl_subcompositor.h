@@ -63,6 +63,7 @@ public:
     auto scene_surface() const -> std::experimental::optional<std::shared_ptr<scene::Surface>> override;
 
     void parent_has_committed();
+    void parent_visibility_changed(bool visible);
 
     auto subsurface_at(geometry::Point point) -> std::experimental::optional<WlSurface*>;
 
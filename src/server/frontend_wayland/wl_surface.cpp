@@ -31,6 +31,7 @@
 
 #include "mir/graphics/buffer_properties.h"
 #include "mir/scene/session.h"
+#include "mir/scene/session_resources.h"
 #include "mir/frontend/wayland.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/executor.h"
@@ -39,6 +40,7 @@
 #include "mir/log.h"
 
 #include <algorithm>
+#include <chrono>
 #include <boost/throw_exception.hpp>
 
 namespace mf = mir::frontend;
@@ -46,6 +48,12 @@ namespace geom = mir::geometry;
 namespace mw = mir::wayland;
 namespace msh = mir::shell;
 
+namespace
+{
+/// How often a surface that isn't visible gets frame callbacks
+std::chrono::milliseconds const throttled_frame_interval{1000};
+}
+
 mf::WlSurfaceState::Callback::Callback(wl_resource* new_resource)
     : mw::Callback{new_resource, Version<1>()},
       destroyed{deleted_flag_for_resource(resource)}
@@ -92,7 +100,17 @@ mf::WlSurface::WlSurface(
         executor{executor},
         null_role{this},
         role{&null_role},
-        destroyed{std::make_shared<bool>(false)}
+        destroyed{std::make_shared<bool>(false)},
+        frame_throttle{
+            wl_display_get_event_loop(wl_client_get_display(client)),
+            throttled_frame_interval,
+            [this](bool throttled)
+            {
+                // The callbacks may already have gone, if the buffer was consumed after all
+                if (throttled && !frame_callbacks.empty())
+                    session->resources()->frame_throttled();
+                send_frame_callbacks();
+            }}
 {
     // wl_surface is specified to act in mailbox mode
     stream->allow_framedropping(true);
@@ -254,6 +272,28 @@ void mf::WlSurface::send_frame_callbacks()
     frame_callbacks.clear();
 }
 
+void mf::WlSurface::send_frame_callbacks_when_due()
+{
+    if (!frame_callbacks.empty())
+        frame_throttle.send_when_due();
+}
+
+void mf::WlSurface::set_visible(bool visible)
+{
+    if (frame_throttle.is_visible() == visible)
+        return;
+
+    frame_throttle.set_visible(visible);
+
+    // Once visible, let the client draw straight away rather than waiting for the next throttled frame
+    send_frame_callbacks_when_due();
+
+    for (WlSubsurface* child: children)
+    {
+        child->parent_visibility_changed(visible);
+    }
+}
+
 void mf::WlSurface::destroy()
 {
     *destroyed = true;
@@ -338,7 +378,7 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
         {
             // TODO: unmap surface, and unmap all subsurfaces
             buffer_size_ = std::experimental::nullopt;
-            send_frame_callbacks();
+            send_frame_callbacks_when_due();
         }
         else
         {
@@ -388,9 +428,18 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                     mir_buffer->id().as_value());
             }
 
+            // Refuses the buffer if it would take the client over its limit
+            auto const resources = session->resources();
+            mir_buffer = resources->track(mir_buffer);
+            resources->buffer_committed();
+
             stream->submit_buffer(mir_buffer);
             auto const new_buffer_size = stream->stream_size();
 
+            // A surface that isn't visible isn't composited, so won't consume the buffer
+            if (!frame_throttle.is_visible())
+                send_frame_callbacks_when_due();
+
             if (!input_shape && std::experimental::make_optional(new_buffer_size) != buffer_size_)
             {
                 state.invalidate_surface_data(); // input shape needs to be recalculated for the new size
@@ -401,7 +450,7 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
     }
     else
     {
-        send_frame_callbacks();
+        send_frame_callbacks_when_due();
     }
 
     for (WlSubsurface* child: children)
@@ -22,6 +22,7 @@
 #include "wayland_wrapper.h"
 
 #include "wl_surface_role.h"
+#include "frame_callback_throttle.h"
 
 #include "mir/geometry/displacement.h"
 #include "mir/geometry/size.h"
@@ -134,6 +135,9 @@ public:
                                std::vector<mir::geometry::Rectangle>& input_shape_accumulator,
                                geometry::Displacement const& parent_offset) const;
     void commit(WlSurfaceState const& state);
+    /// While the surface is not visible on any output (it is occluded, minimized or off-screen) its frame callbacks
+    /// are sent at a low rate, so the client doesn't draw frames nobody sees
+    void set_visible(bool visible);
     void add_destroy_listener(void const* key, std::function<void()> listener);
     void remove_destroy_listener(void const* key);
 
@@ -157,8 +161,11 @@ private:
     std::experimental::optional<std::vector<mir::geometry::Rectangle>> input_shape;
     std::map<void const*, std::function<void()>> destroy_listeners;
     std::shared_ptr<bool> const destroyed;
+    FrameCallbackThrottle frame_throttle;
 
     void send_frame_callbacks();
+    /// Sends the frame callbacks now if the surface is visible, otherwise when the throttle timer expires
+    void send_frame_callbacks_when_due();
 
     void destroy() override;
     void attach(std::experimental::optional<wl_resource*> const& buffer, int32_t x, int32_t y) override;
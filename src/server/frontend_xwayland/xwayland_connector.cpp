@@ -26,9 +26,11 @@
 namespace mf = mir::frontend;
 
 mf::XWaylandConnector::XWaylandConnector(
-    std::shared_ptr<WaylandConnector> const& wayland_connector, std::string const& xwayland_path) :
+    std::shared_ptr<WaylandConnector> const& wayland_connector,
+    std::string const& xwayland_path,
+    std::chrono::seconds idle_timeout) :
     start_xwayland{wayland_connector->get_extension("x11-support") ?
-        [=]{ return std::make_unique<XWaylandServer>(wayland_connector, xwayland_path); } :
+        [=]{ return std::make_unique<XWaylandServer>(wayland_connector, xwayland_path, idle_timeout); } :
         decltype(start_xwayland){[]{ return std::unique_ptr<XWaylandServer>{}; }}}
 {
 }
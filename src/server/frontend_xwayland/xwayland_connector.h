@@ -21,6 +21,8 @@
 
 #include "mir/frontend/connector.h"
 
+#include <chrono>
+
 namespace mir
 {
 namespace frontend
@@ -31,7 +33,9 @@ class XWaylandConnector : public Connector
 {
 public:
     XWaylandConnector(
-        std::shared_ptr<WaylandConnector> const& wayland_connector, std::string const& xwayland_path);
+        std::shared_ptr<WaylandConnector> const& wayland_connector,
+        std::string const& xwayland_path,
+        std::chrono::seconds idle_timeout);
     ~XWaylandConnector() override;
 
     void start() override;
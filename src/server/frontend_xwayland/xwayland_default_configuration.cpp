@@ -67,9 +67,13 @@ std::shared_ptr<mf::Connector> mir::DefaultServerConfiguration::the_xwayland_con
             try
             {
                 auto wayland_connector = std::static_pointer_cast<mf::WaylandConnector>(the_wayland_connector());
+                auto const idle_timeout = options->is_set("xwayland-idle-timeout") ?
+                    std::chrono::seconds{options->get<int>("xwayland-idle-timeout")} :
+                    std::chrono::seconds::zero();
                 return std::make_shared<mf::XWaylandConnector>(
                     wayland_connector,
-                    options->get<std::string>("xwayland-path"));
+                    options->get<std::string>("xwayland-path"),
+                    idle_timeout);
             }
             catch (...)
             {
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xwayland_idle_timer.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <system_error>
+
+namespace mf = mir::frontend;
+
+mf::XWaylandIdleTimer::XWaylandIdleTimer(std::chrono::milliseconds timeout) :
+    timeout{timeout},
+    timer{timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)}
+{
+    if (timer < 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create Xwayland idle timer"}));
+    }
+}
+
+auto mf::XWaylandIdleTimer::fd() const -> Fd const&
+{
+    return timer;
+}
+
+void mf::XWaylandIdleTimer::set_idle(bool idle)
+{
+    this->idle = idle;
+    arm(idle);
+}
+
+auto mf::XWaylandIdleTimer::is_idle() const -> bool
+{
+    return idle;
+}
+
+auto mf::XWaylandIdleTimer::expired(std::function<size_t()> const& count_clients) -> bool
+{
+    uint64_t expirations;
+    if (read(timer, &expirations, sizeof expirations) != sizeof expirations)
+        return false; // The timer was rearmed or disarmed since it became readable
+
+    if (!idle)
+        return false;
+
+    // Clients that are connected without (yet) having a window still need Xwayland
+    if (count_clients() > 0)
+    {
+        arm(true);
+        return false;
+    }
+
+    return true;
+}
+
+void mf::XWaylandIdleTimer::arm(bool armed)
+{
+    if (timeout <= std::chrono::milliseconds::zero())
+        return;
+
+    itimerspec timeout_spec{};
+    if (armed)
+    {
+        auto const seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        timeout_spec.it_value.tv_sec = seconds.count();
+        timeout_spec.it_value.tv_nsec = std::chrono::nanoseconds{timeout - seconds}.count();
+    }
+
+    timerfd_settime(timer, 0, &timeout_spec, nullptr);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_XWAYLAND_IDLE_TIMER_H
+#define MIR_FRONTEND_XWAYLAND_IDLE_TIMER_H
+
+#include "mir/fd.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace mir
+{
+namespace frontend
+{
+/// Decides when a running Xwayland has been unused for long enough to stop it
+class XWaylandIdleTimer
+{
+public:
+    /// \param timeout  how long Xwayland may be idle before it is stopped. Zero disables the timer.
+    explicit XWaylandIdleTimer(std::chrono::milliseconds timeout);
+
+    /// Becomes readable when the timer expires
+    auto fd() const -> Fd const&;
+
+    /// Starts the timer when idle, stops it otherwise
+    void set_idle(bool idle);
+    auto is_idle() const -> bool;
+
+    /// Called once fd() is readable
+    /// \param count_clients  the number of X11 clients connected to Xwayland (not counting the window manager)
+    /// \returns              true if Xwayland should be stopped. If X11 clients are still connected the timer
+    ///                       is restarted instead.
+    auto expired(std::function<size_t()> const& count_clients) -> bool;
+
+private:
+    void arm(bool armed);
+
+    std::chrono::milliseconds const timeout;
+    Fd const timer;
+    std::atomic<bool> idle{false};
+};
+}
+}
+
+#endif // MIR_FRONTEND_XWAYLAND_IDLE_TIMER_H
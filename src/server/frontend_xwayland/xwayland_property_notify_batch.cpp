@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xwayland_property_notify_batch.h"
+
+#include "mir/log.h"
+
+#include <algorithm>
+
+namespace mf = mir::frontend;
+
+namespace
+{
+template<typename F>
+void log_failure_of(F const& f, char const* what)
+{
+    try
+    {
+        f();
+    }
+    catch (...)
+    {
+        mir::log(
+            mir::logging::Severity::warning,
+            MIR_LOG_COMPONENT,
+            std::current_exception(),
+            what);
+    }
+}
+}
+
+void mf::XWaylandPropertyNotifyBatch::add(xcb_window_t window, xcb_atom_t property)
+{
+    std::pair<xcb_window_t, xcb_atom_t> const change{window, property};
+    if (std::find(changed.begin(), changed.end(), change) == changed.end())
+        changed.push_back(change);
+}
+
+auto mf::XWaylandPropertyNotifyBatch::empty() const -> bool
+{
+    return changed.empty();
+}
+
+void mf::XWaylandPropertyNotifyBatch::handle(StartRead const& start_read, Apply const& apply)
+{
+    std::vector<xcb_window_t> changed_windows;
+    std::vector<std::function<void()>> reply_functions;
+    for (auto const& change : changed)
+    {
+        log_failure_of(
+            [&]()
+            {
+                if (auto reply_function = start_read(change.first, change.second))
+                {
+                    reply_functions.push_back(std::move(reply_function.value()));
+                    if (std::find(changed_windows.begin(), changed_windows.end(), change.first) ==
+                        changed_windows.end())
+                    {
+                        changed_windows.push_back(change.first);
+                    }
+                }
+            },
+            "Failed to read xcb property");
+    }
+    changed.clear();
+
+    // Each reply function owns a request's reply, so all of them must run for none to leak
+    for (auto const& reply_function : reply_functions)
+        log_failure_of(reply_function, "Failed to handle xcb property reply");
+
+    for (auto const window : changed_windows)
+        log_failure_of([&]() { apply(window); }, "Failed to apply xcb property changes");
+}
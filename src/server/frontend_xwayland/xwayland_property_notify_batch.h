@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_XWAYLAND_PROPERTY_NOTIFY_BATCH_H
+#define MIR_FRONTEND_XWAYLAND_PROPERTY_NOTIFY_BATCH_H
+
+#include <xcb/xcb.h>
+
+#include <experimental/optional>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace mir
+{
+namespace frontend
+{
+/// A run of X11 property changes, read with a single round trip to the X server
+class XWaylandPropertyNotifyBatch
+{
+public:
+    /// Reads a property, returning a function that waits for and handles the reply, or nullopt if the property
+    /// isn't of interest
+    using StartRead =
+        std::function<std::experimental::optional<std::function<void()>>(xcb_window_t, xcb_atom_t)>;
+
+    /// Applies the properties read for a window
+    using Apply = std::function<void(xcb_window_t)>;
+
+    /// A property that changed several times is only read once
+    void add(xcb_window_t window, xcb_atom_t property);
+    auto empty() const -> bool;
+
+    /// Requests every value before waiting for any of them, then applies the changes to each window once. A
+    /// failure is logged and doesn't stop the rest of the batch, so every reply is still collected. The batch
+    /// is empty afterwards.
+    void handle(StartRead const& start_read, Apply const& apply);
+
+private:
+    std::vector<std::pair<xcb_window_t, xcb_atom_t>> changed;
+};
+}
+}
+
+#endif // MIR_FRONTEND_XWAYLAND_PROPERTY_NOTIFY_BATCH_H
@@ -17,6 +17,7 @@
  */
 
 #include "xwayland_server.h"
+#include "xwayland_idle_timer.h"
 #include "xwayland_wm.h"
 
 #include "wayland_connector.h"
@@ -30,6 +31,8 @@
 
 #include <csignal>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -38,6 +41,7 @@
 #include <unistd.h>
 
 #include <chrono>
+#include <fstream>
 #include <thread>
 
 namespace mf = mir::frontend;
@@ -46,14 +50,17 @@ using namespace std::chrono_literals;
 
 mf::XWaylandServer::XWaylandServer(
     std::shared_ptr<mf::WaylandConnector> wayland_connector,
-    std::string const& xwayland_path) :
+    std::string const& xwayland_path,
+    std::chrono::seconds idle_timeout) :
     wayland_connector{wayland_connector},
     dispatcher{std::make_shared<md::MultiplexingDispatchable>()},
     xserver_thread{std::make_unique<dispatch::ThreadedDispatcher>(
         "Mir/X11 Reader", dispatcher, []() { terminate_with_current_exception(); })},
     sockets{},
     dispatcher_fd{},
-    xwayland_path{xwayland_path}
+    xwayland_path{xwayland_path},
+    idle_timeout{idle_timeout},
+    idle_timer{std::make_unique<XWaylandIdleTimer>(idle_timeout)}
 {
     for (auto const& fd : sockets.fd)
     {
@@ -66,6 +73,11 @@ mf::XWaylandServer::XWaylandServer(
         mir::fatal_error("Cannot open any X11 socket (abstract or not)");
     }
 
+    if (idle_timeout > std::chrono::seconds::zero())
+    {
+        dispatcher_fd.push_back(std::make_shared<md::ReadableFd>(idle_timer->fd(), [this]{ idle_timeout_expired(); }));
+    }
+
     for (auto const& fd_dispatcher : dispatcher_fd)
     {
         dispatcher->add_watch(fd_dispatcher);
@@ -135,6 +147,7 @@ void mf::XWaylandServer::spawn()
         }
 
         mir::log_info("Starting Xwayland");
+        spawn_thread_started = std::chrono::steady_clock::now();
         spawn_thread_pid = fork();
 
         switch (spawn_thread_pid)
@@ -234,16 +247,35 @@ void mf::XWaylandServer::execl_xwayland(int wl_client_client_fd, int wm_client_f
 
 namespace
 {
-bool spin_wait_for(sig_atomic_t& xserver_ready)
+bool wait_for_ready(mir::Fd const& xserver_ready)
 {
     auto const end = std::chrono::steady_clock::now() + 5s;
 
-    while (std::chrono::steady_clock::now() < end && !xserver_ready)
+    // Wait on the eventfd written by the SIGUSR1 handler rather than polling a flag: a respawn
+    // shouldn't take up to an extra 100ms to notice that Xwayland is ready.
+    for (auto now = std::chrono::steady_clock::now(); now < end; now = std::chrono::steady_clock::now())
     {
-        std::this_thread::sleep_for(100ms);
+        pollfd ready{xserver_ready, POLLIN, 0};
+        auto const timeout = std::chrono::duration_cast<std::chrono::milliseconds>(end - now);
+        if (poll(&ready, 1, timeout.count() + 1) > 0)
+            return true;
     }
 
-    return xserver_ready;
+    return false;
+}
+
+/// The resident set size of process pid, in kB (or -1 if it is not known)
+auto resident_kb(pid_t pid) -> long
+{
+    std::ifstream status{"/proc/" + std::to_string(pid) + "/status"};
+
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            return std::stol(line.substr(6));
+    }
+
+    return -1;
 }
 }
 
@@ -253,16 +285,26 @@ void mf::XWaylandServer::connect_wm_to_xwayland(
     std::unique_lock<decltype(spawn_thread_mutex)>& spawn_thread_lock)
 {
     // We need to set up the signal handling before connecting wl_client_server_fd
-    static sig_atomic_t xserver_ready{ false };
+    static int xserver_ready{-1};
 
     // In practice, there ought to be no contention on xserver_ready, but let's be certain
     static std::mutex xserver_ready_mutex;
     std::lock_guard<decltype(xserver_ready_mutex)> lock{xserver_ready_mutex};
-    xserver_ready = false;
+    Fd const ready_fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (ready_fd < 0)
+    {
+        mir::fatal_error("Failed to create eventfd for Xwayland startup");
+    }
+    xserver_ready = ready_fd;
 
     struct sigaction action;
     struct sigaction old_action;
-    action.sa_handler = [](int) { xserver_ready = true; };
+    action.sa_handler = [](int)
+        {
+            uint64_t const one{1};
+            auto const written = write(xserver_ready, &one, sizeof one);
+            (void)written;
+        };
     sigemptyset(&action.sa_mask);
     action.sa_flags = 0;
     sigaction(SIGUSR1, &action, &old_action);
@@ -289,8 +331,9 @@ void mf::XWaylandServer::connect_wm_to_xwayland(
     }
 
     //The client can connect, now wait for it to signal ready (SIGUSR1)
-    auto const xwayland_startup_timed_out = !spin_wait_for(xserver_ready);
+    auto const xwayland_startup_timed_out = !wait_for_ready(ready_fd);
     sigaction(SIGUSR1, &old_action, nullptr);
+    xserver_ready = -1;
 
     if (xwayland_startup_timed_out)
     {
@@ -300,9 +343,17 @@ void mf::XWaylandServer::connect_wm_to_xwayland(
 
     try
     {
-        XWaylandWM wm{wayland_connector, client, wm_server_fd};
-        mir::log_info("XServer is running");
+        XWaylandWM wm{wayland_connector, client, wm_server_fd, [this](bool idle) { set_idle(idle); }};
+        mir::log_info(
+            "XServer is running (started in %lld ms)",
+            static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - spawn_thread_started).count()));
         spawn_thread_xserver_status = RUNNING;
+        spawn_thread_idle_shutdown = false;
+        spawn_thread_wm = &wm;
+
+        // Until an X11 client creates a window, there's nothing keeping Xwayland in use
+        set_idle(true);
         auto const pid = spawn_thread_pid; // For clarity only as this is only written on this thread
 
         // Unlock access to spawn_thread_* while Xwayland is running
@@ -310,8 +361,13 @@ void mf::XWaylandServer::connect_wm_to_xwayland(
         int status;
         waitpid(pid, &status, 0);  // Blocking
         spawn_thread_lock.lock();
+        spawn_thread_wm = nullptr;
+        set_idle(false);
 
-        if (WIFEXITED(status) || spawn_thread_terminate) {
+        if (spawn_thread_idle_shutdown) {
+            mir::log_info("Xserver stopped while idle, it will be restarted on the next X11 connection");
+            spawn_thread_xserver_status = STOPPED;
+        } else if (WIFEXITED(status) || spawn_thread_terminate) {
             mir::log_info("Xserver stopped");
             spawn_thread_xserver_status = STOPPED;
         } else {
@@ -457,6 +513,31 @@ void mf::XWaylandServer::new_spawn_thread()
     spawn_thread = std::thread{&mf::XWaylandServer::spawn, this};
 }
 
+void mf::XWaylandServer::set_idle(bool idle)
+{
+    idle_timer->set_idle(idle);
+}
+
+void mf::XWaylandServer::idle_timeout_expired()
+{
+    std::lock_guard<decltype(spawn_thread_mutex)> lock(spawn_thread_mutex);
+
+    if (spawn_thread_xserver_status != RUNNING || !spawn_thread_wm)
+        return;
+
+    auto const wm = spawn_thread_wm;
+    if (!idle_timer->expired([wm] { return wm->x11_client_count(); }))
+        return;
+
+    mir::log_info(
+        "Stopping Xwayland after %llds without X11 clients (%ld kB resident)",
+        static_cast<long long>(idle_timeout.count()),
+        resident_kb(spawn_thread_pid));
+
+    spawn_thread_idle_shutdown = true;
+    kill(spawn_thread_pid, SIGTERM);
+}
+
 auto mir::frontend::XWaylandServer::x11_display() const -> std::string
 {
     return std::string(":") + std::to_string(sockets.xdisplay);
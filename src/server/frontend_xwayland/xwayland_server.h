@@ -21,6 +21,7 @@
 
 #include "mir/fd.h"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -38,11 +39,18 @@ class MultiplexingDispatchable;
 namespace frontend
 {
 class WaylandConnector;
+class XWaylandIdleTimer;
+class XWaylandWM;
 
 class XWaylandServer
 {
 public:
-    XWaylandServer(std::shared_ptr<WaylandConnector> wayland_connector, std::string const& xwayland_path);
+    /// \param idle_timeout  how long Xwayland may run without any X11 clients before it is stopped
+    ///                      (it is started again on the next connection). Zero keeps it running.
+    XWaylandServer(
+        std::shared_ptr<WaylandConnector> wayland_connector,
+        std::string const& xwayland_path,
+        std::chrono::seconds idle_timeout);
     ~XWaylandServer();
 
     auto x11_display() const -> std::string;
@@ -58,6 +66,11 @@ private:
         Fd const& wm_server_fd,
         std::unique_lock<std::mutex>& spawn_thread_lock);
     void new_spawn_thread();
+    /// Called by the window manager as the last X11 window goes away (idle) or the first appears
+    void set_idle(bool idle);
+    /// Called on the dispatcher thread when the idle timer expires. Stops Xwayland unless X11 clients
+    /// are still connected (with no windows), in which case the timer is restarted.
+    void idle_timeout_expired();
 
     struct SocketFd
     {
@@ -81,12 +94,18 @@ private:
     SocketFd const sockets;
     std::vector<std::shared_ptr<dispatch::ReadableFd>> dispatcher_fd;
     std::string const xwayland_path;
+    std::chrono::seconds const idle_timeout;
+    std::unique_ptr<XWaylandIdleTimer> const idle_timer;
 
     std::mutex mutable spawn_thread_mutex;
     std::thread spawn_thread;
     pid_t spawn_thread_pid;
     Status spawn_thread_xserver_status{Status::STOPPED};
     bool spawn_thread_terminate{false};
+    bool spawn_thread_idle_shutdown{false};
+    std::chrono::steady_clock::time_point spawn_thread_started;
+    /// The window manager of the running Xwayland (only valid while RUNNING)
+    XWaylandWM* spawn_thread_wm{nullptr};
 };
 } /* frontend */
 } /* mir */
@@ -224,6 +224,12 @@ void mf::XWaylandSurface::map()
         connection->net_wm_desktop,
         workspace);
 
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (!weak_scene_surface.lock())
+            map_requested_at = std::chrono::steady_clock::now();
+    }
+
     state.withdrawn = false;
     inform_client_of_window_state(state);
     request_scene_surface_state(state.mir_window_state());
@@ -490,40 +496,43 @@ void mf::XWaylandSurface::wm_change_state_client_message(uint32_t const (&data)[
     request_scene_surface_state(new_window_state.mir_window_state());
 }
 
-void mf::XWaylandSurface::property_notify(xcb_atom_t property)
+auto mf::XWaylandSurface::read_changed_property(xcb_atom_t property)
+    -> std::experimental::optional<std::function<void()>>
 {
     auto const handler = property_handlers.find(property);
-    if (handler != property_handlers.end())
-    {
-        auto completion = handler->second();
-        completion();
+    if (handler == property_handlers.end())
+        return std::experimental::nullopt;
 
-        std::shared_ptr<scene::Surface> scene_surface;
-        std::experimental::optional<std::unique_ptr<shell::SurfaceSpecification>> spec;
+    return handler->second();
+}
 
-        {
-            std::lock_guard<std::mutex> lock{mutex};
-            scene_surface = weak_scene_surface.lock();
-            spec = consume_pending_spec(lock);
-        }
+void mf::XWaylandSurface::apply_property_changes()
+{
+    std::shared_ptr<scene::Surface> scene_surface;
+    std::experimental::optional<std::unique_ptr<shell::SurfaceSpecification>> spec;
 
-        if (spec && scene_surface)
-        {
-            if (spec.value()->application_id.is_set() &&
-                spec.value()->application_id.value() == scene_surface->application_id())
-                spec.value()->application_id.consume();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        scene_surface = weak_scene_surface.lock();
+        spec = consume_pending_spec(lock);
+    }
 
-            if (spec.value()->name.is_set() &&
-                spec.value()->name.value() == scene_surface->name())
-                spec.value()->name.consume();
+    if (spec && scene_surface)
+    {
+        if (spec.value()->application_id.is_set() &&
+            spec.value()->application_id.value() == scene_surface->application_id())
+            spec.value()->application_id.consume();
 
-            if (spec.value()->parent.is_set() &&
-                spec.value()->parent.value().lock() == scene_surface->parent())
-                spec.value()->parent.consume();
+        if (spec.value()->name.is_set() &&
+            spec.value()->name.value() == scene_surface->name())
+            spec.value()->name.consume();
 
-            if (!spec.value()->is_empty())
-                shell->modify_surface(scene_surface->session().lock(), scene_surface, *spec.value());
-        }
+        if (spec.value()->parent.is_set() &&
+            spec.value()->parent.value().lock() == scene_surface->parent())
+            spec.value()->parent.consume();
+
+        if (!spec.value()->is_empty())
+            shell->modify_surface(scene_surface->session().lock(), scene_surface, *spec.value());
     }
 }
 
@@ -604,9 +613,22 @@ void mf::XWaylandSurface::attach_wl_surface(WlSurface* wl_surface)
         std::experimental::nullopt,
         XCB_STACK_MODE_ABOVE);
 
+    std::experimental::optional<std::chrono::steady_clock::time_point> mapped_at;
     {
         std::lock_guard<std::mutex> lock{mutex};
         weak_scene_surface = surface;
+        std::swap(mapped_at, map_requested_at);
+    }
+
+    if (mapped_at)
+    {
+        auto const latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - mapped_at.value());
+        log_debug(
+            "%s shown %lld.%03lldms after being mapped",
+            connection->window_debug_string(window).c_str(),
+            static_cast<long long>(latency.count() / 1000),
+            static_cast<long long>(latency.count() % 1000));
     }
 
     xwm->remember_scene_surface(surface, window);
@@ -63,7 +63,12 @@ public:
     void configure_notify(xcb_configure_notify_event_t* event);
     void net_wm_state_client_message(uint32_t const (&data)[5]);
     void wm_change_state_client_message(uint32_t const (&data)[5]);
-    void property_notify(xcb_atom_t property);
+    /// Requests the new value of a changed property. Returns a function that waits for the value and
+    /// handles it, or nullopt if it is not a property we care about. Requesting several properties before
+    /// waiting for any of them means they cost a single round trip to the X server.
+    auto read_changed_property(xcb_atom_t property) -> std::experimental::optional<std::function<void()>>;
+    /// Sends changes read by read_changed_property() on to the scene surface
+    void apply_property_changes();
     void attach_wl_surface(WlSurface* wl_surface); ///< Should only be called on the Wayland thread
     void move_resize(uint32_t detail);
 
@@ -153,6 +158,9 @@ private:
     std::weak_ptr<scene::Session> weak_session;
     std::unique_ptr<shell::SurfaceSpecification> nullable_pending_spec;
     std::weak_ptr<scene::Surface> weak_scene_surface;
+
+    /// Set when the window is mapped, so the time until the scene surface is created can be logged
+    std::experimental::optional<std::chrono::steady_clock::time_point> map_requested_at;
 };
 } /* frontend */
 } /* mir */
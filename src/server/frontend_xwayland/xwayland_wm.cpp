@@ -20,6 +20,7 @@
 
 #include "xwayland_wm.h"
 #include "xwayland_log.h"
+#include "xwayland_property_notify_batch.h"
 #include "xwayland_surface.h"
 #include "xwayland_wm_shell.h"
 #include "xwayland_surface_role.h"
@@ -32,11 +33,13 @@
 #include "mir/scene/null_observer.h"
 #include "mir/frontend/surface_stack.h"
 
+#include <algorithm>
 #include <cstring>
 #include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <boost/throw_exception.hpp>
+#include <xcb/res.h>
 
 namespace mf = mir::frontend;
 namespace ms = mir::scene;
@@ -129,7 +132,11 @@ public:
     mf::XWaylandWM* const wm;
 };
 
-mf::XWaylandWM::XWaylandWM(std::shared_ptr<WaylandConnector> wayland_connector, wl_client* wayland_client, Fd const& fd)
+mf::XWaylandWM::XWaylandWM(
+    std::shared_ptr<WaylandConnector> wayland_connector,
+    wl_client* wayland_client,
+    Fd const& fd,
+    std::function<void(bool idle)> idle_changed)
     : connection{std::make_shared<XCBConnection>(fd)},
       wayland_connector(wayland_connector),
       wayland_client{wayland_client},
@@ -140,7 +147,8 @@ mf::XWaylandWM::XWaylandWM(std::shared_ptr<WaylandConnector> wayland_connector,
           fd, [this]() { handle_events(); })},
       event_thread{std::make_unique<mir::dispatch::ThreadedDispatcher>(
           "Mir/X11 WM Reader", wm_dispatcher, []() { mir::terminate_with_current_exception(); })},
-      scene_observer{std::make_shared<XWaylandSceneObserver>(this)}
+      scene_observer{std::make_shared<XWaylandSceneObserver>(this)},
+      idle_changed{std::move(idle_changed)}
 {
     check_xfixes(*connection);
 
@@ -287,6 +295,31 @@ void mf::XWaylandWM::forget_scene_surface(std::weak_ptr<scene::Surface> const& s
     scene_surface_set.erase(scene_surface);
 }
 
+auto mf::XWaylandWM::x11_client_count() -> size_t
+{
+    auto const cookie = xcb_res_query_clients(*connection);
+    auto const reply = xcb_res_query_clients_reply(*connection, cookie, nullptr);
+    if (!reply)
+    {
+        return 0;
+    }
+
+    // Neither Xwayland's own client (resource base 0) nor this window manager count
+    auto const wm_resource_base = xcb_get_setup(*connection)->resource_id_base;
+    size_t count = 0;
+
+    for (auto i = xcb_res_query_clients_clients_iterator(reply); i.rem; xcb_res_client_next(&i))
+    {
+        if (i.data->resource_base != 0 && i.data->resource_base != wm_resource_base)
+        {
+            ++count;
+        }
+    }
+
+    free(reply);
+    return count;
+}
+
 void mf::XWaylandWM::run_on_wayland_thread(std::function<void()>&& work)
 {
     wayland_connector->run_on_wayland_display([work = move(work)](auto){ work(); });
@@ -362,24 +395,59 @@ void mf::XWaylandWM::handle_events()
 {
     bool got_events = false;
 
+    // Runs of property changes (clients often set many properties at once) are read together, so they
+    // cost one round trip to the X server rather than one each. Other events flush the run first, so
+    // everything is still handled in order.
+    std::vector<xcb_property_notify_event_t> property_notifies;
+    auto const handle_pending_property_notifies = [&]()
+        {
+            if (property_notifies.empty())
+                return;
+
+            try
+            {
+                handle_property_notifies(property_notifies);
+            }
+            catch (...)
+            {
+                log(
+                    logging::Severity::warning,
+                    MIR_LOG_COMPONENT,
+                    std::current_exception(),
+                    "Failed to handle xcb property notify events.");
+            }
+            property_notifies.clear();
+        };
+
     while (xcb_generic_event_t* const event = xcb_poll_for_event(*connection))
     {
-        try
+        if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY)
         {
-            handle_event(event);
+            property_notifies.push_back(*reinterpret_cast<xcb_property_notify_event_t*>(event));
         }
-        catch (...)
+        else
         {
-            log(
-                logging::Severity::warning,
-                MIR_LOG_COMPONENT,
-                std::current_exception(),
-                "Failed to handle xcb event.");
+            handle_pending_property_notifies();
+
+            try
+            {
+                handle_event(event);
+            }
+            catch (...)
+            {
+                log(
+                    logging::Severity::warning,
+                    MIR_LOG_COMPONENT,
+                    std::current_exception(),
+                    "Failed to handle xcb event.");
+            }
         }
         free(event);
         got_events = true;
     }
 
+    handle_pending_property_notifies();
+
     if (got_events)
     {
         connection->flush();
@@ -444,7 +512,7 @@ void mf::XWaylandWM::handle_event(xcb_generic_event_t* event)
             log_debug("XCB_MAPPING_NOTIFY");
         break;
     case XCB_PROPERTY_NOTIFY:
-        handle_property_notify(reinterpret_cast<xcb_property_notify_event_t *>(event));
+        handle_property_notifies({*reinterpret_cast<xcb_property_notify_event_t *>(event)});
         break;
     case XCB_CLIENT_MESSAGE:
         handle_client_message(reinterpret_cast<xcb_client_message_event_t *>(event));
@@ -456,50 +524,67 @@ void mf::XWaylandWM::handle_event(xcb_generic_event_t* event)
     }
 }
 
-void mf::XWaylandWM::handle_property_notify(xcb_property_notify_event_t *event)
+void mf::XWaylandWM::handle_property_notifies(std::vector<xcb_property_notify_event_t> const& events)
 {
     if (verbose_xwayland_logging_enabled())
     {
-        if (event->state == XCB_PROPERTY_DELETE)
-        {
-            log_debug(
-                "XCB_PROPERTY_NOTIFY (%s).%s: deleted",
-                connection->window_debug_string(event->window).c_str(),
-                connection->query_name(event->atom).c_str());
-        }
-        else
+        std::vector<std::function<void()>> functions;
+        for (auto const& event : events)
         {
-            auto const log_prop = [this, event](std::string const& value)
-                {
-                    auto const prop_name = connection->query_name(event->atom);
-                    log_debug(
-                        "XCB_PROPERTY_NOTIFY (%s).%s: %s",
-                        connection->window_debug_string(event->window).c_str(),
-                        prop_name.c_str(),
-                        value.c_str());
-                };
-
-            auto const reply_function = connection->read_property(
-                event->window,
-                event->atom,
-                [this, log_prop](xcb_get_property_reply_t* reply)
-                {
-                    auto const reply_str = connection->reply_debug_string(reply);
-                    log_prop(reply_str);
-                },
-                [log_prop]()
-                {
-                    log_prop("Error getting value");
-                });
+            if (event.state == XCB_PROPERTY_DELETE)
+            {
+                log_debug(
+                    "XCB_PROPERTY_NOTIFY (%s).%s: deleted",
+                    connection->window_debug_string(event.window).c_str(),
+                    connection->query_name(event.atom).c_str());
+            }
+            else
+            {
+                auto const log_prop = [this, event](std::string const& value)
+                    {
+                        auto const prop_name = connection->query_name(event.atom);
+                        log_debug(
+                            "XCB_PROPERTY_NOTIFY (%s).%s: %s",
+                            connection->window_debug_string(event.window).c_str(),
+                            prop_name.c_str(),
+                            value.c_str());
+                    };
 
-            reply_function();
+                functions.push_back(connection->read_property(
+                    event.window,
+                    event.atom,
+                    [this, log_prop](xcb_get_property_reply_t* reply)
+                    {
+                        auto const reply_str = connection->reply_debug_string(reply);
+                        log_prop(reply_str);
+                    },
+                    [log_prop]()
+                    {
+                        log_prop("Error getting value");
+                    }));
+            }
         }
-    }
 
-    if (auto const surface = get_wm_surface(event->window))
-    {
-        surface.value()->property_notify(event->atom);
+        for (auto const& f : functions)
+            f();
     }
+
+    XWaylandPropertyNotifyBatch batch;
+    for (auto const& event : events)
+        batch.add(event.window, event.atom);
+
+    batch.handle(
+        [this](xcb_window_t window, xcb_atom_t property) -> std::experimental::optional<std::function<void()>>
+        {
+            if (auto const surface = get_wm_surface(window))
+                return surface.value()->read_changed_property(property);
+            return std::experimental::nullopt;
+        },
+        [this](xcb_window_t window)
+        {
+            if (auto const surface = get_wm_surface(window))
+                surface.value()->apply_property_changes();
+        });
 }
 
 void mf::XWaylandWM::handle_create_notify(xcb_create_notify_event_t *event)
@@ -568,6 +653,7 @@ void mf::XWaylandWM::handle_create_notify(xcb_create_notify_event_t *event)
             wm_shell->shell,
             event);
 
+        bool first_window;
         {
             std::lock_guard<std::mutex> lock{mutex};
 
@@ -575,8 +661,12 @@ void mf::XWaylandWM::handle_create_notify(xcb_create_notify_event_t *event)
                 BOOST_THROW_EXCEPTION(
                     std::runtime_error("X11 window " + std::to_string(event->window) + " created, but already known"));
 
+            first_window = surfaces.empty();
             surfaces[event->window] = surface;
         }
+
+        if (first_window)
+            idle_changed(false);
     }
 }
 
@@ -603,6 +693,7 @@ void mf::XWaylandWM::handle_destroy_notify(xcb_destroy_notify_event_t *event)
     }
 
     std::shared_ptr<XWaylandSurface> surface{nullptr};
+    bool last_window{false};
 
     {
         std::lock_guard<std::mutex> lock{mutex};
@@ -611,11 +702,15 @@ void mf::XWaylandWM::handle_destroy_notify(xcb_destroy_notify_event_t *event)
         {
             surface = iter->second;
             surfaces.erase(iter);
+            last_window = surfaces.empty();
         }
     }
 
     if (surface)
         surface->close();
+
+    if (last_window)
+        idle_changed(true);
 }
 
 void mf::XWaylandWM::handle_map_request(xcb_map_request_event_t *event)
@@ -23,9 +23,11 @@
 #include "wayland_connector.h"
 #include "xcb_connection.h"
 
+#include <functional>
 #include <map>
 #include <set>
 #include <thread>
+#include <vector>
 #include <experimental/optional>
 #include <mutex>
 
@@ -59,7 +61,12 @@ private:
 
 public:
     /// Takes ownership of the given FD
-    XWaylandWM(std::shared_ptr<WaylandConnector> wayland_connector, wl_client* wayland_client, Fd const& fd);
+    /// \param idle_changed  called with true when the last X11 window is destroyed, and false when there is one again
+    XWaylandWM(
+        std::shared_ptr<WaylandConnector> wayland_connector,
+        wl_client* wayland_client,
+        Fd const& fd,
+        std::function<void(bool idle)> idle_changed);
     ~XWaylandWM();
 
     auto get_wm_surface(xcb_window_t xcb_window) -> std::experimental::optional<std::shared_ptr<XWaylandSurface>>;
@@ -68,6 +75,8 @@ public:
     void remember_scene_surface(std::weak_ptr<scene::Surface> const& scene_surface, xcb_window_t window);
     void forget_scene_surface(std::weak_ptr<scene::Surface> const& scene_surface);
     void run_on_wayland_thread(std::function<void()>&& work);
+    /// The number of X11 clients connected to Xwayland, excluding the window manager (makes a round trip)
+    auto x11_client_count() -> size_t;
 
     void surfaces_reordered(scene::SurfaceSet const& affected_surfaces);
 
@@ -81,7 +90,7 @@ private:
     // Events
     void handle_create_notify(xcb_create_notify_event_t *event);
     void handle_motion_notify(xcb_motion_notify_event_t *event);
-    void handle_property_notify(xcb_property_notify_event_t *event);
+    void handle_property_notifies(std::vector<xcb_property_notify_event_t> const& events);
     void handle_map_request(xcb_map_request_event_t *event);
     void handle_surface_id(std::weak_ptr<XWaylandSurface> const& weak_surface, xcb_client_message_event_t *event);
     void handle_move_resize(std::shared_ptr<XWaylandSurface> surface, xcb_client_message_event_t *event);
@@ -100,6 +109,7 @@ private:
     std::shared_ptr<dispatch::ReadableFd> const wm_dispatcher;
     std::unique_ptr<dispatch::ThreadedDispatcher> const event_thread;
     std::shared_ptr<XWaylandSceneObserver> const scene_observer;
+    std::function<void(bool idle)> const idle_changed;
 
     std::mutex mutex;
     std::map<xcb_window_t, std::shared_ptr<XWaylandSurface>> surfaces;
@@ -232,6 +232,7 @@ mir::DefaultServerConfiguration::the_cursor()
                 primary_cursor = std::make_shared<mg::SoftwareCursor>(
                     the_buffer_allocator(),
                     the_main_loop(),
+                    the_main_loop(),
                     the_input_scene());
             }
 
@@ -22,8 +22,12 @@
 #include "mir/graphics/pixel_format_utils.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/buffer_properties.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/input/scene.h"
 #include "mir/renderer/sw/pixel_source.h"
+#include "mir/time/alarm.h"
+#include "mir/time/alarm_factory.h"
+#include "mir/lockable_callback.h"
 #include "mir/executor.h"
 
 #include <boost/throw_exception.hpp>
@@ -38,6 +42,9 @@ namespace mrs = mir::renderer::software;
 
 namespace
 {
+/// Enough to cycle through without ever having to write into a buffer a
+/// compositor might still be reading from
+size_t const max_pooled_buffers = 3;
 
 MirPixelFormat get_8888_format(std::vector<MirPixelFormat> const& formats)
 {
@@ -55,6 +62,30 @@ MirPixelFormat get_8888_format(std::vector<MirPixelFormat> const& formats)
     return mir_pixel_format_invalid;
 }
 
+auto stride_of(geom::Size size) -> geom::Stride
+{
+    return geom::Stride{size.width.as_uint32_t() * MIR_BYTES_PER_PIXEL(mir_pixel_format_argb_8888)};
+}
+
+// Takes the cursor's lock before the alarm's own, so the callback is
+// serialised with show()/hide() without risking lock inversion
+class AnimationCallback : public mir::LockableCallback
+{
+public:
+    AnimationCallback(std::mutex& guard, std::function<void()> const& callback)
+        : guard{guard},
+          callback{callback}
+    {
+    }
+
+    void operator()() override { callback(); }
+    void lock() override { guard.lock(); }
+    void unlock() override { guard.unlock(); }
+
+private:
+    std::mutex& guard;
+    std::function<void()> const callback;
+};
 }
 
 class mg::detail::CursorRenderable : public mg::Renderable
@@ -79,12 +110,13 @@ public:
 
     std::shared_ptr<mg::Buffer> buffer() const override
     {
+        std::lock_guard<std::mutex> lock{mutex};
         return buffer_;
     }
 
     geom::Rectangle screen_position() const override
     {
-        std::lock_guard<std::mutex> lock{position_mutex};
+        std::lock_guard<std::mutex> lock{mutex};
         return {position, buffer_->size()};
     }
 
@@ -110,26 +142,37 @@ public:
 
     void move_to(geom::Point new_position)
     {
-        std::lock_guard<std::mutex> lock{position_mutex};
+        std::lock_guard<std::mutex> lock{mutex};
+        position = new_position;
+    }
+
+    void replace_buffer(std::shared_ptr<mg::Buffer> const& new_buffer, geom::Point new_position)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        buffer_ = new_buffer;
         position = new_position;
     }
 
 private:
-    std::shared_ptr<mg::Buffer> const buffer_;
-    mutable std::mutex position_mutex;
+    mutable std::mutex mutex;
+    std::shared_ptr<mg::Buffer> buffer_;
     geom::Point position;
 };
 
 mg::SoftwareCursor::SoftwareCursor(
     std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
     std::shared_ptr<Executor> const& scene_executor,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
     std::shared_ptr<mi::Scene> const& scene)
     : allocator{allocator},
       scene{scene},
       format{get_8888_format(allocator->supported_pixel_formats())},
       scene_executor{scene_executor},
       visible(false),
-      hotspot{0,0}
+      hotspot{0,0},
+      animation_frame{0},
+      animation_alarm{alarm_factory->create_alarm(
+          std::make_unique<AnimationCallback>(guard, [this] { advance_animation(); }))}
 {
 }
 
@@ -142,53 +185,137 @@ void mg::SoftwareCursor::show(CursorImage const& cursor_image)
 {
     std::lock_guard<std::mutex> lg{guard};
 
-    auto const to_remove = visible ? renderable : nullptr;
+    start_animation_locked(cursor_image);
+    show_locked(
+        static_cast<unsigned char const*>(cursor_image.as_argb_8888()),
+        cursor_image.size(),
+        cursor_image.hotspot());
+}
+
+void mg::SoftwareCursor::show_locked(
+    unsigned char const* pixels,
+    geom::Size size,
+    geom::Displacement new_hotspot)
+{
+    if (size.width.as_uint32_t() == 0 || size.height.as_uint32_t() == 0)
+        BOOST_THROW_EXCEPTION(std::logic_error("zero sized software cursor image is invalid"));
+
+    auto const buffer = buffer_for_locked(pixels, size);
 
     geom::Point position{0,0};
     if (renderable)
         position = renderable->screen_position().top_left;
+    position = position + hotspot - new_hotspot;
+    hotspot = new_hotspot;
 
-    renderable = create_renderable_for(cursor_image, position);
-    hotspot = cursor_image.hotspot();
-    visible = true;
+    if (!renderable)
+    {
+        renderable = std::make_shared<detail::CursorRenderable>(buffer, position);
+    }
+    else if (visible)
+    {
+        // The renderable is already in the scene: update it in place and
+        // redraw only what it covered before and covers now.
+        auto const old_area = renderable->screen_position();
+        renderable->replace_buffer(buffer, position);
+        emit_damage(geom::Rectangles{old_area, renderable->screen_position()}.bounding_rectangle());
+        return;
+    }
+    else
+    {
+        renderable->replace_buffer(buffer, position);
+    }
 
-    scene_executor->spawn([scene = scene, to_remove = to_remove, to_add = renderable]()
+    visible = true;
+    scene_executor->spawn([scene = scene, to_add = renderable]()
         {
-            // Add the new renderable first, then remove the old one to avoid visual glitches
             scene->add_input_visualization(to_add);
-
-            if (to_remove)
-            {
-                scene->remove_input_visualization(to_remove);
-            }
         });
 }
 
-std::shared_ptr<mg::detail::CursorRenderable>
-mg::SoftwareCursor::create_renderable_for(CursorImage const& cursor_image, geom::Point position)
+auto mg::SoftwareCursor::buffer_for_locked(unsigned char const* pixels, geom::Size size)
+    -> std::shared_ptr<Buffer>
 {
-    if (cursor_image.size().width.as_uint32_t() == 0 || cursor_image.size().height.as_uint32_t() == 0)
-        BOOST_THROW_EXCEPTION(std::logic_error("zero sized software cursor image is invalid"));
+    if (!buffer_pool.empty() && buffer_pool.front()->size() != size)
+        buffer_pool.clear();
+
+    for (auto const& buffer : buffer_pool)
+    {
+        // Only we hold it: it's neither in the renderable nor being composited
+        if (buffer.use_count() == 1)
+        {
+            mrs::write_buffer_content(buffer, pixels, stride_of(size));
+            return buffer;
+        }
+    }
 
     auto buffer = mrs::alloc_buffer_with_content(
         *allocator,
-        static_cast<unsigned char const*>(cursor_image.as_argb_8888()),
-        cursor_image.size(),
-        geom::Stride{
-            cursor_image.size().width.as_uint32_t() * MIR_BYTES_PER_PIXEL(mir_pixel_format_argb_8888)},
+        pixels,
+        size,
+        stride_of(size),
         mir_pixel_format_argb_8888);
 
-    auto new_renderable = std::make_shared<detail::CursorRenderable>(
-        std::move(buffer),
-        position + hotspot - cursor_image.hotspot());
+    if (buffer_pool.size() < max_pooled_buffers)
+        buffer_pool.push_back(buffer);
 
-    return new_renderable;
+    return buffer;
+}
+
+void mg::SoftwareCursor::start_animation_locked(CursorImage const& cursor_image)
+{
+    animation.clear();
+    animation_frame = 0;
+    animation_alarm->cancel();
+
+    auto const animated = dynamic_cast<AnimatedCursorImage const*>(&cursor_image);
+    if (!animated || animated->frame_count() < 2)
+        return;
+
+    // The image is only borrowed for the duration of show(), so keep our own copy of the frames
+    for (size_t i = 0; i != animated->frame_count(); ++i)
+    {
+        auto const& frame = animated->frame(i);
+        auto const pixels = static_cast<unsigned char const*>(frame.as_argb_8888());
+        auto const length = stride_of(frame.size()).as_uint32_t() * frame.size().height.as_uint32_t();
+
+        animation.push_back(AnimationFrame{
+            {pixels, pixels + length},
+            frame.size(),
+            frame.hotspot(),
+            animated->frame_duration(i)});
+    }
+
+    animation_alarm->reschedule_in(animation.front().duration);
+}
+
+void mg::SoftwareCursor::advance_animation()
+{
+    // Called by animation_alarm with guard held
+    if (animation.empty() || !visible)
+        return;
+
+    animation_frame = (animation_frame + 1) % animation.size();
+    auto const& frame = animation[animation_frame];
+
+    show_locked(frame.pixels.data(), frame.size, frame.hotspot);
+    animation_alarm->reschedule_in(frame.duration);
+}
+
+void mg::SoftwareCursor::emit_damage(geom::Rectangle const& damage)
+{
+    scene_executor->spawn([scene = scene, damage]()
+        {
+            scene->emit_scene_damaged(damage);
+        });
 }
 
 void mg::SoftwareCursor::hide()
 {
     std::lock_guard<std::mutex> lg{guard};
 
+    animation_alarm->cancel();
+
     if (visible && renderable)
     {
         scene_executor->spawn([scene = scene, to_remove = renderable]()
@@ -202,15 +329,22 @@ void mg::SoftwareCursor::hide()
 
 void mg::SoftwareCursor::move_to(geometry::Point position)
 {
+    geom::Rectangle damage;
     {
         std::lock_guard<std::mutex> lg{guard};
 
         if (!renderable)
             return;
 
+        auto const old_area = renderable->screen_position();
         renderable->move_to(position - hotspot);
+
+        if (!visible)
+            return;
+
+        damage = geom::Rectangles{old_area, renderable->screen_position()}.bounding_rectangle();
     }
 
     // This doesn't need to be called in a specific order with other potential calls, so it doesn't go on the executor
-    scene->emit_scene_changed();
+    scene->emit_scene_damaged(damage);
 }
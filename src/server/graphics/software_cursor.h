@@ -22,14 +22,21 @@
 #include "mir/graphics/cursor.h"
 #include "mir_toolkit/client_types.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/rectangle.h"
+
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace mir
 {
 class Executor;
 namespace input { class Scene; }
+namespace time { class Alarm; class AlarmFactory; }
 namespace graphics
 {
+class Buffer;
 class GraphicBufferAllocator;
 class Renderable;
 
@@ -44,6 +51,7 @@ public:
     SoftwareCursor(
         std::shared_ptr<GraphicBufferAllocator> const& allocator,
         std::shared_ptr<Executor> const& scene_executor,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
         std::shared_ptr<input::Scene> const& scene);
     ~SoftwareCursor();
 
@@ -52,8 +60,22 @@ public:
     void move_to(geometry::Point position) override;
 
 private:
-    std::shared_ptr<detail::CursorRenderable> create_renderable_for(
-        CursorImage const& cursor_image, geometry::Point position);
+    struct AnimationFrame
+    {
+        std::vector<unsigned char> pixels;
+        geometry::Size size;
+        geometry::Displacement hotspot;
+        std::chrono::milliseconds duration;
+    };
+
+    void show_locked(
+        unsigned char const* pixels,
+        geometry::Size size,
+        geometry::Displacement new_hotspot);
+    auto buffer_for_locked(unsigned char const* pixels, geometry::Size size) -> std::shared_ptr<Buffer>;
+    void start_animation_locked(CursorImage const& cursor_image);
+    void advance_animation();
+    void emit_damage(geometry::Rectangle const& damage);
 
     std::shared_ptr<GraphicBufferAllocator> const allocator;
     std::shared_ptr<input::Scene> const scene;
@@ -67,6 +89,15 @@ private:
     std::shared_ptr<detail::CursorRenderable> renderable;
     bool visible;
     geometry::Displacement hotspot;
+
+    /// Buffers of the current cursor size we have drawn into before. One that is
+    /// no longer referenced by the renderable (or a compositor) can be rewritten
+    /// in place, rather than allocating a buffer for every image change.
+    std::vector<std::shared_ptr<Buffer>> buffer_pool;
+
+    std::vector<AnimationFrame> animation;
+    size_t animation_frame;
+    std::unique_ptr<time::Alarm> const animation_alarm;
 };
 
 }
@@ -24,6 +24,7 @@
 #include "mir/scene/surface.h"
 #include "mir/scene/null_surface_observer.h"
 #include "mir/events/event_builders.h"
+#include "mir/report/timeline.h"
 #include "mir_toolkit/mir_cookie.h"
 
 #include <string.h>
@@ -36,6 +37,7 @@ namespace mi = mir::input;
 namespace ms = mir::scene;
 namespace mev = mir::events;
 namespace geom = mir::geometry;
+namespace mrt = mir::report::timeline;
 
 namespace
 {
@@ -636,7 +638,9 @@ bool mi::SurfaceInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const&
 {
     if (mir_event_get_type(event.get()) != mir_event_type_input)
         BOOST_THROW_EXCEPTION(std::logic_error("InputDispatcher got an unexpected event type"));
-    
+
+    mrt::Span const span{"input dispatch"};
+
     auto iev = mir_event_get_input_event(event.get());
     auto id = mir_input_event_get_device_id(iev);
     switch (mir_input_event_get_type(iev))
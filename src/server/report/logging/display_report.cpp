@@ -88,6 +88,17 @@ void mrl::DisplayReport::report_vt_switch_back_failure()
     logger->log(ml::Severity::warning, "Failed to switch back to Mir VT.", component());
 }
 
+void mrl::DisplayReport::report_configuration_phase(char const* phase, std::chrono::nanoseconds duration)
+{
+    // long long to match printf format on all architectures
+    long long const duration_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+    logger->log(component(), ml::Severity::informational,
+        "Display configuration: %s took %lld.%03lldms",
+        phase,
+        duration_us/1000, duration_us%1000);
+}
+
 void mrl::DisplayReport::report_egl_configuration(EGLDisplay disp, EGLConfig config)
 {
     auto ext = eglQueryString(disp, EGL_EXTENSIONS);
@@ -59,6 +59,7 @@ class DisplayReport : public graphics::DisplayReport
     virtual void report_drm_master_failure(int error) override;
     virtual void report_vt_switch_away_failure() override;
     virtual void report_vt_switch_back_failure() override;
+    virtual void report_configuration_phase(char const* phase, std::chrono::nanoseconds duration) override;
     virtual void report_egl_configuration(EGLDisplay disp, EGLConfig cfg) override;
 
   protected:
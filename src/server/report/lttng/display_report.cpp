@@ -47,6 +47,13 @@ void mir::report::lttng::DisplayReport::report_drm_master_failure(int error)
     mir_tracepoint(mir_server_display, report_drm_master_failure, strerror(error));
 }
 
+void mir::report::lttng::DisplayReport::report_configuration_phase(
+    char const* phase,
+    std::chrono::nanoseconds duration)
+{
+    mir_tracepoint(mir_server_display, report_configuration_phase, phase, duration.count());
+}
+
 void mir::report::lttng::DisplayReport::report_vsync(unsigned int output_id,
                                                      mir::graphics::Frame const&)
 {
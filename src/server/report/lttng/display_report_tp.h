@@ -62,6 +62,16 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_display,
+    report_configuration_phase,
+    TP_ARGS(char const*, phase, int64_t, duration_ns),
+    TP_FIELDS(
+        ctf_string(phase, phase)
+        ctf_integer(int64_t, duration_ns, duration_ns)
+     )
+)
+
 TRACEPOINT_EVENT(
     mir_server_display,
     report_vsync,
@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compositor_report.h"
+#include "registry.h"
+
+#include <cstdio>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+std::atomic<uint64_t> next_generation{1};
+}
+
+thread_local mrm::CompositorReport::CachedOutput mrm::CompositorReport::cached_output{0, nullptr, nullptr};
+
+mrm::CompositorReport::CompositorReport(
+    std::shared_ptr<Registry> const& registry,
+    std::shared_ptr<time::Clock> const& clock) :
+    registry{registry},
+    clock{clock},
+    generation{next_generation++}
+{
+}
+
+void mrm::CompositorReport::added_display(int width, int height, int x, int y, SubCompositorId id)
+{
+    char name[64];
+    snprintf(name, sizeof name, "%dx%d%+d%+d", width, height, x, y);
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    auto& output = add_output(id, name);
+
+    // The display is added on the thread that will composite it
+    cached_output = CachedOutput{generation, id, &output};
+}
+
+void mrm::CompositorReport::began_frame(SubCompositorId id)
+{
+    auto& output = output_for(id);
+    output.start_of_frame = clock->now();
+    output.rendered = false;
+}
+
+void mrm::CompositorReport::renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables)
+{
+    output_for(id).renderables->record(renderables.size());
+}
+
+void mrm::CompositorReport::rendered_frame(SubCompositorId id)
+{
+    output_for(id).rendered = true;
+}
+
+void mrm::CompositorReport::finished_frame(SubCompositorId id)
+{
+    auto& output = output_for(id);
+
+    output.frame_time->record(clock->now() - output.start_of_frame);
+    output.frames->add();
+    if (!output.rendered)
+        output.bypassed_frames->add();
+}
+
+void mrm::CompositorReport::stopped()
+{
+    // The compositors (and so the ids) are recreated when the compositor is restarted. The compositing
+    // threads have finished by now, so none of them is using a cached Output.
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    generation = next_generation++;
+    outputs.clear();
+}
+
+auto mrm::CompositorReport::output_for(SubCompositorId id) -> Output&
+{
+    auto const current_generation = generation.load(std::memory_order_relaxed);
+    if (cached_output.generation == current_generation && cached_output.id == id)
+        return *cached_output.output;
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const existing = outputs.find(id);
+    auto& output = existing != outputs.end() ?
+        *existing->second :
+        // We weren't told about this display, so label it with the order we saw it in
+        add_output(id, "unknown-" + std::to_string(outputs.size()));
+
+    cached_output = CachedOutput{current_generation, id, &output};
+    return output;
+}
+
+auto mrm::CompositorReport::add_output(SubCompositorId id, std::string const& name) -> Output&
+{
+    Labels const labels{{"output", name}};
+
+    auto output = std::make_unique<Output>();
+    output->frames = registry->counter(
+        "mir_compositor_frames", "Frames composited", labels);
+    output->bypassed_frames = registry->counter(
+        "mir_compositor_bypassed_frames", "Frames that were scanned out from a client buffer without rendering", labels);
+    output->frame_time = registry->histogram(
+        "mir_compositor_frame_time_seconds", "Time taken to composite a frame", 14, 27, 1e-9, labels);
+    output->renderables = registry->histogram(
+        "mir_compositor_renderables_per_frame", "Renderables in a frame", 0, 8, 1, labels);
+
+    auto& result = *output;
+    outputs[id] = std::move(output);
+    return result;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+#define MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+
+#include "../null/compositor_report.h"
+#include "mir/time/clock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Histogram;
+
+/// Records per-output frame counts and timings. Outputs are labelled with their geometry.
+class CompositorReport : public null::CompositorReport
+{
+public:
+    CompositorReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock);
+
+    void added_display(int width, int height, int x, int y, SubCompositorId id) override;
+    void began_frame(SubCompositorId id) override;
+    void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
+    void rendered_frame(SubCompositorId id) override;
+    void finished_frame(SubCompositorId id) override;
+    void stopped() override;
+
+private:
+    struct Output
+    {
+        std::shared_ptr<Counter> frames;
+        std::shared_ptr<Counter> bypassed_frames;
+        std::shared_ptr<Histogram> frame_time;
+        std::shared_ptr<Histogram> renderables;
+
+        time::Timestamp start_of_frame;
+        bool rendered{false};
+    };
+
+    /// Each compositing thread draws a single output, and remembers it (from added_display()) so that
+    /// reporting a frame doesn't have to lock the map. Only that thread uses its Output.
+    struct CachedOutput
+    {
+        uint64_t generation;
+        SubCompositorId id;
+        Output* output;
+    };
+    static thread_local CachedOutput cached_output;
+
+    auto output_for(SubCompositorId id) -> Output&;
+    auto add_output(SubCompositorId id, std::string const& name) -> Output&;
+
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<time::Clock> const clock;
+
+    /// Changed (to a value no CompositorReport has used) whenever outputs is cleared, invalidating cached_output
+    std::atomic<uint64_t> generation;
+
+    std::mutex mutex;
+    std::unordered_map<SubCompositorId, std::unique_ptr<Output>> outputs;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_ */
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "display_report.h"
+#include "registry.h"
+
+#include "mir/graphics/frame.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::DisplayReport::DisplayReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry}
+{
+}
+
+void mrm::DisplayReport::report_vsync(unsigned int output_id, graphics::Frame const& frame)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto output = outputs.find(output_id);
+    if (output == outputs.end())
+    {
+        Labels const labels{{"output", std::to_string(output_id)}};
+        output = outputs.emplace(output_id, Output{
+            registry->counter("mir_display_flips", "Page flips completed", labels),
+            registry->counter(
+                "mir_display_skipped_vblanks",
+                "Vertical blanks that passed between two page flips (while the display showed the same frame)",
+                labels),
+            frame.msc}).first;
+    }
+    else if (frame.msc > output->second.last_msc + 1)
+    {
+        output->second.skipped_vblanks->add(frame.msc - output->second.last_msc - 1);
+    }
+
+    output->second.flips->add();
+    output->second.last_msc = frame.msc;
+}
+
+void mrm::DisplayReport::report_configuration_phase(char const* phase, std::chrono::nanoseconds duration)
+{
+    registry->histogram(
+        "mir_display_configuration_seconds", "Time taken by each phase of applying a display configuration",
+        20, 32, 1e-9, {{"phase", phase}})->record(duration);
+}
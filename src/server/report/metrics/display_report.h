@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_DISPLAY_REPORT_H_
+#define MIR_REPORT_METRICS_DISPLAY_REPORT_H_
+
+#include "../null/display_report.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Histogram;
+
+/// Records page flips (and the vblanks that passed without one) per output
+class DisplayReport : public null::DisplayReport
+{
+public:
+    explicit DisplayReport(std::shared_ptr<Registry> const& registry);
+
+    void report_vsync(unsigned int output_id, graphics::Frame const& frame) override;
+    void report_configuration_phase(char const* phase, std::chrono::nanoseconds duration) override;
+
+private:
+    struct Output
+    {
+        std::shared_ptr<Counter> flips;
+        std::shared_ptr<Counter> skipped_vblanks;
+        int64_t last_msc;
+    };
+
+    std::shared_ptr<Registry> const registry;
+
+    std::mutex mutex;
+    std::unordered_map<unsigned int, Output> outputs;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_DISPLAY_REPORT_H_ */
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exporter.h"
+#include "registry.h"
+
+#include "mir/dispatch/readable_fd.h"
+#include "mir/dispatch/threaded_dispatcher.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+/// Removes a socket left behind by a server that has gone, but won't replace anything else at path
+void remove_if_stale(std::string const& path, sockaddr_un const& address)
+{
+    struct stat info;
+    if (lstat(path.c_str(), &info) < 0)
+    {
+        if (errno == ENOENT)
+            return;
+
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to check metrics socket " + path));
+    }
+
+    if (!S_ISSOCK(info.st_mode))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Metrics socket path exists and is not a socket: " + path));
+
+    mir::Fd const probe{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (probe < 0)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to create metrics socket"));
+
+    if (connect(probe, reinterpret_cast<sockaddr const*>(&address), sizeof address) == 0)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Metrics socket is already in use: " + path));
+
+    if (errno != ECONNREFUSED)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to check metrics socket " + path));
+
+    if (unlink(path.c_str()) < 0 && errno != ENOENT)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to remove stale metrics socket " + path));
+}
+
+auto listening_socket(std::string const& path) -> mir::Fd
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof address.sun_path)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Metrics socket path is too long: " + path));
+
+    strncpy(address.sun_path, path.c_str(), sizeof address.sun_path - 1);
+
+    mir::Fd const fd{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (fd < 0)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to create metrics socket"));
+
+    remove_if_stale(path, address);
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof address) < 0)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to bind metrics socket " + path));
+
+    if (listen(fd, 4) < 0)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to listen on metrics socket " + path));
+
+    return fd;
+}
+}
+
+mrm::Exporter::Exporter(std::shared_ptr<Registry> const& registry, std::string const& socket_path) :
+    registry{registry},
+    socket_path{socket_path},
+    socket{listening_socket(socket_path)},
+    thread{std::make_unique<dispatch::ThreadedDispatcher>(
+        "Mir/Metrics",
+        std::make_shared<dispatch::ReadableFd>(socket, [this] { serve_connection(); }))}
+{
+}
+
+mrm::Exporter::~Exporter()
+{
+    unlink(socket_path.c_str());
+}
+
+void mrm::Exporter::serve_connection()
+{
+    Fd const connection{accept4(socket, nullptr, nullptr, SOCK_CLOEXEC)};
+    if (connection < 0)
+        return;
+
+    // Don't let a client that doesn't read hold up the next one
+    timeval const timeout{1, 0};
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+    std::ostringstream out;
+    registry->write_to(out);
+    auto const text = out.str();
+
+    for (size_t written = 0; written < text.size();)
+    {
+        auto const result = send(connection, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        written += result;
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_EXPORTER_H_
+#define MIR_REPORT_METRICS_EXPORTER_H_
+
+#include "mir/fd.h"
+
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace dispatch
+{
+class ThreadedDispatcher;
+}
+namespace report
+{
+namespace metrics
+{
+class Registry;
+
+/// Listens on a Unix socket and writes the registry (in OpenMetrics text format) to each connection,
+/// then closes it. E.g. `socat - UNIX-CONNECT:<path>`
+class Exporter
+{
+public:
+    Exporter(std::shared_ptr<Registry> const& registry, std::string const& socket_path);
+    ~Exporter();
+
+private:
+    void serve_connection();
+
+    std::shared_ptr<Registry> const registry;
+    std::string const socket_path;
+    Fd const socket;
+    std::unique_ptr<dispatch::ThreadedDispatcher> const thread;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_EXPORTER_H_ */
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_report.h"
+#include "registry.h"
+
+#include <linux/input.h>
+
+#include <chrono>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+auto latency_histogram(mrm::Registry& registry, char const* type) -> std::shared_ptr<mrm::Histogram>
+{
+    return registry.histogram(
+        "mir_input_event_latency_seconds",
+        "Time from the kernel timestamping an input event to Mir receiving it",
+        10, 27, 1e-9, {{"type", type}});
+}
+}
+
+mrm::InputReport::InputReport(std::shared_ptr<Registry> const& registry) :
+    key_latency{latency_histogram(*registry, "key")},
+    relative_latency{latency_histogram(*registry, "relative")},
+    absolute_latency{latency_histogram(*registry, "absolute")},
+    other_latency{latency_histogram(*registry, "other")}
+{
+}
+
+void mrm::InputReport::received_event_from_kernel(int64_t when, int type, int /*code*/, int /*value*/)
+{
+    // Kernel input timestamps are CLOCK_MONOTONIC, as is steady_clock
+    auto const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    auto const latency = now - std::chrono::nanoseconds{when};
+
+    switch (type)
+    {
+    case EV_KEY: key_latency->record(latency); break;
+    case EV_REL: relative_latency->record(latency); break;
+    case EV_ABS: absolute_latency->record(latency); break;
+    default:     other_latency->record(latency); break;
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_INPUT_REPORT_H_
+#define MIR_REPORT_METRICS_INPUT_REPORT_H_
+
+#include "../null/input_report.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Histogram;
+
+/// Records how long input events take to reach us from the kernel, by evdev event type
+class InputReport : public null::InputReport
+{
+public:
+    explicit InputReport(std::shared_ptr<Registry> const& registry);
+
+    void received_event_from_kernel(int64_t when, int type, int code, int value) override;
+
+private:
+    std::shared_ptr<Histogram> const key_latency;
+    std::shared_ptr<Histogram> const relative_latency;
+    std::shared_ptr<Histogram> const absolute_latency;
+    std::shared_ptr<Histogram> const other_latency;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_INPUT_REPORT_H_ */
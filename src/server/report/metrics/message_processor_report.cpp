@@ -0,0 +1,124 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "message_processor_report.h"
+#include "registry.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+std::atomic<uint64_t> next_report_id{1};
+}
+
+thread_local mrm::MessageProcessorReport::ThreadState mrm::MessageProcessorReport::thread_state{
+    0, {}, nullptr, 0, nullptr, {}};
+
+mrm::MessageProcessorReport::MessageProcessorReport(
+    std::shared_ptr<Registry> const& registry,
+    std::shared_ptr<time::Clock> const& clock) :
+    registry{registry},
+    clock{clock},
+    exceptions{registry->counter("mir_ipc_exceptions", "Client requests that threw an exception")},
+    report_id{next_report_id++}
+{
+}
+
+void mrm::MessageProcessorReport::received_invocation(void const* mediator, int id, std::string const& method)
+{
+    auto& state = state_for_this_thread();
+    auto const m = method_for(state, method);
+
+    m->invocations->add();
+
+    state.mediator = mediator;
+    state.id = id;
+    state.method = m;
+    state.start = clock->now();
+}
+
+void mrm::MessageProcessorReport::completed_invocation(void const* mediator, int id, bool /*result*/)
+{
+    auto& state = state_for_this_thread();
+
+    if (state.method && state.mediator == mediator && state.id == id)
+    {
+        state.method->duration->record(clock->now() - state.start);
+        state.method = nullptr;
+    }
+}
+
+void mrm::MessageProcessorReport::unknown_method(void const* mediator, int id, std::string const& /*method*/)
+{
+    forget_invocation(mediator, id);
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const* mediator, int id, std::exception const& /*error*/)
+{
+    exceptions->add();
+    forget_invocation(mediator, id);
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const* /*mediator*/, std::exception const& /*error*/)
+{
+    exceptions->add();
+}
+
+auto mrm::MessageProcessorReport::state_for_this_thread() -> ThreadState&
+{
+    auto& state = thread_state;
+
+    if (state.report != report_id)
+    {
+        // This thread was last used with another report
+        state.report = report_id;
+        state.methods.clear();
+        state.method = nullptr;
+    }
+
+    return state;
+}
+
+auto mrm::MessageProcessorReport::method_for(ThreadState& state, std::string const& method) -> Method const*
+{
+    auto const cached = state.methods.find(method);
+    if (cached != state.methods.end())
+        return cached->second;
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto m = methods.find(method);
+    if (m == methods.end())
+    {
+        Labels const labels{{"method", method}};
+        m = methods.emplace(method, Method{
+            registry->counter("mir_ipc_invocations", "Client requests received", labels),
+            registry->histogram(
+                "mir_ipc_invocation_seconds", "Time taken to handle a client request", 10, 27, 1e-9, labels)}).first;
+    }
+
+    // Methods are never removed, and unordered_map doesn't move its elements
+    state.methods.emplace(method, &m->second);
+    return &m->second;
+}
+
+void mrm::MessageProcessorReport::forget_invocation(void const* mediator, int id)
+{
+    auto& state = state_for_this_thread();
+
+    if (state.mediator == mediator && state.id == id)
+        state.method = nullptr;
+}
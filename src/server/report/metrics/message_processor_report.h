@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+#define MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+
+#include "mir/frontend/message_processor_report.h"
+#include "mir/time/clock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Histogram;
+
+/// Records the number and duration of client requests, by method.
+///
+/// A connection's requests are handled one at a time, each on a single thread (from received_invocation()
+/// to completed_invocation()), so the request in progress is tracked per thread without locking. That
+/// also copes with the submission ring's entries, which all share an invocation id.
+class MessageProcessorReport : public frontend::MessageProcessorReport
+{
+public:
+    MessageProcessorReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock);
+
+    void received_invocation(void const* mediator, int id, std::string const& method) override;
+    void completed_invocation(void const* mediator, int id, bool result) override;
+    void unknown_method(void const* mediator, int id, std::string const& method) override;
+    void exception_handled(void const* mediator, int id, std::exception const& error) override;
+    void exception_handled(void const* mediator, std::exception const& error) override;
+
+private:
+    struct Method
+    {
+        std::shared_ptr<Counter> invocations;
+        std::shared_ptr<Histogram> duration;
+    };
+
+    /// The methods this thread has looked up, and the request it is handling
+    struct ThreadState
+    {
+        uint64_t report;
+        std::unordered_map<std::string, Method const*> methods;
+
+        void const* mediator;
+        int id;
+        Method const* method;
+        time::Timestamp start;
+    };
+    static thread_local ThreadState thread_state;
+
+    auto state_for_this_thread() -> ThreadState&;
+    auto method_for(ThreadState& state, std::string const& method) -> Method const*;
+    void forget_invocation(void const* mediator, int id);
+
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<time::Clock> const clock;
+    std::shared_ptr<Counter> const exceptions;
+    uint64_t const report_id;   ///< Distinguishes this report's thread_state from earlier ones'
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Method> methods;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_ */
@@ -0,0 +1,281 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "registry.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+void write_escaped(std::ostream& out, std::string const& value)
+{
+    for (auto const c : value)
+    {
+        switch (c)
+        {
+        case '\\': out << "\\\\"; break;
+        case '"':  out << "\\\""; break;
+        case '\n': out << "\\n"; break;
+        default:   out << c;
+        }
+    }
+}
+
+/// Writes {name="value",...}, with extra (if not null) as the last label
+void write_labels(std::ostream& out, mrm::Labels const& labels, char const* extra_name = nullptr, std::string const& extra_value = {})
+{
+    if (labels.empty() && !extra_name)
+        return;
+
+    auto separator = "{";
+    for (auto const& label : labels)
+    {
+        out << separator << label.first << "=\"";
+        write_escaped(out, label.second);
+        out << '"';
+        separator = ",";
+    }
+
+    if (extra_name)
+        out << separator << extra_name << "=\"" << extra_value << '"';
+
+    out << '}';
+}
+
+auto as_string(double value) -> std::string
+{
+    if (value == std::numeric_limits<double>::infinity())
+        return "+Inf";
+
+    std::ostringstream out;
+    out.precision(std::numeric_limits<double>::max_digits10);
+    out << value;
+    return out.str();
+}
+}
+
+mrm::Histogram::Histogram(unsigned min_exponent, unsigned max_exponent, double scale) :
+    min_exponent{min_exponent},
+    max_exponent{std::max(min_exponent, std::min(max_exponent, 63u))},
+    scale{scale}
+{
+    for (auto& count : counts)
+        count.store(0, std::memory_order_relaxed);
+}
+
+auto mrm::Histogram::bucket_for(uint64_t value) -> unsigned
+{
+    if (value < 4)
+        return value;
+
+    unsigned const exponent = 63 - __builtin_clzll(value);
+    unsigned const quarter = (value >> (exponent - 2)) & 3;
+    return 4 + (exponent - 2)*4 + quarter;
+}
+
+auto mrm::Histogram::lower_bound_of(unsigned bucket) -> uint64_t
+{
+    if (bucket < 4)
+        return bucket;
+
+    auto const exponent = 2 + (bucket - 4)/4;
+    auto const quarter = (bucket - 4)%4;
+    return uint64_t{4 + quarter} << (exponent - 2);
+}
+
+void mrm::Histogram::record(uint64_t value)
+{
+    // Offset by one, so that a bucket holds (lower_bound, upper_bound] as OpenMetrics "le" buckets do
+    counts[bucket_for(value ? value - 1 : 0)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+}
+
+auto mrm::Histogram::buckets() const -> std::vector<Bucket>
+{
+    std::vector<Bucket> result;
+    result.reserve(max_exponent - min_exponent + 2);
+
+    // Each exported bound is a power of two, so it is also the start of a recording bucket
+    uint64_t cumulative{0};
+    unsigned bucket{0};
+    for (auto exponent = min_exponent; exponent <= max_exponent; ++exponent)
+    {
+        auto const bound = uint64_t{1} << exponent;
+        for (; bucket != bucket_count && lower_bound_of(bucket) < bound; ++bucket)
+            cumulative += counts[bucket].load(std::memory_order_relaxed);
+
+        result.push_back({bound*scale, cumulative});
+    }
+
+    for (; bucket != bucket_count; ++bucket)
+        cumulative += counts[bucket].load(std::memory_order_relaxed);
+
+    result.push_back({std::numeric_limits<double>::infinity(), cumulative});
+    return result;
+}
+
+auto mrm::Histogram::sum() const -> double
+{
+    return total.load(std::memory_order_relaxed)*scale;
+}
+
+auto mrm::Registry::counter(std::string const& name, std::string const& help, Labels const& labels)
+    -> std::shared_ptr<Counter>
+{
+    return std::static_pointer_cast<Counter>(find_or_add(name, help, Type::counter, labels,
+        []{ return std::make_shared<Counter>(); }));
+}
+
+auto mrm::Registry::gauge(std::string const& name, std::string const& help, Labels const& labels)
+    -> std::shared_ptr<Gauge>
+{
+    return std::static_pointer_cast<Gauge>(find_or_add(name, help, Type::gauge, labels,
+        []{ return std::make_shared<Gauge>(); }));
+}
+
+auto mrm::Registry::histogram(
+    std::string const& name,
+    std::string const& help,
+    unsigned min_exponent,
+    unsigned max_exponent,
+    double scale,
+    Labels const& labels) -> std::shared_ptr<Histogram>
+{
+    return std::static_pointer_cast<Histogram>(find_or_add(name, help, Type::histogram, labels,
+        [&]{ return std::make_shared<Histogram>(min_exponent, max_exponent, scale); }));
+}
+
+auto mrm::Registry::find_or_add(
+    std::string const& name,
+    std::string const& help,
+    Type type,
+    Labels const& labels,
+    std::function<std::shared_ptr<void>()> const& create) -> std::shared_ptr<void>
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto family = families.find(name);
+    if (family == families.end())
+    {
+        family = families.emplace(name, Family{type, help, {}}).first;
+    }
+    else if (family->second.type != type)
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("Metric \"" + name + "\" already exists with a different type"));
+    }
+
+    for (auto const& series : family->second.series)
+    {
+        if (series.first == labels)
+            return series.second;
+    }
+
+    auto const result = create();
+    family->second.series.emplace_back(labels, result);
+    return result;
+}
+
+void mrm::Registry::remove(std::string const& name, Labels const& labels)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const family = families.find(name);
+    if (family == families.end())
+        return;
+
+    auto& series = family->second.series;
+    series.erase(
+        std::remove_if(series.begin(), series.end(), [&](auto const& s) { return s.first == labels; }),
+        series.end());
+
+    if (series.empty())
+        families.erase(family);
+}
+
+void mrm::Registry::write_to(std::ostream& out) const
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    for (auto const& family : families)
+    {
+        auto const& name = family.first;
+
+        switch (family.second.type)
+        {
+        case Type::counter:
+            out << "# TYPE " << name << " counter\n";
+            out << "# HELP " << name << ' ' << family.second.help << '\n';
+            for (auto const& series : family.second.series)
+            {
+                out << name << "_total";
+                write_labels(out, series.first);
+                out << ' ' << std::static_pointer_cast<Counter>(series.second)->get() << '\n';
+            }
+            break;
+
+        case Type::gauge:
+            out << "# TYPE " << name << " gauge\n";
+            out << "# HELP " << name << ' ' << family.second.help << '\n';
+            for (auto const& series : family.second.series)
+            {
+                out << name;
+                write_labels(out, series.first);
+                out << ' ' << std::static_pointer_cast<Gauge>(series.second)->get() << '\n';
+            }
+            break;
+
+        case Type::histogram:
+            out << "# TYPE " << name << " histogram\n";
+            out << "# HELP " << name << ' ' << family.second.help << '\n';
+            for (auto const& series : family.second.series)
+            {
+                auto const histogram = std::static_pointer_cast<Histogram>(series.second);
+                auto const buckets = histogram->buckets();
+
+                for (auto const& bucket : buckets)
+                {
+                    out << name << "_bucket";
+                    write_labels(out, series.first, "le", as_string(bucket.upper_bound));
+                    out << ' ' << bucket.cumulative_count << '\n';
+                }
+
+                out << name << "_count";
+                write_labels(out, series.first);
+                out << ' ' << buckets.back().cumulative_count << '\n';
+
+                out << name << "_sum";
+                write_labels(out, series.first);
+                out << ' ' << as_string(histogram->sum()) << '\n';
+            }
+            break;
+        }
+    }
+
+    out << "# EOF\n";
+}
+
+auto mrm::the_registry() -> std::shared_ptr<Registry>
+{
+    static auto const registry = std::make_shared<Registry>();
+    return registry;
+}
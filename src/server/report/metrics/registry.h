@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_REGISTRY_H_
+#define MIR_REPORT_METRICS_REGISTRY_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/// A value that only goes up. Updating it is a single relaxed atomic add.
+class Counter
+{
+public:
+    void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    auto get() const -> uint64_t { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/// A value that can go up and down
+class Gauge
+{
+public:
+    void set(int64_t to) { value.store(to, std::memory_order_relaxed); }
+    void add(int64_t amount) { value.fetch_add(amount, std::memory_order_relaxed); }
+    auto get() const -> int64_t { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value{0};
+};
+
+/// A distribution of values, recorded without locking.
+///
+/// Values are counted in log-linear buckets (each power of two is split into four) so that they are
+/// recorded to within 25% however large they are. They are exported at every power of two from
+/// 2^min_exponent to 2^max_exponent, multiplied by scale (e.g. 1e-9 to record nanoseconds and export seconds).
+class Histogram
+{
+public:
+    Histogram(unsigned min_exponent, unsigned max_exponent, double scale);
+
+    void record(uint64_t value);
+    void record(std::chrono::nanoseconds value) { record(value.count() > 0 ? value.count() : 0); }
+
+    struct Bucket
+    {
+        double upper_bound;
+        uint64_t cumulative_count;
+    };
+
+    /// Buckets are cumulative and end with the total count (at an upper bound of infinity)
+    auto buckets() const -> std::vector<Bucket>;
+    auto sum() const -> double;
+
+    /// The recording bucket for value, and the smallest value in each bucket (exposed for testing)
+    static auto bucket_for(uint64_t value) -> unsigned;
+    static auto lower_bound_of(unsigned bucket) -> uint64_t;
+
+    static unsigned const bucket_count = 4 + 62*4;
+
+private:
+    unsigned const min_exponent;
+    unsigned const max_exponent;
+    double const scale;
+
+    std::array<std::atomic<uint64_t>, bucket_count> counts;
+    std::atomic<uint64_t> total{0};     ///< Of the values recorded (in the units they were recorded in)
+};
+
+/// The metrics of a process, written in the OpenMetrics (Prometheus) text format.
+///
+/// Looking up a metric takes a lock, so it should be done once, not each time the metric is updated.
+/// Asking for a metric that already exists (with the same name and labels) returns that metric.
+class Registry
+{
+public:
+    auto counter(std::string const& name, std::string const& help, Labels const& labels = {})
+        -> std::shared_ptr<Counter>;
+
+    auto gauge(std::string const& name, std::string const& help, Labels const& labels = {})
+        -> std::shared_ptr<Gauge>;
+
+    /// \see Histogram for min_exponent, max_exponent and scale
+    auto histogram(
+        std::string const& name,
+        std::string const& help,
+        unsigned min_exponent,
+        unsigned max_exponent,
+        double scale,
+        Labels const& labels = {}) -> std::shared_ptr<Histogram>;
+
+    /// Stops exporting the metric with this name and labels. Anyone holding it can still update it.
+    void remove(std::string const& name, Labels const& labels);
+
+    void write_to(std::ostream& out) const;
+
+private:
+    enum class Type { counter, gauge, histogram };
+
+    struct Family
+    {
+        Type type;
+        std::string help;
+        std::vector<std::pair<Labels, std::shared_ptr<void>>> series;
+    };
+
+    auto find_or_add(std::string const& name, std::string const& help, Type type, Labels const& labels,
+        std::function<std::shared_ptr<void>()> const& create) -> std::shared_ptr<void>;
+
+    std::mutex mutable mutex;
+    std::map<std::string, Family> families;
+};
+
+/// The Registry that the metrics reports record to
+auto the_registry() -> std::shared_ptr<Registry>;
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_REGISTRY_H_ */
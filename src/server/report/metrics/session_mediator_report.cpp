@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "session_mediator_report.h"
+#include "registry.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+std::atomic<uint64_t> next_report_id{1};
+
+char const* const submissions_metric = "mir_client_buffer_submissions";
+char const* const buffer_streams_metric = "mir_client_buffer_streams";
+char const* const errors_metric = "mir_client_errors";
+}
+
+thread_local mrm::SessionMediatorReport::CachedClient mrm::SessionMediatorReport::cached_client{0, {}, nullptr};
+
+mrm::SessionMediatorReport::SessionMediatorReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    connected_clients{registry->gauge("mir_clients_connected", "Clients connected")},
+    report_id{next_report_id++}
+{
+}
+
+void mrm::SessionMediatorReport::session_connect_called(std::string const& app_name)
+{
+    connected_clients->add(1);
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto client = clients.find(app_name);
+    auto const& c = client != clients.end() ? client->second : add_client(app_name);
+    ++c->sessions;
+}
+
+void mrm::SessionMediatorReport::session_disconnect_called(std::string const& app_name)
+{
+    connected_clients->add(-1);
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto const client = clients.find(app_name);
+    if (client == clients.end() || --client->second->sessions > 0)
+        return;
+
+    // The last client with this name has gone, so stop exporting its metrics
+    client->second->removed = true;
+    clients.erase(client);
+
+    Labels const labels{{"client", app_name}};
+    registry->remove(submissions_metric, labels);
+    registry->remove(buffer_streams_metric, labels);
+    registry->remove(errors_metric, labels);
+}
+
+void mrm::SessionMediatorReport::session_submit_buffer_called(std::string const& app_name)
+{
+    client_for(app_name).submissions->add();
+}
+
+void mrm::SessionMediatorReport::session_create_buffer_stream_called(std::string const& app_name)
+{
+    client_for(app_name).buffer_streams->add(1);
+}
+
+void mrm::SessionMediatorReport::session_release_buffer_stream_called(std::string const& app_name)
+{
+    client_for(app_name).buffer_streams->add(-1);
+}
+
+void mrm::SessionMediatorReport::session_error(
+    std::string const& app_name, char const* /*method*/, std::string const& /*what*/)
+{
+    client_for(app_name).errors->add();
+}
+
+auto mrm::SessionMediatorReport::client_for(std::string const& app_name) -> Client&
+{
+    auto& cached = cached_client;
+
+    if (cached.report == report_id &&
+        cached.client &&
+        !cached.client->removed.load(std::memory_order_relaxed) &&
+        cached.app_name == app_name)
+    {
+        return *cached.client;
+    }
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    auto client = clients.find(app_name);
+    cached = CachedClient{report_id, app_name, client != clients.end() ? client->second : add_client(app_name)};
+
+    return *cached.client;
+}
+
+auto mrm::SessionMediatorReport::add_client(std::string const& app_name) -> std::shared_ptr<Client>
+{
+    Labels const labels{{"client", app_name}};
+
+    auto const client = std::make_shared<Client>();
+    client->submissions = registry->counter(submissions_metric, "Buffers submitted by a client", labels);
+    client->buffer_streams = registry->gauge(buffer_streams_metric, "Buffer streams a client has", labels);
+    client->errors = registry->counter(errors_metric, "Requests from a client that failed", labels);
+
+    clients[app_name] = client;
+    return client;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_
+#define MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_
+
+#include "../null/session_mediator_report.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+
+/// Records per-client request counts. Clients are labelled with their application name, and their
+/// metrics are removed when the last client with that name disconnects.
+class SessionMediatorReport : public null::SessionMediatorReport
+{
+public:
+    explicit SessionMediatorReport(std::shared_ptr<Registry> const& registry);
+
+    void session_connect_called(std::string const& app_name) override;
+    void session_disconnect_called(std::string const& app_name) override;
+    void session_submit_buffer_called(std::string const& app_name) override;
+    void session_create_buffer_stream_called(std::string const& app_name) override;
+    void session_release_buffer_stream_called(std::string const& app_name) override;
+    void session_error(std::string const& app_name, char const* method, std::string const& what) override;
+
+private:
+    struct Client
+    {
+        std::shared_ptr<Counter> submissions;
+        std::shared_ptr<Gauge> buffer_streams;
+        std::shared_ptr<Counter> errors;
+
+        unsigned sessions{0};           ///< Guarded by SessionMediatorReport::mutex
+        std::atomic<bool> removed{false};
+    };
+
+    /// The client this thread last reported on. A thread handles a client's requests in batches, so
+    /// this usually saves looking the client up (and locking) for each request.
+    struct CachedClient
+    {
+        uint64_t report;
+        std::string app_name;
+        std::shared_ptr<Client> client;
+    };
+    static thread_local CachedClient cached_client;
+
+    auto client_for(std::string const& app_name) -> Client&;
+    auto add_client(std::string const& app_name) -> std::shared_ptr<Client>;
+
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<Gauge> const connected_clients;
+    uint64_t const report_id;   ///< Distinguishes this report's cached_client from earlier ones'
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Client>> clients;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_ */
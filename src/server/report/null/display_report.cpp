@@ -28,5 +28,6 @@ void mrn::DisplayReport::report_successful_display_construction() {}
 void mrn::DisplayReport::report_drm_master_failure(int) {}
 void mrn::DisplayReport::report_vt_switch_away_failure() {}
 void mrn::DisplayReport::report_vt_switch_back_failure() {}
+void mrn::DisplayReport::report_configuration_phase(char const*, std::chrono::nanoseconds) {}
 void mrn::DisplayReport::report_egl_configuration(EGLDisplay, EGLConfig) {}
 void mrn::DisplayReport::report_vsync(unsigned int, mir::graphics::Frame const&) {}
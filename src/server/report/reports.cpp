@@ -24,16 +24,25 @@
 #include "mir/observer_multiplexer.h"
 #include "mir/options/configuration.h"
 #include "mir/abnormal_exit.h"
+#include "mir/main_loop.h"
+#include "mir/log.h"
+#include "mir/report/timeline.h"
 
 #include "report_factory.h"
 #include "lttng_report_factory.h"
 #include "logging_report_factory.h"
 #include "null_report_factory.h"
+#include "metrics_report_factory.h"
+#include "metrics/exporter.h"
+#include "metrics/registry.h"
 
+#include <csignal>
+#include <fstream>
 #include <string>
 
 namespace mo = mir::options;
 namespace mr = mir::report;
+namespace mrt = mir::report::timeline;
 
 namespace
 {
@@ -41,7 +50,8 @@ enum class ReportOutput
 {
     Discarded,
     Log,
-    LTTNG
+    LTTNG,
+    Metrics
 };
 
 std::unique_ptr<mr::ReportFactory> factory_for_type(
@@ -56,6 +66,8 @@ std::unique_ptr<mr::ReportFactory> factory_for_type(
         return std::make_unique<mr::LoggingReportFactory>(config.the_logger(), config.the_clock());
     case ReportOutput::LTTNG:
         return std::make_unique<mr::LttngReportFactory>();
+    case ReportOutput::Metrics:
+        return std::make_unique<mr::MetricsReportFactory>(mr::metrics::the_registry(), config.the_clock());
     }
 #ifndef __clang__
     /*
@@ -80,6 +92,10 @@ ReportOutput parse_report_option(std::string const& opt)
     {
         return ReportOutput::LTTNG;
     }
+    else if (opt == mo::metrics_opt_value)
+    {
+        return ReportOutput::Metrics;
+    }
     else if (opt == mo::off_opt_value)
     {
         return ReportOutput::Discarded;
@@ -89,7 +105,7 @@ ReportOutput parse_report_option(std::string const& opt)
         throw mir::AbnormalExit(
             std::string("Invalid report option: ") + opt + " (valid options are: \"" +
             mo::off_opt_value + "\" and \"" + mo::log_opt_value +
-            "\" and \"" + mo::lttng_opt_value + "\")");
+            "\" and \"" + mo::lttng_opt_value + "\" and \"" + mo::metrics_opt_value + "\")");
     }
 }
 
@@ -122,6 +138,33 @@ std::shared_ptr<mir::frontend::SessionMediatorObserver> create_session_mediator_
         std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::session_mediator_report_opt));
     }
 }
+
+/// Starts recording the timeline on the first signal, and writes it to file on the next
+void record_timeline_on_signal(mir::MainLoop& main_loop, std::string const& file)
+{
+    main_loop.register_signal_handler({SIGRTMIN}, [file](int)
+        {
+            auto& timeline = mrt::the_timeline();
+
+            if (!timeline.is_recording())
+            {
+                timeline.start();
+                mir::log_info("Recording timeline, until the next SIGRTMIN");
+                return;
+            }
+
+            timeline.stop();
+
+            std::ofstream out{file};
+            timeline.write_to(out);
+            out.close();
+
+            if (out)
+                mir::log_info("Wrote timeline to %s", file.c_str());
+            else
+                mir::log_error("Failed to write timeline to %s", file.c_str());
+        });
+}
 }
 
 mir::report::Reports::Reports(
@@ -135,9 +178,18 @@ mir::report::Reports::Reports(
           create_session_mediator_reports(
               server,
               options.get<std::string>(mo::session_mediator_report_opt))},
-      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()}
+      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()},
+      metrics_exporter{
+          options.is_set(mo::metrics_socket_opt) ?
+              std::make_shared<metrics::Exporter>(
+                  metrics::the_registry(),
+                  options.get<std::string>(mo::metrics_socket_opt)) :
+              nullptr}
 {
     display_configuration_multiplexer->register_interest(display_configuration_report);
     seat_observer_multiplexer->register_interest(seat_report);
     session_mediator_observer_multiplexer->register_interest(session_mediator_report);
+
+    if (options.is_set(mo::timeline_file_opt))
+        record_timeline_on_signal(*server.the_main_loop(), options.get<std::string>(mo::timeline_file_opt));
 }
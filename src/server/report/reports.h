@@ -52,6 +52,10 @@ namespace logging
 {
 class DisplayConfigurationReport;
 }
+namespace metrics
+{
+class Exporter;
+}
 
 class ReportFactory;
 
@@ -68,6 +72,7 @@ private:
     std::shared_ptr<frontend::SessionMediatorObserver> const session_mediator_report;
     std::shared_ptr<ObserverRegistrar<frontend::SessionMediatorObserver>> const
         session_mediator_observer_multiplexer;
+    std::shared_ptr<metrics::Exporter> const metrics_exporter;
 };
 }
 }
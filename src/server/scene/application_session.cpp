@@ -31,6 +31,8 @@
 #include "mir/frontend/event_sink.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
 #include "mir/scene/surface_observer.h"
+#include "mir/scene/session_resources.h"
+#include "mir/unwind_helpers.h"
 
 #include <boost/throw_exception.hpp>
 
@@ -65,7 +67,8 @@ ms::ApplicationSession::ApplicationSession(
     snapshot_strategy(snapshot_strategy),
     session_listener(session_listener),
     event_sink(sink),
-    gralloc(gralloc)
+    gralloc(gralloc),
+    resources_(std::make_shared<SessionResources>(session_name))
 {
     assert(surface_stack);
 }
@@ -97,6 +100,10 @@ auto ms::ApplicationSession::create_surface(
         BOOST_THROW_EXCEPTION(std::logic_error("surface must have content"));
     }
 
+    auto const counted = try_but_revert_if_unwinding(
+        [this] { resources_->add_surface(); },
+        [this] { resources_->remove_surface(); });
+
     auto params = the_params;
 
     std::shared_ptr<mc::BufferStream> buffer_stream;
@@ -170,6 +177,8 @@ void ms::ApplicationSession::destroy_surface(std::shared_ptr<Surface> const& sur
         surfaces.erase(surface_iter);
     }
 
+    resources_->remove_surface();
+
     surface_stack->remove_surface(surface);
 }
 
@@ -312,6 +321,10 @@ void ms::ApplicationSession::resume_prompt_session()
 auto ms::ApplicationSession::create_buffer_stream(mg::BufferProperties const& props)
     -> std::shared_ptr<compositor::BufferStream>
 {
+    auto const counted = try_but_revert_if_unwinding(
+        [this] { resources_->add_buffer_stream(); },
+        [this] { resources_->remove_buffer_stream(); });
+
     auto stream = buffer_stream_factory->create_buffer_stream(props);
     session_listener->buffer_stream_created(*this, stream);
 
@@ -329,6 +342,7 @@ void ms::ApplicationSession::destroy_buffer_stream(std::shared_ptr<frontend::Buf
 
     session_listener->buffer_stream_destroyed(*this, *stream_it);
     streams.erase(stream_it);
+    resources_->remove_buffer_stream();
 }
 
 void ms::ApplicationSession::configure_streams(
@@ -349,6 +363,11 @@ auto ms::ApplicationSession::has_buffer_stream(
     return streams.find(stream) != streams.end();
 }
 
+auto ms::ApplicationSession::resources() const -> std::shared_ptr<SessionResources>
+{
+    return resources_;
+}
+
 void ms::ApplicationSession::send_error(mir::ClientVisibleError const& error)
 {
     event_sink->handle_error(error);
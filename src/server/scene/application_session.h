@@ -95,6 +95,8 @@ public:
     void destroy_buffer_stream(std::shared_ptr<frontend::BufferStream> const& stream) override;
     void configure_streams(Surface& surface, std::vector<shell::StreamSpecification> const& config) override;
 
+    auto resources() const -> std::shared_ptr<SessionResources> override;
+
     /// Returns if the application session knows about the given buffer stream
     auto has_buffer_stream(std::shared_ptr<compositor::BufferStream> const& stream) -> bool;
 
@@ -112,6 +114,7 @@ private:
     std::shared_ptr<SessionListener> const session_listener;
     std::shared_ptr<frontend::EventSink> const event_sink;
     std::shared_ptr<graphics::GraphicBufferAllocator> const gralloc;
+    std::shared_ptr<SessionResources> const resources_;
 
     std::vector<std::shared_ptr<Surface>> surfaces;
     std::set<std::shared_ptr<compositor::BufferStream>> streams;
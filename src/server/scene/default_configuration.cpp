@@ -171,6 +171,15 @@ mir::DefaultServerConfiguration::the_session_coordinator()
     return session_coordinator(
         [this]()
         {
+            auto const options = the_options();
+            auto const limit = [&](char const* opt) { return size_t(std::max(options->get<int>(opt), 0)); };
+
+            ms::ResourceLimits limits;
+            limits.max_surfaces = limit(options::client_surface_limit_opt);
+            limits.max_buffer_streams = limit(options::client_buffer_stream_limit_opt);
+            limits.buffer_bytes_warning = limit(options::client_buffer_memory_warning_opt) << 20;    // MiB
+            limits.max_buffer_bytes = limit(options::client_buffer_memory_limit_opt) << 20;
+
             return std::make_shared<ms::SessionManager>(
                 the_surface_stack(),
                 the_surface_factory(),
@@ -182,7 +191,8 @@ mir::DefaultServerConfiguration::the_session_coordinator()
                 the_display(),
                 the_application_not_responding_detector(),
                 the_buffer_allocator(),
-                the_display_configuration_observer_registrar());
+                the_display_configuration_observer_registrar(),
+                limits);
         });
 }
 
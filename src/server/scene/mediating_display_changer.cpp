@@ -389,6 +389,11 @@ ms::MediatingDisplayChanger::base_configuration()
     return base_configuration_->clone();
 }
 
+mg::Frame ms::MediatingDisplayChanger::last_frame_on(unsigned output_id) const
+{
+    return display->last_frame_on(output_id);
+}
+
 void ms::MediatingDisplayChanger::configure_for_hardware_change(
     std::shared_ptr<graphics::DisplayConfiguration> const& conf)
 {
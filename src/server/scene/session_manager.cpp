@@ -99,7 +99,8 @@ ms::SessionManager::SessionManager(
     std::shared_ptr<graphics::Display const> const& display,
     std::shared_ptr<ApplicationNotRespondingDetector> const& anr_detector,
     std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
-    std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>> const& display_config_registrar) :
+    std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>> const& display_config_registrar,
+    ResourceLimits const& resource_limits) :
     observers(std::make_shared<SessionObservers>()),
     surface_stack(surface_stack),
     surface_factory(surface_factory),
@@ -111,7 +112,8 @@ ms::SessionManager::SessionManager(
     display{display},
     anr_detector{anr_detector},
     allocator{allocator},
-    display_config_registrar{display_config_registrar}
+    display_config_registrar{display_config_registrar},
+    resource_limits{resource_limits}
 {
     observers->register_interest(session_listener);
 }
@@ -152,6 +154,7 @@ std::shared_ptr<ms::Session> ms::SessionManager::open_session(
             sender,
             allocator);
 
+    new_session->resources()->set_limits(resource_limits);
     app_container->insert_session(new_session);
 
     observers->starting(new_session);
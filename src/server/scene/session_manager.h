@@ -22,6 +22,7 @@
 #include "mir/scene/session_coordinator.h"
 #include "mir/scene/session_listener.h"
 #include "mir/observer_registrar.h"
+#include "mir/scene/session_resources.h"
 
 #include <memory>
 #include <vector>
@@ -64,7 +65,8 @@ public:
         std::shared_ptr<graphics::Display const> const& display,
         std::shared_ptr<ApplicationNotRespondingDetector> const& anr_detector,
         std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
-        std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>> const& display_config_registrar);
+        std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>> const& display_config_registrar,
+        ResourceLimits const& resource_limits);
 
     virtual ~SessionManager() noexcept;
 
@@ -102,6 +104,7 @@ private:
     std::shared_ptr<ApplicationNotRespondingDetector> const anr_detector;
     std::shared_ptr<graphics::GraphicBufferAllocator> const allocator;
     std::shared_ptr<ObserverRegistrar<graphics::DisplayConfigurationObserver>> display_config_registrar;
+    ResourceLimits const resource_limits;
 };
 
 }
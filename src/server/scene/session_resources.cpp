@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "scene"
+
+#include "mir/scene/session_resources.h"
+#include "mir/graphics/buffer.h"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+namespace ms = mir::scene;
+namespace mg = mir::graphics;
+
+namespace
+{
+auto bytes_in(mg::Buffer const& buffer) -> size_t
+{
+    auto const size = buffer.size();
+    return size_t(size.width.as_uint32_t()) * size.height.as_uint32_t() * MIR_BYTES_PER_PIXEL(buffer.pixel_format());
+}
+
+void add_within_limit(std::atomic<size_t>& count, size_t limit, char const* what, std::string const& session_name)
+{
+    if (count.fetch_add(1, std::memory_order_relaxed) >= limit && limit)
+    {
+        count.fetch_sub(1, std::memory_order_relaxed);
+        BOOST_THROW_EXCEPTION(std::runtime_error(
+            "\"" + session_name + "\" already has " + std::to_string(limit) + " " + what + ", the most allowed"));
+    }
+}
+}
+
+void ms::SessionResources::set_limits(ResourceLimits const& limits)
+{
+    max_surfaces = limits.max_surfaces;
+    max_buffer_streams = limits.max_buffer_streams;
+    buffer_bytes_warning = limits.buffer_bytes_warning;
+    max_buffer_bytes = limits.max_buffer_bytes;
+}
+
+void ms::SessionResources::add_surface()
+{
+    add_within_limit(surfaces, max_surfaces, "surfaces", session_name);
+}
+
+void ms::SessionResources::remove_surface()
+{
+    surfaces.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ms::SessionResources::add_buffer_stream()
+{
+    add_within_limit(buffer_streams, max_buffer_streams, "buffer streams", session_name);
+}
+
+void ms::SessionResources::remove_buffer_stream()
+{
+    buffer_streams.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto ms::SessionResources::track(std::shared_ptr<mg::Buffer> const& buffer) -> std::shared_ptr<mg::Buffer>
+{
+    auto const bytes = bytes_in(*buffer);
+    auto const before = buffer_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    auto const after = before + bytes;
+
+    auto const limit = max_buffer_bytes.load(std::memory_order_relaxed);
+    if (limit && after > limit)
+    {
+        buffer_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        BOOST_THROW_EXCEPTION(std::runtime_error(
+            "\"" + session_name + "\" would have " + std::to_string(after) + " bytes of buffers, over its limit of " +
+            std::to_string(limit)));
+    }
+
+    auto const warning = buffer_bytes_warning.load(std::memory_order_relaxed);
+    if (warning && before <= warning && after > warning)
+    {
+        mir::log_warning(
+            "\"%s\" is using %zu bytes of buffers, over the warning level of %zu",
+            session_name.c_str(), after, warning);
+    }
+
+    buffers.fetch_add(1, std::memory_order_relaxed);
+
+    // Share ownership with the buffer, so this is released with the last copy of the result
+    auto const self = shared_from_this();
+    return {buffer.get(), [buffer, self, bytes](mg::Buffer*) { self->release(bytes); }};
+}
+
+void ms::SessionResources::release(size_t bytes)
+{
+    buffers.fetch_sub(1, std::memory_order_relaxed);
+    buffer_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
@@ -152,32 +152,51 @@ ms::SurfaceStack::~SurfaceStack() noexcept(true)
 
 mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID id)
 {
-    RecursiveReadLock lg(guard);
-
-    scene_changed = false;
+    // Occluding a surface changes its visibility attribute, which notifies observers, so that
+    // happens after the scene is unlocked
+    std::vector<std::shared_ptr<RenderingTracker>> hidden;
     mc::SceneElementSequence elements;
-    for (auto const& layer : surface_layers)
+
     {
-        for (auto const& surface : layer)
+        RecursiveReadLock lg(guard);
+
+        scene_changed = false;
+        for (auto const& layer : surface_layers)
         {
-            if (surface->visible())
+            for (auto const& surface : layer)
             {
-                for (auto& renderable : surface->generate_renderables(id))
+                if (surface->visible())
                 {
-                    elements.emplace_back(
-                        std::make_shared<SurfaceSceneElement>(
-                            surface->name(),
-                            renderable,
-                            rendering_trackers[surface.get()],
-                            id));
+                    for (auto& renderable : surface->generate_renderables(id))
+                    {
+                        elements.emplace_back(
+                            std::make_shared<SurfaceSceneElement>(
+                                surface->name(),
+                                renderable,
+                                rendering_trackers[surface.get()],
+                                id));
+                    }
+                }
+                else if (registered_compositors.find(id) != registered_compositors.end())
+                {
+                    // Hidden (e.g. minimized) surfaces are not composited, so are not visible on this output
+                    auto const tracker = rendering_trackers.find(surface.get());
+                    if (tracker != rendering_trackers.end())
+                        hidden.push_back(tracker->second);
                 }
             }
         }
+        for (auto const& renderable : overlays)
+        {
+            elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
+        }
     }
-    for (auto const& renderable : overlays)
+
+    for (auto const& tracker : hidden)
     {
-        elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
+        tracker->occluded_in(id);
     }
+
     return elements;
 }
 
@@ -262,6 +281,15 @@ void ms::SurfaceStack::emit_scene_changed()
     observers.scene_changed();
 }
 
+void ms::SurfaceStack::emit_scene_damaged(geometry::Rectangle const& damage)
+{
+    {
+        RecursiveWriteLock lg(guard);
+        scene_changed = true;
+    }
+    observers.scene_damaged(damage);
+}
+
 void ms::SurfaceStack::add_surface(
     std::shared_ptr<Surface> const& surface,
     mi::InputReceptionMode input_mode)
@@ -527,6 +555,12 @@ void ms::Observers::scene_changed()
         { observer->scene_changed(); });
 }
 
+void ms::Observers::scene_damaged(geometry::Rectangle const& damage)
+{
+   for_each([&](std::shared_ptr<Observer> const& observer)
+        { observer->scene_damaged(damage); });
+}
+
 void ms::Observers::surface_exists(std::shared_ptr<Surface> const& surface)
 {
     for_each([&](std::shared_ptr<Observer> const& observer)
@@ -30,6 +30,8 @@
 #include "mir/default_server_configuration.h"
 #include "mir/logging/logger.h"
 #include "mir/log.h"
+#include "mir/abnormal_exit.h"
+#include "mir/options/option.h"
 #include "mir/main_loop.h"
 #include "mir/report_exception.h"
 #include "mir/run_mir.h"
@@ -258,6 +260,22 @@ std::shared_ptr<mo::DefaultConfiguration> configuration_options(
     return result;
 }
 
+auto max_log_severity(mo::Option const& options) -> mir::logging::Severity
+{
+    using mir::logging::Severity;
+
+    auto const level = options.get<std::string>(mo::log_level_opt);
+
+    if (level == "critical")    return Severity::critical;
+    if (level == "error")       return Severity::error;
+    if (level == "warning")     return Severity::warning;
+    if (level == "info")        return Severity::informational;
+    if (level == "debug")       return Severity::debug;
+
+    throw mir::AbnormalExit(std::string("Invalid ") + mo::log_level_opt + " option: " + level +
+        " (valid options are: \"critical\", \"error\", \"warning\", \"info\" and \"debug\")");
+}
+
 template<typename ConfigPtr>
 void verify_setting_allowed(ConfigPtr const& initialized)
 {
@@ -386,6 +404,7 @@ void mir::Server::apply_settings()
     auto const config = std::make_shared<ServerConfiguration>(options, self);
     self->server_config = config;
 
+    mir::logging::set_max_severity(max_log_severity(*options->the_options()));
     mir::logging::set_logger(config->the_logger());
 }
 
@@ -37,6 +37,7 @@
 
 #include <boost/throw_exception.hpp>
 #include <functional>
+#include <map>
 #include <mutex>
 #include <experimental/optional>
 
@@ -118,7 +119,13 @@ public:
 
     auto create_buffer_stream() -> std::shared_ptr<mc::BufferStream>;
 
+    /// Submits the buffer unless it is already the one the stream is showing
+    void submit(std::shared_ptr<mc::BufferStream> const& stream, std::shared_ptr<mg::Buffer> const& buffer);
+
+    /// The titlebar and borders all show the same stretched background buffer
     std::shared_ptr<mc::BufferStream> const titlebar;
+    std::shared_ptr<mc::BufferStream> const title;
+    std::shared_ptr<mc::BufferStream> const buttons;
     std::shared_ptr<mc::BufferStream> const left_border;
     std::shared_ptr<mc::BufferStream> const right_border;
     std::shared_ptr<mc::BufferStream> const bottom_border;
@@ -127,11 +134,14 @@ private:
     BufferStreams(BufferStreams const&) = delete;
     BufferStreams& operator=(BufferStreams const&) = delete;
 
+    std::map<mc::BufferStream*, std::shared_ptr<mg::Buffer>> submitted;
 };
 
 msd::BasicDecoration::BufferStreams::BufferStreams(std::shared_ptr<scene::Session> const& session)
     : session{session},
       titlebar{create_buffer_stream()},
+      title{create_buffer_stream()},
+      buttons{create_buffer_stream()},
       left_border{create_buffer_stream()},
       right_border{create_buffer_stream()},
       bottom_border{create_buffer_stream()}
@@ -141,6 +151,8 @@ msd::BasicDecoration::BufferStreams::BufferStreams(std::shared_ptr<scene::Sessio
 msd::BasicDecoration::BufferStreams::~BufferStreams()
 {
     session->destroy_buffer_stream(titlebar);
+    session->destroy_buffer_stream(title);
+    session->destroy_buffer_stream(buttons);
     session->destroy_buffer_stream(left_border);
     session->destroy_buffer_stream(right_border);
     session->destroy_buffer_stream(bottom_border);
@@ -156,6 +168,18 @@ auto msd::BasicDecoration::BufferStreams::create_buffer_stream() -> std::shared_
     return stream;
 }
 
+void msd::BasicDecoration::BufferStreams::submit(
+    std::shared_ptr<mc::BufferStream> const& stream,
+    std::shared_ptr<mg::Buffer> const& buffer)
+{
+    auto& current = submitted[stream.get()];
+    if (current != buffer)
+    {
+        stream->submit_buffer(buffer);
+        current = buffer;
+    }
+}
+
 msd::BasicDecoration::BasicDecoration(
     std::shared_ptr<msh::Shell> const& shell,
     std::shared_ptr<mg::GraphicBufferAllocator> const& buffer_allocator,
@@ -326,12 +350,28 @@ void msd::BasicDecoration::update(
         spec.input_shape = input_state->input_shape();
     }
 
+    // The title and buttons are positioned by the renderer, so it must be updated before the streams are placed
+    auto const previous_title_rect = renderer->title_rect();
+    auto const previous_buttons_rect = renderer->buttons_rect();
+
+    if (window_updated({
+            &WindowState::focused_state,
+            &WindowState::window_name,
+            &WindowState::titlebar_rect}) ||
+        input_updated({
+            &InputState::buttons}))
+    {
+        renderer->update_state(*window_state, *input_state);
+    }
+
     if (window_updated({
             &WindowState::border_type,
             &WindowState::titlebar_rect,
             &WindowState::left_border_rect,
             &WindowState::right_border_rect,
-            &WindowState::bottom_border_rect}))
+            &WindowState::bottom_border_rect}) ||
+        renderer->title_rect() != previous_title_rect ||
+        renderer->buttons_rect() != previous_buttons_rect)
     {
         spec.streams = std::vector<StreamSpecification>{};
         auto const emplace = [&](std::shared_ptr<mc::BufferStream> stream, geom::Rectangle rect)
@@ -340,16 +380,22 @@ void msd::BasicDecoration::update(
                     spec.streams.value().emplace_back(StreamSpecification{stream, as_displacement(rect.top_left), rect.size});
             };
 
+        // The compositor scales each buffer to its stream's size, so resizing the window only moves and stretches
+        // these streams rather than needing new buffers to be drawn
         switch (window_state->border_type())
         {
         case BorderType::Full:
             emplace(buffer_streams->titlebar, window_state->titlebar_rect());
+            emplace(buffer_streams->title, renderer->title_rect());
+            emplace(buffer_streams->buttons, renderer->buttons_rect());
             emplace(buffer_streams->left_border, window_state->left_border_rect());
             emplace(buffer_streams->right_border, window_state->right_border_rect());
             emplace(buffer_streams->bottom_border, window_state->bottom_border_rect());
             break;
         case BorderType::Titlebar:
             emplace(buffer_streams->titlebar, window_state->titlebar_rect());
+            emplace(buffer_streams->title, renderer->title_rect());
+            emplace(buffer_streams->buttons, renderer->buttons_rect());
             break;
         case BorderType::None:
             break;
@@ -361,44 +407,18 @@ void msd::BasicDecoration::update(
         shell->modify_surface(session, decoration_surface, spec);
     }
 
-    if (window_updated({
-            &WindowState::focused_state,
-            &WindowState::window_name,
-            &WindowState::titlebar_rect,
-            &WindowState::left_border_rect,
-            &WindowState::right_border_rect,
-            &WindowState::bottom_border_rect}) ||
-        input_updated({
-            &InputState::buttons}))
-    {
-        renderer->update_state(*window_state, *input_state);
-    }
-
     std::vector<std::pair<
         std::shared_ptr<mc::BufferStream>,
         std::experimental::optional<std::shared_ptr<mg::Buffer>>>> new_buffers;
 
     if (window_updated({
-            &WindowState::focused_state,
-            &WindowState::side_border_width,
-            &WindowState::side_border_height}))
+            &WindowState::focused_state}))
     {
-        new_buffers.emplace_back(
-            buffer_streams->left_border,
-            renderer->render_left_border());
-        new_buffers.emplace_back(
-            buffer_streams->right_border,
-            renderer->render_right_border());
-    }
-
-    if (window_updated({
-            &WindowState::focused_state,
-            &WindowState::bottom_border_width,
-            &WindowState::bottom_border_height}))
-    {
-        new_buffers.emplace_back(
-            buffer_streams->bottom_border,
-            renderer->render_bottom_border());
+        auto const background = renderer->render_background();
+        new_buffers.emplace_back(buffer_streams->titlebar, background);
+        new_buffers.emplace_back(buffer_streams->left_border, background);
+        new_buffers.emplace_back(buffer_streams->right_border, background);
+        new_buffers.emplace_back(buffer_streams->bottom_border, background);
     }
 
     if (window_updated({
@@ -409,13 +429,16 @@ void msd::BasicDecoration::update(
             &InputState::buttons}))
     {
         new_buffers.emplace_back(
-            buffer_streams->titlebar,
-            renderer->render_titlebar());
+            buffer_streams->title,
+            renderer->render_title());
+        new_buffers.emplace_back(
+            buffer_streams->buttons,
+            renderer->render_buttons());
     }
 
     for (auto const& pair : new_buffers)
     {
         if (pair.second)
-            pair.first->submit_buffer(pair.second.value());
+            buffer_streams->submit(pair.first, pair.second.value());
     }
 }
@@ -31,8 +31,10 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <algorithm>
 #include <locale>
 #include <codecvt>
+#include <unordered_map>
 
 namespace ms = mir::scene;
 namespace mg = mir::graphics;
@@ -106,10 +108,10 @@ inline void render_row(
         return;
     geom::X const right = std::min(left.x + as_delta(length), as_x(buf_size.width));
     left.x = std::max(left.x, geom::X{});
+    if (right <= left.x)
+        return;
     uint32_t* const start = data + (left.y.as_int() * buf_size.width.as_int()) + left.x.as_int();
-    uint32_t* const end = start + right.as_int() - left.x.as_int();
-    for (uint32_t* i = start; i < end; i++)
-        *i = color;
+    std::fill_n(start, right.as_int() - left.x.as_int(), color);
 }
 
 inline void render_close_icon(
@@ -167,6 +169,47 @@ inline void render_minimize_icon(
         render_row(data, buf_size, {box.left(), y}, mini_taskbar_size, color);
     }
 }
+
+/// Blends color over a row of pixels using the glyph's coverage of each. Most of
+/// a glyph is either empty or solid, so those pixels skip the arithmetic; the
+/// color channels are blended with integer math on whole pixels (the
+/// destination's alpha is left as it is).
+inline void blend_row(
+    uint32_t* pixels,
+    unsigned char const* coverage,
+    int length,
+    uint32_t color)
+{
+    uint32_t const color_alpha = color >> 24;
+    uint32_t const color_rgb = color & 0x00FFFFFF;
+
+    for (int i = 0; i < length; i++)
+    {
+        uint32_t const alpha = (coverage[i] * color_alpha) / 255;
+        if (alpha == 0)
+            continue;
+
+        uint32_t const pixel = pixels[i];
+        if (alpha == 255)
+        {
+            pixels[i] = (pixel & 0xFF000000) | color_rgb;
+            continue;
+        }
+
+        uint32_t blended = pixel & 0xFF000000;
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            uint32_t const under = (pixel >> shift) & 0xFF;
+            uint32_t const over = (color >> shift) & 0xFF;
+            blended |= ((under * (255 - alpha)) / 255 + (over * alpha) / 255) << shift;
+        }
+        pixels[i] = blended;
+    }
+}
+
+size_t const max_cached_font_sizes{4};
+size_t const max_buttons_variants{8};
+size_t const max_cached_glyphs{512};
 }
 
 class msd::Renderer::Text::Impl
@@ -184,17 +227,40 @@ public:
         geom::Height height_pixels,
         Pixel color) override;
 
+    auto width(std::string const& text, geom::Height height_pixels) -> geom::Width override;
+
 private:
+    /// A glyph rasterized at one size, kept so titlebar redraws don't go through FreeType
+    struct Glyph
+    {
+        size_t offset;                  ///< Of the glyph's coverage in GlyphAtlas::coverage
+        geom::Size size;
+        geom::Displacement bearing;     ///< From the pen position to the glyph's top left (y up)
+        geom::Displacement advance;
+    };
+
+    /// The glyphs rasterized at one pixel height, with their coverage packed into a single allocation
+    struct GlyphAtlas
+    {
+        std::vector<unsigned char> coverage;
+        std::unordered_map<char32_t, Glyph> glyphs;
+    };
+
     std::mutex mutex;
     FT_Library library;
     FT_Face face;
+    geom::Height char_size;
+    std::map<geom::Height, GlyphAtlas> atlases;
 
     void set_char_size(geom::Height height);
     void rasterize_glyph(char32_t glyph);
+    auto atlas_for(geom::Height height) -> GlyphAtlas&;
+    auto cached_glyph(geom::Height height, GlyphAtlas& atlas, char32_t glyph) -> Glyph const&;
     void render_glyph(
         Pixel* buf,
         geom::Size buf_size,
-        FT_Bitmap const* glyph,
+        unsigned char const* coverage,
+        geom::Size glyph_size,
         geom::Point top_left,
         Pixel color);
 
@@ -216,6 +282,11 @@ public:
     {
     }
 
+    auto width(std::string const&, geom::Height) -> geom::Width override
+    {
+        return {};
+    }
+
 private:
 };
 
@@ -290,15 +361,7 @@ void msd::Renderer::Text::Impl::render(
         return;
     }
 
-    try
-    {
-        set_char_size(height_pixels);
-    }
-    catch (std::runtime_error const& error)
-    {
-        log_warning(error.what());
-        return;
-    }
+    auto& atlas = atlas_for(height_pixels);
 
     auto const utf32 = utf8_to_utf32(text);
 
@@ -306,18 +369,16 @@ void msd::Renderer::Text::Impl::render(
     {
         try
         {
-            rasterize_glyph(glyph);
+            auto const& cached = cached_glyph(height_pixels, atlas, glyph);
 
             geom::Point glyph_top_left =
                 top_left +
                 geom::Displacement{
-                    face->glyph->bitmap_left,
-                    height_pixels.as_int() - face->glyph->bitmap_top};
-            render_glyph(buf, buf_size, &face->glyph->bitmap, glyph_top_left, color);
+                    cached.bearing.dx.as_int(),
+                    height_pixels.as_int() - cached.bearing.dy.as_int()};
+            render_glyph(buf, buf_size, atlas.coverage.data() + cached.offset, cached.size, glyph_top_left, color);
 
-            top_left += geom::Displacement{
-                face->glyph->advance.x / 64,
-                face->glyph->advance.y / 64};
+            top_left += cached.advance;
         }
         catch (std::runtime_error const& error)
         {
@@ -326,11 +387,84 @@ void msd::Renderer::Text::Impl::render(
     }
 }
 
+auto msd::Renderer::Text::Impl::width(std::string const& text, geom::Height height_pixels) -> geom::Width
+{
+    if (height_pixels <= geom::Height{})
+        return {};
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (!library || !face)
+        return {};
+
+    auto& atlas = atlas_for(height_pixels);
+
+    geom::DeltaX width;
+    for (char32_t const glyph : utf8_to_utf32(text))
+    {
+        try
+        {
+            width += cached_glyph(height_pixels, atlas, glyph).advance.dx;
+        }
+        catch (std::runtime_error const&)
+        {
+            // Logged when the text is rendered
+        }
+    }
+    return geom::Width{std::max(width.as_int(), 0)};
+}
+
+auto msd::Renderer::Text::Impl::atlas_for(geom::Height height) -> GlyphAtlas&
+{
+    if (atlases.size() >= max_cached_font_sizes && atlases.find(height) == atlases.end())
+        atlases.clear();
+    return atlases[height];
+}
+
+auto msd::Renderer::Text::Impl::cached_glyph(geom::Height height, GlyphAtlas& atlas, char32_t glyph) -> Glyph const&
+{
+    auto const existing = atlas.glyphs.find(glyph);
+    if (existing != atlas.glyphs.end())
+        return existing->second;
+
+    // Window titles rarely use more than a handful of scripts, but don't let a
+    // stream of unusual titles grow the atlas forever
+    if (atlas.glyphs.size() >= max_cached_glyphs)
+    {
+        atlas.glyphs.clear();
+        atlas.coverage.clear();
+    }
+
+    set_char_size(height);
+    rasterize_glyph(glyph);
+
+    auto const& bitmap = face->glyph->bitmap;
+    Glyph const cached{
+        atlas.coverage.size(),
+        geom::Size{bitmap.width, bitmap.rows},
+        geom::Displacement{face->glyph->bitmap_left, face->glyph->bitmap_top},
+        geom::Displacement{face->glyph->advance.x / 64, face->glyph->advance.y / 64}};
+
+    // FreeType rows may be padded (or, with a negative pitch, stored bottom-up); store them packed top-down
+    for (unsigned row = 0; row < bitmap.rows; row++)
+    {
+        unsigned char const* const source = bitmap.buffer + static_cast<int>(row) * bitmap.pitch;
+        atlas.coverage.insert(atlas.coverage.end(), source, source + bitmap.width);
+    }
+
+    return atlas.glyphs.emplace(glyph, cached).first->second;
+}
+
 void msd::Renderer::Text::Impl::set_char_size(geom::Height height)
 {
+    if (height == char_size)
+        return;
+
     if (auto const error = FT_Set_Pixel_Sizes(face, 0, height.as_int()))
         BOOST_THROW_EXCEPTION(std::runtime_error(
             "Setting char size failed with error " + std::to_string(error)));
+
+    char_size = height;
 }
 
 void msd::Renderer::Text::Impl::rasterize_glyph(char32_t glyph)
@@ -349,40 +483,32 @@ void msd::Renderer::Text::Impl::rasterize_glyph(char32_t glyph)
 void msd::Renderer::Text::Impl::render_glyph(
     Pixel* buf,
     geom::Size buf_size,
-    FT_Bitmap const* glyph,
+    unsigned char const* coverage,
+    geom::Size glyph_size,
     geom::Point top_left,
     Pixel color)
 {
     geom::X const buffer_left = std::max(top_left.x, geom::X{});
-    geom::X const buffer_right = std::min(top_left.x + geom::DeltaX{glyph->width}, as_x(buf_size.width));
+    geom::X const buffer_right = std::min(top_left.x + as_delta(glyph_size.width), as_x(buf_size.width));
 
     geom::Y const buffer_top = std::max(top_left.y, geom::Y{});
-    geom::Y const buffer_bottom = std::min(top_left.y + geom::DeltaY{glyph->rows}, as_y(buf_size.height));
+    geom::Y const buffer_bottom = std::min(top_left.y + as_delta(glyph_size.height), as_y(buf_size.height));
 
-    geom::Displacement const glyph_offset = as_displacement(top_left);
+    if (buffer_right <= buffer_left)
+        return;
 
-    unsigned char* const color_pixels = (unsigned char *)&color;
-    unsigned char const color_alpha = color_pixels[3];
+    geom::Displacement const glyph_offset = as_displacement(top_left);
+    auto const glyph_pitch = glyph_size.width.as_int();
+    auto const row_length = (buffer_right - buffer_left).as_int();
 
     for (geom::Y buffer_y = buffer_top; buffer_y < buffer_bottom; buffer_y += geom::DeltaY{1})
     {
         geom::Y const glyph_y = buffer_y - glyph_offset.dy;
-        unsigned char* const glyph_row = glyph->buffer + glyph_y.as_int() * glyph->pitch;
-        Pixel* const buffer_row = buf + buffer_y.as_int() * buf_size.width.as_int();
-
-        for (geom::X buffer_x = buffer_left; buffer_x < buffer_right; buffer_x += geom::DeltaX{1})
-        {
-            geom::X const glyph_x = buffer_x - glyph_offset.dx;
-            unsigned char const glyph_alpha = ((int)glyph_row[glyph_x.as_int()] * color_alpha) / 255;
-            unsigned char* const buffer_pixels = (unsigned char *)(buffer_row + buffer_x.as_int());
-            for (int i = 0; i < 3; i++)
-            {
-                // Blend color with the previous buffer color based on the glyph's alpha
-                buffer_pixels[i] =
-                    ((int)buffer_pixels[i] * (255 - glyph_alpha)) / 255 +
-                    ((int)color_pixels[i] * glyph_alpha) / 255;
-            }
-        }
+        blend_row(
+            buf + buffer_y.as_int() * buf_size.width.as_int() + buffer_left.as_int(),
+            coverage + glyph_y.as_int() * glyph_pitch + (buffer_left - glyph_offset.dx).as_int(),
+            row_length,
+            color);
     }
 }
 
@@ -468,179 +594,185 @@ msd::Renderer::Renderer(
 
 void msd::Renderer::update_state(WindowState const& window_state, InputState const& input_state)
 {
-    left_border_size = window_state.left_border_rect().size;
-    right_border_size = window_state.right_border_rect().size;
-    bottom_border_size = window_state.bottom_border_rect().size;
-
-    size_t length{0};
-    length = std::max(length, area(left_border_size));
-    length = std::max(length, area(right_border_size));
-    length = std::max(length, area(bottom_border_size));
-
-    if (length != solid_color_pixels_length)
-    {
-        solid_color_pixels_length = length;
-        solid_color_pixels.reset(); // force a reallocation next time it's needed
-    }
-
-    if (window_state.titlebar_rect().size != titlebar_size)
-    {
-        titlebar_size = window_state.titlebar_rect().size;
-        titlebar_pixels.reset(); // force a reallocation next time it's needed
-    }
-
-    Theme const* const new_theme = (window_state.focused_state() == mir_window_focus_state_focused) ?
+    current_theme = (window_state.focused_state() == mir_window_focus_state_focused) ?
         &focused_theme :
         &unfocused_theme;
 
-    if (new_theme != current_theme)
+    auto const titlebar = window_state.titlebar_rect();
+
+    // The buttons (and the gap to their right) are anchored to the right of the titlebar
+    geom::Rectangle new_buttons_rect{{titlebar.right(), titlebar.top()}, {geom::Width{}, titlebar.size.height}};
+    for (auto const& button : input_state.buttons())
     {
-        current_theme = new_theme;
-        needs_titlebar_redraw = true;
-        needs_solid_color_redraw = true;
+        if (button.rect.left() < new_buttons_rect.left())
+            new_buttons_rect.top_left.x = button.rect.left();
     }
+    new_buttons_rect.size.width = as_width(titlebar.right() - new_buttons_rect.left());
 
-    if (window_state.window_name() != name)
+    std::vector<ButtonInfo> new_buttons;
+    for (auto button : input_state.buttons())
     {
-        name = window_state.window_name();
-        needs_titlebar_redraw = true;
+        button.rect.top_left = button.rect.top_left - as_displacement(new_buttons_rect.top_left);
+        new_buttons.push_back(button);
     }
 
-    if (input_state.buttons() != buttons)
-    {
-        // If the number of buttons or their location changed, redraw the whole titlebar
-        // Otherwise if the buttons are in the same place, just redraw them
-        if (input_state.buttons().size() != buttons.size())
+    auto const same_layout = [](std::vector<ButtonInfo> const& a, std::vector<ButtonInfo> const& b)
         {
-            needs_titlebar_redraw = true;
-        }
-        else
+            return std::equal(
+                a.begin(), a.end(),
+                b.begin(), b.end(),
+                [](ButtonInfo const& a, ButtonInfo const& b)
+                {
+                    return a.function == b.function && a.rect == b.rect;
+                });
+        };
+
+    if (new_buttons_rect.size != buttons_rect_.size || !same_layout(new_buttons, buttons))
+        buttons_buffers.clear();
+
+    buttons = std::move(new_buttons);
+    buttons_rect_ = new_buttons_rect;
+
+    // The title is anchored to the left, and is only redrawn when it is truncated differently
+    auto const font_left = static_geometry->title_font_top_left.x - geom::X{};
+    auto const title_width = window_state.window_name().empty() ?
+        geom::Width{} :
+        text->width(window_state.window_name(), static_geometry->title_font_height) + font_left * 2;
+    geom::Rectangle const new_title_rect{
+        titlebar.top_left,
         {
-            for (unsigned i = 0; i < buttons.size(); i++)
-            {
-                if (input_state.buttons()[i].rect != buttons[i].rect)
-                    needs_titlebar_redraw = true;
-            }
-        }
-        buttons = input_state.buttons();
-        needs_titlebar_buttons_redraw = true;
-    }
+            std::max(std::min(title_width, as_width(buttons_rect_.left() - titlebar.left())), geom::Width{}),
+            titlebar.size.height
+        }};
+
+    if (window_state.window_name() != name || new_title_rect.size != title_rect_.size)
+        title_buffers.clear();
+
+    name = window_state.window_name();
+    title_rect_ = new_title_rect;
 }
 
-auto msd::Renderer::render_titlebar() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+auto msd::Renderer::title_rect() const -> geom::Rectangle
 {
-    if (!area(titlebar_size))
-        return std::experimental::nullopt;
+    return title_rect_;
+}
 
-    if (!titlebar_pixels)
-    {
-        titlebar_pixels = alloc_pixels(titlebar_size);
-        needs_titlebar_redraw = true;
-    }
+auto msd::Renderer::buttons_rect() const -> geom::Rectangle
+{
+    return buttons_rect_;
+}
 
-    if (needs_titlebar_redraw)
-    {
-        for (geom::Y y{0}; y < as_y(titlebar_size.height); y += geom::DeltaY{1})
-        {
-            render_row(
-                titlebar_pixels.get(), titlebar_size,
-                {0, y}, titlebar_size.width,
-                current_theme->background_color);
-        }
+auto msd::Renderer::render_background() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+{
+    auto const cached = background_buffers.find(current_theme);
+    if (cached != background_buffers.end())
+        return cached->second;
+
+    auto const buffer = make_buffer(&current_theme->background_color, {1, 1});
+    if (buffer)
+        background_buffers[current_theme] = buffer.value();
+    return buffer;
+}
 
-        text->render(
-            titlebar_pixels.get(),
-            titlebar_size,
-            name,
-            static_geometry->title_font_top_left,
-            static_geometry->title_font_height,
-            current_theme->text_color);
-    }
+auto msd::Renderer::render_title() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+{
+    auto const size = title_rect_.size;
+    if (!area(size))
+        return std::experimental::nullopt;
 
-    if (needs_titlebar_redraw || needs_titlebar_buttons_redraw)
+    auto const cached = title_buffers.find(current_theme);
+    if (cached != title_buffers.end())
+        return cached->second;
+
+    auto const title_pixels = pixels_for(size);
+    for (geom::Y y{0}; y < as_y(size.height); y += geom::DeltaY{1})
     {
-        for (auto const& button : buttons)
-        {
-            auto const icon = button_icons.find(button.function);
-            if (icon != button_icons.end())
-            {
-                Pixel button_color = icon->second.normal_color;
-                if (button.state == ButtonState::Hovered)
-                    button_color = icon->second.active_color;
-                for (geom::Y y{button.rect.top()}; y < button.rect.bottom(); y += geom::DeltaY{1})
-                {
-                    render_row(
-                        titlebar_pixels.get(),
-                        titlebar_size,
-                        {button.rect.left(), y},
-                        button.rect.size.width,
-                        button_color);
-                }
-                geom::Rectangle const icon_rect = {
-                button.rect.top_left + static_geometry->icon_padding, {
-                    button.rect.size.width - static_geometry->icon_padding.dx * 2,
-                    button.rect.size.height - static_geometry->icon_padding.dy * 2}};
-                icon->second.render_icon(
-                    titlebar_pixels.get(),
-                    titlebar_size,
-                    icon_rect,
-                    static_geometry->icon_line_width,
-                    icon->second.icon_color);
-            }
-            else
-            {
-                log_warning("Could not render decoration button with unknown function %d\n", button.function);
-            }
-        }
+        render_row(title_pixels, size, {0, y}, size.width, current_theme->background_color);
     }
 
-    needs_titlebar_redraw = false;
-    needs_titlebar_buttons_redraw = false;
-
-    return make_buffer(titlebar_pixels.get(), titlebar_size);
+    text->render(
+        title_pixels,
+        size,
+        name,
+        static_geometry->title_font_top_left,
+        static_geometry->title_font_height,
+        current_theme->text_color);
+
+    auto const buffer = make_buffer(title_pixels, size);
+    if (buffer)
+        title_buffers[current_theme] = buffer.value();
+    return buffer;
 }
 
-auto msd::Renderer::render_left_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+auto msd::Renderer::render_buttons() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
 {
-    if (!area(left_border_size))
+    auto const size = buttons_rect_.size;
+    if (!area(size))
         return std::experimental::nullopt;
-    update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), left_border_size);
-}
 
-auto msd::Renderer::render_right_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
-{
-    if (!area(right_border_size))
-        return std::experimental::nullopt;
-    update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), right_border_size);
-}
+    ButtonsVariant variant{current_theme, {}};
+    for (auto const& button : buttons)
+        variant.second.push_back(button.state);
 
-auto msd::Renderer::render_bottom_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
-{
-    if (!area(bottom_border_size))
-        return std::experimental::nullopt;
-    update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), bottom_border_size);
-}
+    auto const cached = buttons_buffers.find(variant);
+    if (cached != buttons_buffers.end())
+        return cached->second;
 
-void msd::Renderer::update_solid_color_pixels()
-{
-    if (!solid_color_pixels)
+    auto const buttons_pixels = pixels_for(size);
+    for (geom::Y y{0}; y < as_y(size.height); y += geom::DeltaY{1})
     {
-        solid_color_pixels = alloc_pixels(geom::Size{solid_color_pixels_length, 1});
-        needs_solid_color_redraw = true;
+        render_row(buttons_pixels, size, {0, y}, size.width, current_theme->background_color);
     }
 
-    if (needs_solid_color_redraw)
+    for (auto const& button : buttons)
     {
-        render_row(
-            solid_color_pixels.get(), geom::Size{solid_color_pixels_length, 1},
-            geom::Point{}, geom::Width{solid_color_pixels_length},
-            current_theme->background_color);
+        auto const icon = button_icons.find(button.function);
+        if (icon != button_icons.end())
+        {
+            Pixel button_color = icon->second.normal_color;
+            if (button.state == ButtonState::Hovered)
+                button_color = icon->second.active_color;
+            for (geom::Y y{button.rect.top()}; y < button.rect.bottom(); y += geom::DeltaY{1})
+            {
+                render_row(
+                    buttons_pixels,
+                    size,
+                    {button.rect.left(), y},
+                    button.rect.size.width,
+                    button_color);
+            }
+            geom::Rectangle const icon_rect = {
+            button.rect.top_left + static_geometry->icon_padding, {
+                button.rect.size.width - static_geometry->icon_padding.dx * 2,
+                button.rect.size.height - static_geometry->icon_padding.dy * 2}};
+            icon->second.render_icon(
+                buttons_pixels,
+                size,
+                icon_rect,
+                static_geometry->icon_line_width,
+                icon->second.icon_color);
+        }
+        else
+        {
+            log_warning("Could not render decoration button with unknown function %d\n", button.function);
+        }
     }
 
-    needs_solid_color_redraw = false;
+    auto const buffer = make_buffer(buttons_pixels, size);
+    if (buffer)
+    {
+        if (buttons_buffers.size() >= max_buttons_variants)
+            buttons_buffers.clear();
+        buttons_buffers[variant] = buffer.value();
+    }
+    return buffer;
+}
+
+auto msd::Renderer::pixels_for(geom::Size size) -> Pixel*
+{
+    if (pixels.size() < area(size))
+        pixels.resize(area(size));
+    return pixels.data();
 }
 
 auto msd::Renderer::make_buffer(
@@ -668,12 +800,3 @@ auto msd::Renderer::make_buffer(
         return std::experimental::nullopt;
     }
 }
-
-auto msd::Renderer::alloc_pixels(geometry::Size size) -> std::unique_ptr<uint32_t[]>
-{
-    size_t const buf_size = area(size) * bytes_per_pixel;
-    if (buf_size)
-        return std::unique_ptr<uint32_t[]>{new uint32_t[buf_size]};
-    else
-        return nullptr;
-}
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 
 namespace mir
 {
@@ -44,6 +45,12 @@ struct StaticGeometry;
 auto const buffer_format = mir_pixel_format_argb_8888;
 auto const bytes_per_pixel = 4;
 
+/// Draws the parts of a decoration into buffers.
+///
+/// Everything that is just background color (the borders, and the titlebar behind
+/// the title and buttons) is a single pixel buffer, to be scaled up by the
+/// compositor. The title and the buttons each get a buffer of their own that is
+/// independent of the window's size, so resizing a window just repositions them.
 class Renderer
 {
 public:
@@ -52,10 +59,15 @@ public:
         std::shared_ptr<StaticGeometry const> const& static_geometry);
 
     void update_state(WindowState const& window_state, InputState const& input_state);
-    auto render_titlebar() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
-    auto render_left_border() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
-    auto render_right_border() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
-    auto render_bottom_border() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
+
+    /// Where the title goes, relative to the decoration (may be empty)
+    auto title_rect() const -> geometry::Rectangle;
+    /// Where the buttons go, relative to the decoration (may be empty)
+    auto buttons_rect() const -> geometry::Rectangle;
+
+    auto render_background() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
+    auto render_title() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
+    auto render_buttons() -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
 
 private:
     using Pixel = uint32_t;
@@ -75,6 +87,9 @@ private:
             geometry::Height height_pixels,
             Pixel color) = 0;
 
+        /// How far render() would advance across the buffer drawing text
+        virtual auto width(std::string const& text, geometry::Height height_pixels) -> geometry::Width = 0;
+
     private:
         class Impl;
         class Null;
@@ -112,28 +127,27 @@ private:
     std::map<ButtonFunction, Icon const> button_icons;
     std::shared_ptr<StaticGeometry const> const static_geometry;
 
-    bool needs_solid_color_redraw{true};
-    geometry::Size left_border_size;
-    geometry::Size right_border_size;
-    geometry::Size bottom_border_size;
-    size_t solid_color_pixels_length{0};
-    std::unique_ptr<Pixel[]> solid_color_pixels; // can be nullptr
-
-    geometry::Size titlebar_size{};
-    std::unique_ptr<Pixel[]> titlebar_pixels; // can be nullptr
-
-    bool needs_titlebar_redraw{true};
-    bool needs_titlebar_buttons_redraw{true};
     std::string name;
+    geometry::Rectangle title_rect_;
+    /// Relative to buttons_rect_
     std::vector<ButtonInfo> buttons;
+    geometry::Rectangle buttons_rect_;
+
+    /// Buffers already rendered for the current title and button layout, so that
+    /// moving focus or the pointer back and forth doesn't redraw (or reallocate) them
+    std::map<Theme const*, std::shared_ptr<graphics::Buffer>> background_buffers;
+    std::map<Theme const*, std::shared_ptr<graphics::Buffer>> title_buffers;
+    using ButtonsVariant = std::pair<Theme const*, std::vector<ButtonState>>;
+    std::map<ButtonsVariant, std::shared_ptr<graphics::Buffer>> buttons_buffers;
+
+    std::vector<Pixel> pixels;
 
     std::shared_ptr<Text> const text;
 
-    void update_solid_color_pixels();
+    auto pixels_for(geometry::Size size) -> Pixel*;
     auto make_buffer(
         Pixel const* pixels,
         geometry::Size size) -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
-    static auto alloc_pixels(geometry::Size size) -> std::unique_ptr<Pixel[]>;
 };
 }
 }
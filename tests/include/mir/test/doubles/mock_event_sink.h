@@ -43,7 +43,7 @@ struct MockEventSink : public frontend::EventSink
 
     MOCK_METHOD1(handle_event, void(MirEvent const&));
     MOCK_METHOD1(handle_lifecycle_event, void(MirLifecycleState));
-    MOCK_METHOD1(handle_display_config_change, void(graphics::DisplayConfiguration const&));
+    MOCK_METHOD1(handle_display_config_change, void(std::shared_ptr<graphics::DisplayConfiguration const> const&));
     MOCK_METHOD1(handle_error, void(ClientVisibleError const&));
     MOCK_METHOD1(send_ping, void(int32_t));
     MOCK_METHOD3(send_buffer, void(frontend::BufferStreamId, graphics::Buffer&, graphics::BufferIpcMsgType));
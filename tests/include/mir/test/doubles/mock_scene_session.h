@@ -20,6 +20,7 @@
 #define MIR_TEST_DOUBLES_MOCK_SCENE_SESSION_H_
 
 #include "mir/scene/session.h"
+#include "mir/scene/session_resources.h"
 #include "mir/scene/surface.h"
 #include "mir/scene/surface_creation_parameters.h"
 #include "mir/graphics/display_configuration.h"
@@ -69,6 +70,13 @@ struct MockSceneSession : public scene::Session
     
     MOCK_METHOD2(configure_streams, void(scene::Surface&, std::vector<shell::StreamSpecification> const&));
     MOCK_METHOD1(destroy_surface, void (std::weak_ptr<scene::Surface> const&));
+
+    auto resources() const -> std::shared_ptr<scene::SessionResources> override
+    {
+        return resources_;
+    }
+
+    std::shared_ptr<scene::SessionResources> const resources_{std::make_shared<scene::SessionResources>("")};
 };
 
 }
@@ -60,6 +60,10 @@ public:
         std::shared_ptr<scene::Session> const&) override
     {
     }
+    graphics::Frame last_frame_on(unsigned) const override
+    {
+        return {};
+    }
 };
 }
 }
@@ -38,7 +38,7 @@ struct NullEventSink : public frontend::EventSink
 {
     void handle_event(EventUPtr&&) override {}
     void handle_lifecycle_event(MirLifecycleState) override {}
-    void handle_display_config_change(graphics::DisplayConfiguration const&) override {}
+    void handle_display_config_change(std::shared_ptr<graphics::DisplayConfiguration const> const&) override {}
     void handle_error(ClientVisibleError const&) override {}
     void send_ping(int32_t) override {}
     void send_buffer(frontend::BufferStreamId, graphics::Buffer&, graphics::BufferIpcMsgType) override {}
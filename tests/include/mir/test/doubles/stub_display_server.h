@@ -138,6 +138,10 @@ struct StubDisplayServer : public mir::frontend::detail::DisplayServer
         mir::protobuf::SurfaceId const* /*request*/,
         mir::protobuf::PersistentSurfaceId* /*response*/,
         google::protobuf::Closure* /*done*/) override {}
+    void frame_timing(
+        mir::protobuf::FrameTimingRequest const* /*request*/,
+        mir::protobuf::FrameTiming* /*response*/,
+        google::protobuf::Closure* /*done*/) override {}
     void pong(
         mir::protobuf::PingEvent const* /*request*/,
         mir::protobuf::Void* /*response*/,
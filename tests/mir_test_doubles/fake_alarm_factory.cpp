@@ -17,9 +17,11 @@
  */
 
 #include "mir/test/doubles/fake_alarm_factory.h"
+#include "mir/lockable_callback.h"
 
 #include <numeric>
 #include <algorithm>
+#include <mutex>
 
 namespace mtd = mir::test::doubles;
 namespace mt = mir::time;
@@ -147,9 +149,15 @@ std::unique_ptr<mt::Alarm> mtd::FakeAlarmFactory::create_alarm(
 }
 
 std::unique_ptr<mt::Alarm> mtd::FakeAlarmFactory::create_alarm(
-    std::unique_ptr<LockableCallback> /*callback*/)
+    std::unique_ptr<LockableCallback> callback)
 {
-    throw std::logic_error{"Lockable alarm creation not implemented for fake alarms"};
+    std::shared_ptr<LockableCallback> const lockable_callback{std::move(callback)};
+    return create_alarm(
+        [lockable_callback]
+        {
+            std::lock_guard<LockableCallback> lock{*lockable_callback};
+            (*lockable_callback)();
+        });
 }
 
 void mtd::FakeAlarmFactory::advance_by(mt::Duration step)
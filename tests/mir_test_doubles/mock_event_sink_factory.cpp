@@ -36,7 +36,7 @@ public:
 
     void handle_event(mir::EventUPtr&& event) override;
     void handle_lifecycle_event(MirLifecycleState state) override;
-    void handle_display_config_change(mg::DisplayConfiguration const& conf) override;
+    void handle_display_config_change(std::shared_ptr<mg::DisplayConfiguration const> const& conf) override;
     void handle_error(mir::ClientVisibleError const& error) override;
     void send_ping(int32_t serial) override;
     void send_buffer(mf::BufferStreamId id, mg::Buffer& buf, mg::BufferIpcMsgType type) override;
@@ -70,7 +70,7 @@ void GloballyUniqueMockEventSink::handle_lifecycle_event(MirLifecycleState state
 }
 
 void GloballyUniqueMockEventSink::handle_display_config_change(
-    mg::DisplayConfiguration const& conf)
+    std::shared_ptr<mg::DisplayConfiguration const> const& conf)
 {
     underlying_sink->handle_display_config_change(conf);
 }
@@ -118,6 +118,11 @@ void mtd::StubSession::send_input_config(MirInputConfig const& /*config*/)
 {
 }
 
+auto mtd::StubSession::resources() const -> std::shared_ptr<ms::SessionResources>
+{
+    return resources_;
+}
+
 namespace
 {
 // Ensure we don't accidentally have an abstract class
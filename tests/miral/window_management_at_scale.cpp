@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <set>
+
+using namespace miral;
+using namespace testing;
+namespace mt = mir::test;
+
+namespace
+{
+Rectangle const display_area{{0, 0}, {1280, 720}};
+
+auto const window_count = 512u;
+auto const workspace_count = 4u;
+
+struct WindowManagementAtScale : mt::TestWindowManagerTools
+{
+    std::vector<Window> windows;
+    std::vector<std::shared_ptr<Workspace>> workspaces;
+
+    void SetUp() override
+    {
+        notify_configuration_applied(create_fake_display_configuration({display_area}));
+        basic_window_manager.add_session(session);
+
+        EXPECT_CALL(*window_manager_policy, advise_new_window(_))
+            .WillRepeatedly(Invoke([this](WindowInfo const& window_info){ windows.push_back(window_info.window()); }));
+
+        for (auto i = 0u; i != workspace_count; ++i)
+            workspaces.push_back(basic_window_manager.create_workspace());
+    }
+
+    void create_windows()
+    {
+        mir::scene::SurfaceCreationParameters creation_parameters;
+        creation_parameters.size = Size{100, 100};
+
+        for (auto i = 0u; i != window_count; ++i)
+        {
+            basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+            basic_window_manager.add_tree_to_workspace(windows.back(), workspaces[i % workspace_count]);
+            basic_window_manager.select_active_window(windows.back());
+        }
+    }
+};
+}
+
+TEST_F(WindowManagementAtScale, creating_windows)
+{
+    create_windows();
+
+    EXPECT_THAT(windows.size(), Eq(window_count));
+    EXPECT_THAT(basic_window_manager.active_window(), Eq(windows.back()));
+}
+
+TEST_F(WindowManagementAtScale, focus_next_within_application_cycles_through_workspace)
+{
+    create_windows();
+
+    auto const first = basic_window_manager.active_window();
+    auto const windows_per_workspace = window_count/workspace_count;
+    std::set<Window> visited;
+
+    for (auto i = 0u; i != windows_per_workspace; ++i)
+    {
+        basic_window_manager.focus_next_within_application();
+        visited.insert(basic_window_manager.active_window());
+    }
+
+    EXPECT_THAT(basic_window_manager.active_window(), Eq(first));
+    EXPECT_THAT(visited.size(), Eq(windows_per_workspace));
+}
+
+TEST_F(WindowManagementAtScale, focus_prev_within_application_cycles_through_workspace)
+{
+    create_windows();
+
+    auto const first = basic_window_manager.active_window();
+    auto const windows_per_workspace = window_count/workspace_count;
+    std::set<Window> visited;
+
+    for (auto i = 0u; i != windows_per_workspace; ++i)
+    {
+        basic_window_manager.focus_prev_within_application();
+        visited.insert(basic_window_manager.active_window());
+    }
+
+    EXPECT_THAT(basic_window_manager.active_window(), Eq(first));
+    EXPECT_THAT(visited.size(), Eq(windows_per_workspace));
+}
+
+TEST_F(WindowManagementAtScale, removing_active_windows)
+{
+    create_windows();
+
+    for (auto i = window_count; i-- != 0;)
+    {
+        basic_window_manager.remove_surface(session, windows[i]);
+    }
+
+    EXPECT_THAT(basic_window_manager.active_window(), Eq(Window{}));
+}
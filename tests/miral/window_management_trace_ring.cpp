@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window_management_trace_ring.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+using namespace testing;
+using miral::WindowManagementTraceRing;
+
+namespace
+{
+auto dump_of(WindowManagementTraceRing& ring) -> std::string
+{
+    std::stringstream out;
+    ring.dump(out);
+    return out.str();
+}
+
+void outer(WindowManagementTraceRing* ring)
+{
+    WindowManagementTraceRing::Recorder const recorder{ring, "outer", 0x1234};
+    WindowManagementTraceRing::Recorder const nested{ring, "inner"};
+}
+}
+
+TEST(WindowManagementTraceRing, dump_lists_nested_calls)
+{
+    WindowManagementTraceRing ring{8};
+
+    outer(&ring);
+
+    auto const dump = dump_of(ring);
+
+    EXPECT_THAT(dump, HasSubstr("outer window=0x1234"));
+    EXPECT_THAT(dump, HasSubstr("  inner ("));
+    EXPECT_THAT(dump.find("outer"), Lt(dump.find("inner")));
+}
+
+TEST(WindowManagementTraceRing, dump_lists_calls_in_the_order_they_started_even_if_the_clock_does_not_tell)
+{
+    WindowManagementTraceRing ring{8};
+    auto const start = WindowManagementTraceRing::Clock::now();
+
+    auto const outer_call = ring.start_call();
+    auto const inner_call = ring.start_call();
+
+    // Recorded as they finish: the inner call first
+    ring.record("inner", 0, 1, inner_call, start, {});
+    ring.record("outer", 0, 0, outer_call, start, {});
+
+    auto const dump = dump_of(ring);
+
+    EXPECT_THAT(dump.find("outer"), Lt(dump.find("inner")));
+}
+
+TEST(WindowManagementTraceRing, dump_only_lists_calls_since_the_last_dump)
+{
+    WindowManagementTraceRing ring{8};
+
+    outer(&ring);
+    dump_of(ring);
+
+    EXPECT_THAT(dump_of(ring), Eq(""));
+}
+
+TEST(WindowManagementTraceRing, dump_reports_overwritten_calls)
+{
+    WindowManagementTraceRing ring{4};
+
+    for (auto i = 0; i != 5; ++i)
+        outer(&ring);
+
+    EXPECT_THAT(dump_of(ring), StartsWith("6 earlier record(s) overwritten\n"));
+}
+
+TEST(WindowManagementTraceRing, recorder_without_a_ring_does_nothing)
+{
+    WindowManagementTraceRing ring{8};
+
+    outer(nullptr);
+
+    EXPECT_THAT(dump_of(ring), Eq(""));
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <miral/window_manager_snapshot.h>
+#include <mir/test/signal.h>
+
+#include <thread>
+
+using namespace miral;
+using namespace testing;
+namespace mt = mir::test;
+using namespace std::chrono_literals;
+
+namespace
+{
+Rectangle const display_area{{0, 0}, {640, 480}};
+
+struct ModelSnapshot : mt::TestWindowManagerTools
+{
+    Window window_a;
+    Window window_b;
+
+    void SetUp() override
+    {
+        notify_configuration_applied(create_fake_display_configuration({display_area}));
+        basic_window_manager.add_session(session);
+
+        EXPECT_CALL(*window_manager_policy, advise_new_window(_))
+            .WillOnce(Invoke([this](WindowInfo const& window_info){ window_a = window_info.window(); }))
+            .WillOnce(Invoke([this](WindowInfo const& window_info){ window_b = window_info.window(); }));
+
+        mir::scene::SurfaceCreationParameters creation_parameters;
+        creation_parameters.size = Size{100, 100};
+        basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+        basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+
+        Mock::VerifyAndClearExpectations(window_manager_policy);
+
+        basic_window_manager.invoke_under_lock([this]{ basic_window_manager.select_active_window(window_a); });
+    }
+};
+}
+
+TEST_F(ModelSnapshot, contains_applications_and_windows)
+{
+    auto const snapshot = basic_window_manager.snapshot();
+
+    EXPECT_THAT(snapshot->active_window, Eq(window_a));
+    EXPECT_THAT(snapshot->applications, ElementsAre(Application{session}));
+
+    ASSERT_THAT(snapshot->windows.size(), Eq(2u));
+    for (auto const& window : snapshot->windows)
+    {
+        EXPECT_THAT(window.window, AnyOf(Eq(window_a), Eq(window_b)));
+        EXPECT_THAT(window.size, Eq(Size{100, 100}));
+    }
+}
+
+TEST_F(ModelSnapshot, is_reused_while_model_is_unchanged)
+{
+    auto const snapshot = basic_window_manager.snapshot();
+
+    EXPECT_THAT(basic_window_manager.snapshot(), Eq(snapshot));
+}
+
+TEST_F(ModelSnapshot, is_replaced_after_model_changes)
+{
+    auto const snapshot = basic_window_manager.snapshot();
+
+    basic_window_manager.invoke_under_lock([this]{ basic_window_manager.select_active_window(window_b); });
+
+    EXPECT_THAT(basic_window_manager.snapshot()->active_window, Eq(window_b));
+    EXPECT_THAT(snapshot->active_window, Eq(window_a));
+}
+
+TEST_F(ModelSnapshot, does_not_wait_for_model_to_be_unlocked)
+{
+    auto const snapshot = basic_window_manager.snapshot();
+
+    mt::Signal locked;
+    mt::Signal release;
+
+    std::thread holder{[&]
+        {
+            basic_window_manager.invoke_under_lock([&]
+                {
+                    basic_window_manager.select_active_window(window_b);
+                    locked.raise();
+                    release.wait_for(10s);
+                });
+        }};
+
+    ASSERT_TRUE(locked.wait_for(10s));
+
+    // The model is locked, so we get the snapshot taken before the change (not a partial one)
+    EXPECT_THAT(basic_window_manager.snapshot(), Eq(snapshot));
+
+    release.raise();
+    holder.join();
+
+    EXPECT_THAT(basic_window_manager.snapshot()->active_window, Eq(window_b));
+}
+
+TEST_F(ModelSnapshot, is_released_when_a_window_is_removed)
+{
+    std::weak_ptr<WindowManagerSnapshot const> const snapshot{basic_window_manager.snapshot()};
+
+    basic_window_manager.remove_surface(session, window_b);
+
+    EXPECT_TRUE(snapshot.expired());
+    EXPECT_THAT(basic_window_manager.snapshot()->windows.size(), Eq(1u));
+}
+
+TEST_F(ModelSnapshot, is_released_when_an_application_is_removed)
+{
+    std::weak_ptr<WindowManagerSnapshot const> const snapshot{basic_window_manager.snapshot()};
+
+    basic_window_manager.remove_surface(session, window_a);
+    basic_window_manager.remove_surface(session, window_b);
+    basic_window_manager.remove_session(session);
+
+    EXPECT_TRUE(snapshot.expired());
+    EXPECT_THAT(basic_window_manager.snapshot()->applications, IsEmpty());
+}
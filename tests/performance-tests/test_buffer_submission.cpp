@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/async_server_runner.h"
+#include "mir_toolkit/mir_client_library.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace mtf = mir_test_framework;
+
+using namespace testing;
+
+namespace
+{
+struct BufferSubmissionPerformance : testing::Test, mtf::AsyncServerRunner
+{
+    void SetUp() override
+    {
+        start_server();
+
+        connection = mir_connect_sync(new_connection().c_str(), "Perf test");
+        if (!mir_connection_is_valid(connection))
+        {
+            std::string error_msg{"Could not create connection: "};
+            error_msg.append(mir_connection_get_error_message(connection));
+            throw std::runtime_error(error_msg);
+        }
+
+        auto spec = mir_create_normal_window_spec(connection, 64, 64);
+        window = mir_create_window_sync(spec);
+        mir_window_spec_release(spec);
+
+        if (!mir_window_is_valid(window))
+        {
+            std::string error_msg{"Could not create window: "};
+            error_msg.append(mir_window_get_error_message(window));
+            throw std::runtime_error(error_msg);
+        }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        stream = mir_window_get_buffer_stream(window);
+#pragma GCC diagnostic pop
+    }
+
+    void TearDown() override
+    {
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+        stop_server();
+    }
+
+    // Each swap is a submit_buffer call followed by waiting for the server
+    // to hand a buffer back (the old "exchange_buffer" round-trip).
+    double round_trips_per_second(int swap_interval, int iterations)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        if (auto const wait_handle = mir_buffer_stream_set_swapinterval(stream, swap_interval))
+            mir_wait_for(wait_handle);
+#pragma GCC diagnostic pop
+
+        auto const start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i != iterations; ++i)
+            mir_buffer_stream_swap_buffers_sync(stream);
+
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        return iterations / elapsed.count();
+    }
+
+    MirConnection* connection = nullptr;
+    MirWindow* window = nullptr;
+    MirBufferStream* stream = nullptr;
+};
+}
+
+TEST_F(BufferSubmissionPerformance, submit_buffer_round_trips_per_second)
+{
+    auto const rate = round_trips_per_second(0, 2000);
+
+    std::cout << "submit_buffer round-trips per second (swap interval 0): " << rate << std::endl;
+
+    //NOTE: Ideally, the expected number should vary according to platform
+    EXPECT_THAT(rate, Gt(500.0));
+}
+
+TEST_F(BufferSubmissionPerformance, exchange_buffer_round_trips_per_second_with_vsync)
+{
+    auto const rate = round_trips_per_second(1, 120);
+
+    std::cout << "submit_buffer round-trips per second (swap interval 1): " << rate << std::endl;
+
+    // Throttled to the (stub) display refresh rate, so only check we keep up
+    EXPECT_THAT(rate, Gt(30.0));
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace miral;
+using namespace testing;
+namespace mt = mir::test;
+
+namespace
+{
+Rectangle const display_area{{0, 0}, {1280, 720}};
+auto const workspace_count = 4u;
+
+struct WindowManagementPerformance : mt::TestWindowManagerTools, WithParamInterface<unsigned>
+{
+    unsigned const window_count{GetParam()};
+    std::vector<Window> windows;
+    std::vector<std::shared_ptr<Workspace>> workspaces;
+
+    void SetUp() override
+    {
+        notify_configuration_applied(create_fake_display_configuration({display_area}));
+        basic_window_manager.add_session(session);
+
+        EXPECT_CALL(*window_manager_policy, advise_new_window(_))
+            .WillRepeatedly(Invoke([this](WindowInfo const& window_info){ windows.push_back(window_info.window()); }));
+
+        for (auto i = 0u; i != workspace_count; ++i)
+            workspaces.push_back(basic_window_manager.create_workspace());
+    }
+
+    /// Creates the windows across the workspaces, returning the time taken for each
+    auto create_windows() -> std::chrono::duration<double, std::micro>
+    {
+        mir::scene::SurfaceCreationParameters creation_parameters;
+        creation_parameters.size = Size{100, 100};
+
+        auto const start = std::chrono::steady_clock::now();
+
+        for (auto i = 0u; i != window_count; ++i)
+        {
+            basic_window_manager.add_surface(session, creation_parameters, &create_surface);
+            basic_window_manager.add_tree_to_workspace(windows.back(), workspaces[i % workspace_count]);
+            basic_window_manager.select_active_window(windows.back());
+        }
+
+        return (std::chrono::steady_clock::now() - start) / window_count;
+    }
+
+    /// Cycles focus through a workspace's windows, returning the time taken for each focus change
+    template<typename FocusChange>
+    auto cycle_focus(FocusChange focus_change) -> std::chrono::duration<double, std::micro>
+    {
+        auto const focus_changes = window_count / workspace_count;
+        auto const start = std::chrono::steady_clock::now();
+
+        for (auto i = 0u; i != focus_changes; ++i)
+            focus_change();
+
+        return (std::chrono::steady_clock::now() - start) / focus_changes;
+    }
+};
+}
+
+TEST_P(WindowManagementPerformance, creating_windows)
+{
+    auto const cost = create_windows();
+
+    std::cout << "Creating a window with " << window_count << " windows: " << cost.count() << "us" << std::endl;
+
+    //NOTE: Ideally, the expected cost should vary according to platform
+    EXPECT_THAT(cost.count(), Lt(1000.0));
+}
+
+TEST_P(WindowManagementPerformance, cycling_focus_within_an_application)
+{
+    create_windows();
+
+    auto const next = cycle_focus([this] { basic_window_manager.focus_next_within_application(); });
+    auto const prev = cycle_focus([this] { basic_window_manager.focus_prev_within_application(); });
+
+    std::cout << "Focusing the next window with " << window_count << " windows: " << next.count() << "us" << std::endl;
+    std::cout << "Focusing the previous window with " << window_count << " windows: " << prev.count() << "us" << std::endl;
+
+    EXPECT_THAT(next.count(), Lt(1000.0));
+    EXPECT_THAT(prev.count(), Lt(1000.0));
+}
+
+INSTANTIATE_TEST_SUITE_P(WindowCounts, WindowManagementPerformance, Values(64u, 256u, 1024u));
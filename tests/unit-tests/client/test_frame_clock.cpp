@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/client/frame_clock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using mir::client::FrameClock;
+using mir::time::PosixTimestamp;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct FrameClockResync : Test
+{
+    std::chrono::nanoseconds now{1005ms};
+    FrameClock clock{[this](clockid_t clock_id) { return PosixTimestamp{clock_id, now}; }};
+
+    void SetUp() override
+    {
+        clock.set_period(10ms);
+    }
+};
+}
+
+TEST_F(FrameClockResync, without_a_callback_frames_are_in_phase_with_the_clock)
+{
+    EXPECT_THAT(clock.next_frame_after({}).nanoseconds, Eq(1010ms));
+}
+
+TEST_F(FrameClockResync, frames_are_in_phase_with_the_server)
+{
+    clock.set_resync_callback([] { return PosixTimestamp{CLOCK_MONOTONIC, 1003ms}; });
+
+    EXPECT_THAT(clock.next_frame_after({}).nanoseconds, Eq(1013ms));
+}
+
+TEST_F(FrameClockResync, a_future_server_frame_is_the_target)
+{
+    clock.set_resync_callback([] { return PosixTimestamp{CLOCK_MONOTONIC, 1007ms}; });
+
+    EXPECT_THAT(clock.next_frame_after({}).nanoseconds, Eq(1007ms));
+}
+
+TEST_F(FrameClockResync, a_default_timestamp_from_the_callback_falls_back_to_the_clock)
+{
+    clock.set_resync_callback([] { return PosixTimestamp{}; });
+
+    EXPECT_THAT(clock.next_frame_after({}).nanoseconds, Eq(1010ms));
+}
+
+TEST_F(FrameClockResync, callback_is_used_only_when_resyncing)
+{
+    int resyncs = 0;
+    clock.set_resync_callback([&] { ++resyncs; return PosixTimestamp{CLOCK_MONOTONIC, 1003ms}; });
+
+    auto const first = clock.next_frame_after({});
+    now = first.nanoseconds;
+    clock.next_frame_after(first);
+
+    EXPECT_THAT(resyncs, Eq(1));
+}
@@ -25,6 +25,7 @@
 #include "mir/geometry/rectangle.h"
 #include "mir/geometry/rectangles.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/scene/observer.h"
 
 #include "mir/test/doubles/null_display.h"
 #include "mir/test/doubles/null_display_buffer_compositor_factory.h"
@@ -48,6 +49,7 @@
 
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
+namespace ms = mir::scene;
 namespace mf = mir::frontend;
 namespace mtd = mir::test::doubles;
 namespace mt = mir::test;
@@ -494,8 +496,13 @@ TEST_F(CompositingScreencastTest, uses_requested_number_of_buffers)
         .WillOnce(Return(mt::fake_shared(buffers[2])))
         .WillOnce(Return(mt::fake_shared(buffers[3])));
 
+    NiceMock<mtd::MockScene> mock_scene;
+    std::shared_ptr<ms::Observer> scene_observer;
+    ON_CALL(mock_scene, add_observer(_))
+        .WillByDefault(SaveArg<0>(&scene_observer));
+
     mc::CompositingScreencast screencast_local{
-        mt::fake_shared(stub_scene),
+        mt::fake_shared(mock_scene),
         mt::fake_shared(stub_display),
         mt::fake_shared(mock_buffer_allocator),
         mt::fake_shared(stub_db_compositor_factory)};
@@ -503,12 +510,73 @@ TEST_F(CompositingScreencastTest, uses_requested_number_of_buffers)
     auto session_id = screencast_local.create_session(
         default_region, default_size, default_pixel_format,
         expected_num_buffers, default_mirror_mode);
+    ASSERT_THAT(scene_observer, NotNull());
 
     for (int i = 0; i < expected_num_buffers; i++)
     {
         auto buffer = screencast_local.capture(session_id);
         ASSERT_EQ(&buffers[i], buffer.get());
+        scene_observer->scene_changed();
     }
 }
 
+TEST_F(CompositingScreencastTest, reuses_last_capture_while_scene_is_unchanged)
+{
+    using namespace testing;
+
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+    EXPECT_CALL(mock_db_compositor_factory, create_compositor_mock(_));
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(1);
+
+    mc::CompositingScreencast screencast_local{
+        mt::fake_shared(stub_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast_local.create_session(
+        default_region, default_size, default_pixel_format,
+        default_num_buffers, default_mirror_mode);
+
+    auto const first = screencast_local.capture(session_id);
+    auto const second = screencast_local.capture(session_id);
+
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(CompositingScreencastTest, recaptures_to_same_buffer_only_after_scene_changes)
+{
+    using namespace testing;
+
+    NiceMock<mtd::MockScene> mock_scene;
+    std::shared_ptr<ms::Observer> scene_observer;
+    ON_CALL(mock_scene, add_observer(_))
+        .WillByDefault(SaveArg<0>(&scene_observer));
+
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+    EXPECT_CALL(mock_db_compositor_factory, create_compositor_mock(_));
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(2);
+
+    mc::CompositingScreencast screencast_local{
+        mt::fake_shared(mock_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast_local.create_session(
+        default_region, default_size, default_pixel_format,
+        0, default_mirror_mode);
+    ASSERT_THAT(scene_observer, NotNull());
+
+    mtd::StubGLBuffer stub_buffer;
+    auto const buffer = mt::fake_shared(stub_buffer);
+    screencast_local.capture(session_id, buffer);
+    screencast_local.capture(session_id, buffer);
+
+    scene_observer->scene_changed();
+    screencast_local.capture(session_id, buffer);
+}
+
 
@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/display_configuration_message_cache.h"
+#include "mir_protobuf_wire.pb.h"
+#include "mir_protobuf.pb.h"
+
+#include "mir/test/doubles/stub_display_configuration.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mfd = mir::frontend::detail;
+namespace mp = mir::protobuf;
+namespace mtd = mir::test::doubles;
+using namespace testing;
+
+namespace
+{
+/// The number of outputs in the configuration a message carries
+auto outputs_in(mfd::DisplayConfigurationMessageCache::Message const& message) -> int
+{
+    mp::wire::Result result;
+    EXPECT_TRUE(result.ParseFromArray(message.data(), message.size()));
+    EXPECT_THAT(result.events_size(), Eq(1));
+
+    mp::EventSequence seq;
+    EXPECT_TRUE(seq.ParseFromString(result.events(0)));
+
+    return seq.display_configuration().display_output_size();
+}
+
+struct DisplayConfigurationMessageCache : Test
+{
+    mfd::DisplayConfigurationMessageCache cache;
+};
+}
+
+TEST_F(DisplayConfigurationMessageCache, serializes_the_configuration)
+{
+    auto const config = std::make_shared<mtd::StubDisplayConfig>(3);
+
+    EXPECT_THAT(outputs_in(*cache.message_for(config)), Eq(3));
+}
+
+TEST_F(DisplayConfigurationMessageCache, shares_the_message_for_the_same_configuration)
+{
+    auto const config = std::make_shared<mtd::StubDisplayConfig>(2);
+
+    auto const first = cache.message_for(config);
+    auto const second = cache.message_for(config);
+
+    EXPECT_THAT(second, Eq(first));
+}
+
+TEST_F(DisplayConfigurationMessageCache, reserializes_a_configuration_modified_in_place)
+{
+    auto const config = std::make_shared<mtd::StubDisplayConfig>(2);
+    auto const before = cache.message_for(config);
+
+    config->outputs.pop_back();
+    auto const after = cache.message_for(config);
+
+    EXPECT_THAT(after, Ne(before));
+    EXPECT_THAT(outputs_in(*after), Eq(1));
+}
+
+TEST_F(DisplayConfigurationMessageCache, reserializes_a_new_configuration)
+{
+    auto const old_config = std::make_shared<mtd::StubDisplayConfig>(2);
+    auto const before = cache.message_for(old_config);
+
+    auto const new_config = std::make_shared<mtd::StubDisplayConfig>(3);
+    auto const after = cache.message_for(new_config);
+
+    EXPECT_THAT(after, Ne(before));
+    EXPECT_THAT(outputs_in(*after), Eq(3));
+}
+
+TEST_F(DisplayConfigurationMessageCache, clients_with_different_configurations_each_get_their_own)
+{
+    // e.g. a client that has been given its own (filtered) view of the outputs
+    auto const full = std::make_shared<mtd::StubDisplayConfig>(3);
+    auto const filtered = std::make_shared<mtd::StubDisplayConfig>(1);
+
+    EXPECT_THAT(outputs_in(*cache.message_for(full)), Eq(3));
+    EXPECT_THAT(outputs_in(*cache.message_for(filtered)), Eq(1));
+    EXPECT_THAT(outputs_in(*cache.message_for(full)), Eq(3));
+}
+
+TEST_F(DisplayConfigurationMessageCache, messages_already_handed_out_are_unchanged)
+{
+    auto const config = std::make_shared<mtd::StubDisplayConfig>(2);
+    auto const before = cache.message_for(config);
+
+    cache.message_for(std::make_shared<mtd::StubDisplayConfig>(3));
+
+    EXPECT_THAT(outputs_in(*before), Eq(2));
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/session_mediator.h"
+#include "src/server/frontend/resource_cache.h"
+#include "src/server/report/null/session_mediator_report.h"
+#include "src/server/shell/frontend_shell.h"
+#include "mir/frontend/connection_context.h"
+#include "mir/graphics/display_configuration_observer.h"
+#include "mir_protobuf.pb.h"
+
+#include "mir/test/doubles/stub_shell.h"
+#include "mir/test/doubles/null_display.h"
+#include "mir/test/doubles/null_display_changer.h"
+#include "mir/test/doubles/null_event_sink_factory.h"
+#include "mir/test/doubles/null_message_sender.h"
+#include "mir/test/doubles/null_screencast.h"
+#include "mir/test/doubles/null_application_not_responding_detector.h"
+#include "mir/test/doubles/mock_platform_ipc_operations.h"
+#include "mir/test/doubles/mock_input_config_changer.h"
+#include "mir/test/doubles/stub_observer_registrar.h"
+#include "mir/test/doubles/explicit_executor.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mp = mir::protobuf;
+namespace msh = mir::shell;
+namespace mtd = mir::test::doubles;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct FrameTimingDisplayChanger : mtd::NullDisplayChanger
+{
+    MOCK_CONST_METHOD1(last_frame_on, mg::Frame(unsigned));
+};
+
+struct SessionMediatorFrameTiming : Test
+{
+    std::shared_ptr<FrameTimingDisplayChanger> const display_changer{
+        std::make_shared<NiceMock<FrameTimingDisplayChanger>>()};
+
+    std::shared_ptr<msh::detail::FrontendShell> const shell{std::make_shared<msh::detail::FrontendShell>(
+        std::make_shared<mtd::StubShell>(),
+        nullptr,
+        std::make_shared<mtd::NullDisplay>(),
+        std::make_shared<mtd::StubObserverRegistrar<mg::DisplayConfigurationObserver>>())};
+
+    mtd::ExplicitExectutor executor;
+
+    mf::SessionMediator mediator{
+        shell,
+        std::make_shared<NiceMock<mtd::MockPlatformIpcOperations>>(),
+        display_changer,
+        {},
+        std::make_shared<mir::report::null::SessionMediatorReport>(),
+        std::make_shared<mtd::NullEventSinkFactory>(),
+        std::make_shared<mtd::NullMessageSender>(),
+        std::make_shared<mf::ResourceCache>(),
+        std::make_shared<mtd::NullScreencast>(),
+        mf::ConnectionContext{nullptr},
+        nullptr,
+        nullptr,
+        std::make_shared<mtd::NullANRDetector>(),
+        nullptr,
+        std::make_shared<NiceMock<mtd::MockInputConfigurationChanger>>(),
+        {},
+        nullptr,
+        executor};
+
+    mp::FrameTimingRequest request;
+    mp::FrameTiming response;
+
+    static void done() {}
+    std::unique_ptr<google::protobuf::Closure> const null_callback{google::protobuf::NewPermanentCallback(&done)};
+
+    void connect()
+    {
+        mp::ConnectParameters parameters;
+        parameters.set_application_name(__PRETTY_FUNCTION__);
+        mp::Connection connection;
+
+        mediator.connect(&parameters, &connection, null_callback.get());
+    }
+};
+}
+
+TEST_F(SessionMediatorFrameTiming, reports_last_frame_on_the_requested_output)
+{
+    mg::Frame frame;
+    frame.msc = 42;
+    frame.ust = mir::time::PosixTimestamp{CLOCK_MONOTONIC, 123456789ns};
+
+    connect();
+    request.set_output_id(3);
+
+    EXPECT_CALL(*display_changer, last_frame_on(3)).WillOnce(Return(frame));
+
+    mediator.frame_timing(&request, &response, null_callback.get());
+
+    EXPECT_THAT(response.msc(), Eq(42));
+    EXPECT_THAT(response.ust(), Eq(123456789));
+    EXPECT_THAT(response.clock_id(), Eq(CLOCK_MONOTONIC));
+}
+
+TEST_F(SessionMediatorFrameTiming, is_refused_without_a_session)
+{
+    request.set_output_id(3);
+
+    EXPECT_CALL(*display_changer, last_frame_on(_)).Times(0);
+
+    EXPECT_THROW(
+        mediator.frame_timing(&request, &response, null_callback.get()),
+        std::logic_error);
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/frontend/submission_ring.h"
+#include "src/server/frontend/submission_ring_consumer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/mman.h>
+
+namespace mf = mir::frontend;
+namespace mfd = mir::frontend::detail;
+using namespace testing;
+
+namespace
+{
+struct SubmissionRing : Test
+{
+    std::vector<char> storage = std::vector<char>(mf::SubmissionRing::mapping_size() + 64);
+    void* const mapping = reinterpret_cast<void*>(
+        (reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t{63});
+
+    mf::SubmissionRing consumer{mapping, true};
+    mf::SubmissionRing producer{mapping, false};
+
+    static mf::SubmissionRingEntry submission(int buffer_id)
+    {
+        return {mf::SubmissionRingOperation::submit_buffer, 1, buffer_id, 0};
+    }
+};
+}
+
+TEST_F(SubmissionRing, delivers_entries_in_order)
+{
+    for (auto i = 0; i != 10; ++i)
+        EXPECT_TRUE(producer.push(submission(i)));
+
+    std::vector<int> received;
+    consumer.drain([&](mf::SubmissionRingEntry const& entry) { received.push_back(entry.buffer_id); });
+
+    EXPECT_THAT(received, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+}
+
+TEST_F(SubmissionRing, push_fails_when_full)
+{
+    for (auto i = 0u; i != mf::SubmissionRing::capacity; ++i)
+        EXPECT_TRUE(producer.push(submission(i)));
+
+    EXPECT_FALSE(producer.push(submission(-1)));
+
+    consumer.drain([](mf::SubmissionRingEntry const&) {});
+
+    EXPECT_TRUE(producer.push(submission(-1)));
+}
+
+TEST_F(SubmissionRing, producer_wakes_consumer_only_when_waiting)
+{
+    producer.push(submission(0));
+    EXPECT_TRUE(producer.consumer_needs_wakeup());
+
+    producer.push(submission(1));
+    EXPECT_FALSE(producer.consumer_needs_wakeup());
+
+    consumer.drain([](mf::SubmissionRingEntry const&) {});
+    EXPECT_TRUE(consumer.prepare_to_wait());
+
+    producer.push(submission(2));
+    EXPECT_TRUE(producer.consumer_needs_wakeup());
+}
+
+TEST_F(SubmissionRing, consumer_does_not_wait_with_entries_pending)
+{
+    consumer.drain([](mf::SubmissionRingEntry const&) {});
+    producer.push(submission(0));
+
+    EXPECT_FALSE(consumer.prepare_to_wait());
+}
+
+TEST_F(SubmissionRing, nothing_is_lost_between_threads)
+{
+    int const count = 100000;
+
+    std::thread producer_thread{
+        [this]
+        {
+            for (auto i = 0; i != count;)
+            {
+                if (producer.push(submission(i)))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        }};
+
+    int expected = 0;
+    bool in_order = true;
+    while (expected != count)
+    {
+        consumer.drain(
+            [&](mf::SubmissionRingEntry const& entry)
+            {
+                in_order = in_order && (entry.buffer_id == expected);
+                ++expected;
+            });
+    }
+
+    producer_thread.join();
+
+    EXPECT_TRUE(in_order);
+}
+
+namespace
+{
+/// A client that can write whatever it likes to the shared memory
+struct SubmissionRingConsumer : Test
+{
+    void SetUp() override
+    {
+        ASSERT_THAT(mapping, Ne(MAP_FAILED));
+    }
+
+    ~SubmissionRingConsumer()
+    {
+        munmap(mapping, mf::SubmissionRing::mapping_size());
+    }
+
+    auto drain(uint32_t max_entries = mf::SubmissionRing::capacity) -> std::vector<int>
+    {
+        std::vector<int> received;
+        consumer.drain(
+            [&](mf::SubmissionRingEntry const& entry) { received.push_back(entry.buffer_id); },
+            max_entries);
+        return received;
+    }
+
+    auto wakeup_pending() -> bool
+    {
+        pollfd fd{consumer.wakeup_fd(), POLLIN, 0};
+        return poll(&fd, 1, 0) == 1;
+    }
+
+    static mf::SubmissionRingEntry submission(int buffer_id)
+    {
+        return {mf::SubmissionRingOperation::submit_buffer, 1, buffer_id, 0};
+    }
+
+    mfd::SubmissionRingConsumer consumer{[]{}};
+    void* const mapping{mmap(
+        nullptr, mf::SubmissionRing::mapping_size(), PROT_READ | PROT_WRITE, MAP_SHARED, consumer.ring_fd(), 0)};
+    mf::SubmissionRing::Layout* const layout{static_cast<mf::SubmissionRing::Layout*>(mapping)};
+    mf::SubmissionRing producer{mapping, false};
+};
+}
+
+TEST_F(SubmissionRingConsumer, delivers_entries_in_order)
+{
+    for (auto i = 0; i != 3; ++i)
+        producer.push(submission(i));
+
+    EXPECT_THAT(drain(), ElementsAre(0, 1, 2));
+    EXPECT_THAT(drain(), IsEmpty());
+}
+
+TEST_F(SubmissionRingConsumer, ignores_head_written_by_client)
+{
+    for (auto i = 0; i != 3; ++i)
+        producer.push(submission(i));
+
+    layout->head.store(12345);
+    EXPECT_THAT(drain(), ElementsAre(0, 1, 2));
+
+    layout->head.store(0);
+    EXPECT_THAT(drain(), IsEmpty());
+}
+
+TEST_F(SubmissionRingConsumer, skips_entries_from_a_client_that_overflows_the_ring)
+{
+    layout->tail.store(mf::SubmissionRing::capacity + 1);
+    EXPECT_THAT(drain(), IsEmpty());
+
+    // After which, a client that plays by the rules is served again
+    producer.push(submission(7));
+    EXPECT_THAT(drain(), ElementsAre(7));
+}
+
+TEST_F(SubmissionRingConsumer, handles_a_limited_number_of_entries_and_signals_itself_for_the_rest)
+{
+    for (auto i = 0; i != 10; ++i)
+        producer.push(submission(i));
+
+    EXPECT_THAT(drain(4), ElementsAre(0, 1, 2, 3));
+    EXPECT_TRUE(wakeup_pending());
+
+    consumer.process();
+    EXPECT_THAT(drain(), ElementsAre(4, 5, 6, 7, 8, 9));
+    EXPECT_FALSE(wakeup_pending());
+}
+
+TEST_F(SubmissionRingConsumer, a_client_that_keeps_moving_tail_does_not_hold_up_the_consumer)
+{
+    std::atomic<bool> done{false};
+    std::thread hostile_client{
+        [&]
+        {
+            for (uint32_t tail = 0; !done; ++tail)
+                layout->tail.store(tail % (2 * mf::SubmissionRing::capacity));
+        }};
+
+    for (auto i = 0; i != 100; ++i)
+        EXPECT_THAT(drain(mfd::SubmissionRingConsumer::max_entries_per_wakeup).size(),
+            Le(mfd::SubmissionRingConsumer::max_entries_per_wakeup));
+
+    done = true;
+    hostile_client.join();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_xwayland/xwayland_idle_timer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <poll.h>
+
+namespace mf = mir::frontend;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+auto const timeout = 10ms;
+
+auto expires_within(mf::XWaylandIdleTimer const& timer, std::chrono::milliseconds limit) -> bool
+{
+    pollfd readable{timer.fd(), POLLIN, 0};
+    return poll(&readable, 1, limit.count()) > 0;
+}
+
+struct XWaylandIdleTimer : Test
+{
+    mf::XWaylandIdleTimer timer{timeout};
+    size_t clients{0};
+    std::function<size_t()> const count_clients{[this] { return clients; }};
+};
+}
+
+TEST_F(XWaylandIdleTimer, does_not_run_until_idle)
+{
+    EXPECT_FALSE(expires_within(timer, 10 * timeout));
+}
+
+TEST_F(XWaylandIdleTimer, stops_xwayland_when_idle_without_clients)
+{
+    timer.set_idle(true);
+
+    ASSERT_TRUE(expires_within(timer, 100 * timeout));
+    EXPECT_TRUE(timer.expired(count_clients));
+}
+
+TEST_F(XWaylandIdleTimer, is_cancelled_when_no_longer_idle)
+{
+    timer.set_idle(true);
+    timer.set_idle(false);
+
+    EXPECT_FALSE(expires_within(timer, 10 * timeout));
+}
+
+TEST_F(XWaylandIdleTimer, does_not_stop_xwayland_that_became_busy_after_expiry)
+{
+    timer.set_idle(true);
+    ASSERT_TRUE(expires_within(timer, 100 * timeout));
+
+    timer.set_idle(false);
+
+    EXPECT_FALSE(timer.expired(count_clients));
+}
+
+TEST_F(XWaylandIdleTimer, connected_clients_without_windows_keep_xwayland_running)
+{
+    clients = 1;
+    timer.set_idle(true);
+
+    ASSERT_TRUE(expires_within(timer, 100 * timeout));
+    EXPECT_FALSE(timer.expired(count_clients));
+    EXPECT_TRUE(timer.is_idle());
+
+    clients = 0;
+
+    ASSERT_TRUE(expires_within(timer, 100 * timeout));
+    EXPECT_TRUE(timer.expired(count_clients));
+}
+
+TEST_F(XWaylandIdleTimer, does_not_count_clients_while_not_idle)
+{
+    timer.set_idle(true);
+    ASSERT_TRUE(expires_within(timer, 100 * timeout));
+    timer.set_idle(false);
+
+    bool counted = false;
+    timer.expired([&] { counted = true; return size_t{0}; });
+
+    EXPECT_FALSE(counted);
+}
+
+TEST(XWaylandIdleTimerDisabled, never_expires)
+{
+    mf::XWaylandIdleTimer timer{0ms};
+
+    timer.set_idle(true);
+
+    EXPECT_FALSE(expires_within(timer, 10 * timeout));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_xwayland/xwayland_property_notify_batch.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace mf = mir::frontend;
+using namespace testing;
+
+namespace
+{
+xcb_window_t const window_a{11};
+xcb_window_t const window_b{12};
+xcb_atom_t const name{1};
+xcb_atom_t const title{2};
+
+struct XWaylandPropertyNotifyBatch : Test
+{
+    void handle()
+    {
+        batch.handle(
+            [this](xcb_window_t window, xcb_atom_t property) -> std::experimental::optional<std::function<void()>>
+            {
+                auto const what = std::to_string(window) + "." + std::to_string(property);
+                log.push_back("request " + what);
+                if (property == ignored_property)
+                    return std::experimental::nullopt;
+                if (what == failing_request)
+                    throw std::runtime_error{"request failed"};
+                return std::function<void()>{[this, what]()
+                    {
+                        log.push_back("reply " + what);
+                        if (what == failing_reply)
+                            throw std::runtime_error{"reply failed"};
+                    }};
+            },
+            [this](xcb_window_t window)
+            {
+                log.push_back("apply " + std::to_string(window));
+                if (window == failing_apply)
+                    throw std::runtime_error{"apply failed"};
+            });
+    }
+
+    mf::XWaylandPropertyNotifyBatch batch;
+    std::vector<std::string> log;
+
+    xcb_atom_t ignored_property{0};
+    std::string failing_request;
+    std::string failing_reply;
+    xcb_window_t failing_apply{0};
+};
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, sends_every_request_before_waiting_for_replies)
+{
+    batch.add(window_a, name);
+    batch.add(window_b, name);
+    batch.add(window_a, title);
+
+    handle();
+
+    EXPECT_THAT(log, ElementsAre(
+        "request 11.1", "request 12.1", "request 11.2",
+        "reply 11.1", "reply 12.1", "reply 11.2",
+        "apply 11", "apply 12"));
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, reads_a_repeatedly_changed_property_once)
+{
+    batch.add(window_a, name);
+    batch.add(window_a, name);
+    batch.add(window_a, name);
+
+    handle();
+
+    EXPECT_THAT(log, ElementsAre("request 11.1", "reply 11.1", "apply 11"));
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, does_not_apply_windows_without_interesting_changes)
+{
+    ignored_property = title;
+    batch.add(window_a, name);
+    batch.add(window_b, title);
+
+    handle();
+
+    EXPECT_THAT(log, ElementsAre("request 11.1", "request 12.2", "reply 11.1", "apply 11"));
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, is_empty_once_handled)
+{
+    EXPECT_TRUE(batch.empty());
+    batch.add(window_a, name);
+    EXPECT_FALSE(batch.empty());
+
+    handle();
+
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, collects_remaining_replies_when_handling_one_fails)
+{
+    failing_reply = "11.1";
+    batch.add(window_a, name);
+    batch.add(window_b, name);
+    batch.add(window_a, title);
+
+    EXPECT_NO_THROW(handle());
+
+    EXPECT_THAT(log, ElementsAre(
+        "request 11.1", "request 12.1", "request 11.2",
+        "reply 11.1", "reply 12.1", "reply 11.2",
+        "apply 11", "apply 12"));
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, handles_remaining_properties_when_a_request_fails)
+{
+    failing_request = "11.1";
+    batch.add(window_a, name);
+    batch.add(window_b, name);
+
+    EXPECT_NO_THROW(handle());
+
+    EXPECT_THAT(log, ElementsAre("request 11.1", "request 12.1", "reply 12.1", "apply 12"));
+}
+
+TEST_F(XWaylandPropertyNotifyBatch, applies_remaining_windows_when_one_fails)
+{
+    failing_apply = window_a;
+    batch.add(window_a, name);
+    batch.add(window_b, name);
+
+    EXPECT_NO_THROW(handle());
+
+    EXPECT_THAT(log, ElementsAre("request 11.1", "request 12.1", "reply 11.1", "reply 12.1", "apply 11", "apply 12"));
+}
@@ -23,6 +23,7 @@
 #include "mir/test/doubles/stub_buffer_allocator.h"
 #include "mir/test/doubles/stub_input_scene.h"
 #include "mir/test/doubles/explicit_executor.h"
+#include "mir/test/doubles/fake_alarm_factory.h"
 
 #include "mir/test/fake_shared.h"
 
@@ -47,6 +48,7 @@ struct MockInputScene : mtd::StubInputScene
                  void(std::weak_ptr<mg::Renderable> const&));
 
     MOCK_METHOD0(emit_scene_changed, void());
+    MOCK_METHOD1(emit_scene_damaged, void(geom::Rectangle const&));
 };
 
 struct StubCursorImage : mg::CursorImage
@@ -98,6 +100,48 @@ private:
     std::vector<unsigned char> pixels;
 };
 
+struct StubAnimatedCursorImage : mg::AnimatedCursorImage
+{
+    StubAnimatedCursorImage()
+    {
+        frames[0].fill_with(0xff, 0, 0, 0xff);
+        frames[1].fill_with(0, 0xff, 0, 0xff);
+    }
+
+    void const* as_argb_8888() const override
+    {
+        return frames[0].as_argb_8888();
+    }
+
+    geom::Size size() const override
+    {
+        return frames[0].size();
+    }
+
+    geom::Displacement hotspot() const override
+    {
+        return frames[0].hotspot();
+    }
+
+    size_t frame_count() const override
+    {
+        return 2;
+    }
+
+    mg::CursorImage const& frame(size_t index) const override
+    {
+        return frames[index];
+    }
+
+    std::chrono::milliseconds frame_duration(size_t) const override
+    {
+        return frame_period;
+    }
+
+    std::chrono::milliseconds const frame_period{50};
+    StubCursorImage frames[2]{{{1,2}}, {{2,1}}};
+};
+
 class MockBufferAllocator : public mtd::StubBufferAllocator
 {
 public:
@@ -135,10 +179,12 @@ struct SoftwareCursor : testing::Test
     testing::NiceMock<MockBufferAllocator> mock_buffer_allocator;
     testing::NiceMock<MockInputScene> mock_input_scene;
     ExplicitExectutor executor;
+    mtd::FakeAlarmFactory alarm_factory;
 
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_buffer_allocator),
         mt::fake_shared(executor),
+        mt::fake_shared(alarm_factory),
         mt::fake_shared(mock_input_scene)};
 };
 
@@ -286,15 +332,23 @@ TEST_F(SoftwareCursor, moves_scene_renderable_offset_by_hotspot_when_moved)
                 Eq(new_position - stub_cursor_image.hotspot()));
 }
 
-TEST_F(SoftwareCursor, notifies_scene_when_moving)
+TEST_F(SoftwareCursor, notifies_scene_of_damage_when_moving)
 {
     using namespace testing;
 
-    EXPECT_CALL(mock_input_scene, emit_scene_changed());
-
     cursor.show(stub_cursor_image);
     executor.execute();
-    cursor.move_to({22,23});
+
+    geom::Point const new_position{22,23};
+    auto const old_top_left = geom::Point{0,0} - stub_cursor_image.hotspot();
+    auto const new_top_left = new_position - stub_cursor_image.hotspot();
+
+    EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(AllOf(
+        Field(&geom::Rectangle::top_left, Eq(old_top_left)),
+        Property(&geom::Rectangle::bottom_right, Eq(new_top_left + as_displacement(stub_cursor_image.size()))))));
+
+    cursor.move_to(new_position);
 }
 
 TEST_F(SoftwareCursor, creates_renderable_with_filled_buffer)
@@ -326,6 +380,7 @@ TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
 
     EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
     EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
 
     // Already hidden, nothing should happen
     cursor.hide();
@@ -334,63 +389,179 @@ TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
     cursor.move_to({3,4});
 }
 
-TEST_F(SoftwareCursor, creates_new_renderable_for_new_cursor_image)
+TEST_F(SoftwareCursor, updates_renderable_in_scene_for_new_cursor_image)
 {
     using namespace testing;
 
-    std::shared_ptr<mg::Renderable> first_cursor_renderable;
+    std::shared_ptr<mg::Renderable> cursor_renderable;
 
     EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
-        WillOnce(SaveArg<0>(&first_cursor_renderable));
+        WillOnce(SaveArg<0>(&cursor_renderable));
 
     cursor.show(stub_cursor_image);
     executor.execute();
 
     Mock::VerifyAndClearExpectations(&mock_input_scene);
 
-    EXPECT_CALL(mock_input_scene,
-                remove_input_visualization(WeakPtrEq(first_cursor_renderable)));
-    EXPECT_CALL(mock_input_scene, add_input_visualization(Ne(first_cursor_renderable)));
+    EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_));
 
+    another_stub_cursor_image.fill_with(0x12, 0x34, 0x56, 0x78);
     cursor.show(another_stub_cursor_image);
     executor.execute();
 
     Mock::VerifyAndClearExpectations(&mock_input_scene);
+
+    auto const buffer = static_cast<mtd::StubBuffer*>(cursor_renderable->buffer().get());
+    auto const image_data = static_cast<unsigned char const*>(another_stub_cursor_image.as_argb_8888());
+    EXPECT_THAT(buffer->written_pixels, ElementsAreArray(image_data, buffer->written_pixels.size()));
 }
 
-TEST_F(SoftwareCursor, places_new_cursor_renderable_at_correct_position)
+TEST_F(SoftwareCursor, places_new_cursor_image_at_correct_position)
 {
     using namespace testing;
 
     auto const cursor_position = geom::Point{3, 4};
 
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
     cursor.show(stub_cursor_image);
     executor.execute();
     cursor.move_to(cursor_position);
+    cursor.show(another_stub_cursor_image);
     executor.execute();
 
-    Mock::VerifyAndClearExpectations(&mock_input_scene);
-
-    auto const renderable_position =
-        cursor_position - another_stub_cursor_image.hotspot();
-    EXPECT_CALL(mock_input_scene,
-                add_input_visualization(RenderableWithPosition(renderable_position)));
-
-    cursor.show(another_stub_cursor_image);
+    EXPECT_THAT(cursor_renderable->screen_position().top_left,
+                Eq(cursor_position - another_stub_cursor_image.hotspot()));
 }
 
 //lp: #1413211
-TEST_F(SoftwareCursor, new_buffer_on_each_show)
+TEST_F(SoftwareCursor, does_not_overwrite_the_displayed_buffer)
 {
     EXPECT_CALL(mock_buffer_allocator, alloc_software_buffer(testing::_, testing::_))
-        .Times(3);
-    mg::SoftwareCursor cursor{
-        mt::fake_shared(mock_buffer_allocator),
-        mt::fake_shared(executor),
-        mt::fake_shared(mock_input_scene)};
+        .Times(2);
+
     cursor.show(another_stub_cursor_image);
     cursor.show(another_stub_cursor_image);
     cursor.show(stub_cursor_image);
+    executor.execute();
+}
+
+TEST_F(SoftwareCursor, does_not_overwrite_a_buffer_still_being_composited)
+{
+    using namespace testing;
+
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
+    cursor.show(stub_cursor_image);
+    executor.execute();
+
+    auto const buffer_being_composited = cursor_renderable->buffer();
+    auto const pixels_being_composited =
+        static_cast<mtd::StubBuffer*>(buffer_being_composited.get())->written_pixels;
+
+    another_stub_cursor_image.fill_with(1, 2, 3, 4);
+    cursor.show(another_stub_cursor_image);
+    stub_cursor_image.fill_with(5, 6, 7, 8);
+    cursor.show(stub_cursor_image);
+    executor.execute();
+
+    EXPECT_THAT(cursor_renderable->buffer(), Ne(buffer_being_composited));
+    EXPECT_THAT(
+        static_cast<mtd::StubBuffer*>(buffer_being_composited.get())->written_pixels,
+        Eq(pixels_being_composited));
+}
+
+TEST_F(SoftwareCursor, allocates_new_buffers_when_image_size_changes)
+{
+    struct BigCursorImage : StubCursorImage
+    {
+        BigCursorImage() : StubCursorImage{{0,0}}, pixels(128*128*4) {}
+        void const* as_argb_8888() const override { return pixels.data(); }
+        geom::Size size() const override { return {128, 128}; }
+        std::vector<unsigned char> pixels;
+    } big_cursor_image;
+
+    EXPECT_CALL(mock_buffer_allocator, alloc_software_buffer(geom::Size{64, 64}, testing::_))
+        .Times(2);
+    EXPECT_CALL(mock_buffer_allocator, alloc_software_buffer(geom::Size{128, 128}, testing::_))
+        .Times(1);
+
+    cursor.show(stub_cursor_image);
+    cursor.show(big_cursor_image);
+    cursor.show(stub_cursor_image);
+    executor.execute();
+}
+
+TEST_F(SoftwareCursor, steps_through_animated_cursor_frames)
+{
+    using namespace testing;
+
+    StubAnimatedCursorImage animated_image;
+
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
+    cursor.show(animated_image);
+    executor.execute();
+
+    auto const pixels_of = [](mg::CursorImage const& image)
+        {
+            auto const data = static_cast<unsigned char const*>(image.as_argb_8888());
+            return std::vector<unsigned char>(
+                data, data + 4 * image.size().width.as_uint32_t() * image.size().height.as_uint32_t());
+        };
+    auto const displayed_pixels = [&]
+        {
+            return static_cast<mtd::StubBuffer*>(cursor_renderable->buffer().get())->written_pixels;
+        };
+
+    EXPECT_THAT(displayed_pixels(), Eq(pixels_of(animated_image.frames[0])));
+
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_));
+    alarm_factory.advance_by(animated_image.frame_period + std::chrono::milliseconds{1});
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&mock_input_scene);
+
+    EXPECT_THAT(displayed_pixels(), Eq(pixels_of(animated_image.frames[1])));
+    EXPECT_THAT(cursor_renderable->screen_position().top_left,
+                Eq(geom::Point{0,0} - animated_image.frames[1].hotspot()));
+
+    alarm_factory.advance_by(animated_image.frame_period + std::chrono::milliseconds{1});
+    executor.execute();
+
+    EXPECT_THAT(displayed_pixels(), Eq(pixels_of(animated_image.frames[0])));
+}
+
+TEST_F(SoftwareCursor, stops_animating_when_hidden_or_replaced)
+{
+    using namespace testing;
+
+    StubAnimatedCursorImage animated_image;
+
+    cursor.show(animated_image);
+    executor.execute();
+    cursor.hide();
+    executor.execute();
+
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
+    alarm_factory.advance_by(animated_image.frame_period * 3);
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&mock_input_scene);
+
+    cursor.show(animated_image);
+    cursor.show(stub_cursor_image);
+    executor.execute();
+
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
+    alarm_factory.advance_by(animated_image.frame_period * 3);
+    executor.execute();
 }
 
 //lp: 1483779
@@ -445,6 +616,7 @@ TEST_F(SoftwareCursor, handles_argb_8888_cursor_surface)
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_buffer_allocator),
         mt::fake_shared(executor),
+        mt::fake_shared(alarm_factory),
         mt::fake_shared(mock_input_scene)
     };
     cursor.show(test_image);
@@ -510,6 +682,7 @@ TEST_F(SoftwareCursor, handles_argb_8888_buffer_with_stride)
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_buffer_allocator),
         mt::fake_shared(executor),
+        mt::fake_shared(alarm_factory),
         mt::fake_shared(mock_input_scene)
     };
     cursor.show(test_image);
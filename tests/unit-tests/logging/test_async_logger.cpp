@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ml = mir::logging;
+using namespace testing;
+
+namespace
+{
+class Recorder : public ml::Logger
+{
+public:
+    void log(ml::Severity, std::string const& message, std::string const& component) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        messages.push_back(component + ": " + message);
+    }
+
+    auto logged() -> std::vector<std::string>
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return messages;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::string> messages;
+};
+
+struct AsyncLogger : Test
+{
+    std::shared_ptr<Recorder> const recorder{std::make_shared<Recorder>()};
+};
+}
+
+TEST_F(AsyncLogger, messages_are_written_in_order)
+{
+    ml::AsyncLogger logger{recorder};
+
+    logger.log(ml::Severity::informational, "first", "test");
+    logger.log("test", ml::Severity::informational, "%s", "second");
+    logger.flush();
+
+    EXPECT_THAT(recorder->logged(), ElementsAre("test: first", "test: second"));
+}
+
+TEST_F(AsyncLogger, waiting_messages_are_written_on_destruction)
+{
+    {
+        ml::AsyncLogger logger{recorder};
+
+        for (auto i = 0; i != 100; ++i)
+            logger.log("test", ml::Severity::informational, "%d", i);
+    }
+
+    EXPECT_THAT(recorder->logged().size(), Eq(100u));
+    EXPECT_THAT(recorder->logged().back(), Eq("test: 99"));
+}
+
+TEST_F(AsyncLogger, critical_messages_are_written_before_log_returns)
+{
+    ml::AsyncLogger logger{recorder};
+
+    logger.log(ml::Severity::informational, "before", "test");
+    logger.log(ml::Severity::critical, "oops", "test");
+
+    EXPECT_THAT(recorder->logged(), ElementsAre("test: before", "test: oops"));
+}
+
+TEST_F(AsyncLogger, messages_logged_while_queue_is_full_are_dropped_and_counted)
+{
+    std::mutex block;
+    std::unique_lock<std::mutex> blocking{block};
+
+    struct BlockingRecorder : ml::Logger
+    {
+        explicit BlockingRecorder(std::mutex& block) : block{block} {}
+
+        void log(ml::Severity, std::string const& message, std::string const&) override
+        {
+            std::lock_guard<std::mutex> lock{block};
+            messages.push_back(message);
+        }
+
+        std::mutex& block;
+        std::vector<std::string> messages;
+    };
+
+    auto const sink = std::make_shared<BlockingRecorder>(block);
+
+    {
+        ml::AsyncLogger logger{sink, 4};
+
+        // The writer takes the first message and blocks writing it, so four more fit in the queue
+        for (auto i = 0; i != 10; ++i)
+            logger.log("test", ml::Severity::informational, "%d", i);
+
+        blocking.unlock();
+    }
+
+    ASSERT_THAT(sink->messages.size(), Ge(5u));
+    EXPECT_THAT(sink->messages.back(), HasSubstr("dropped"));
+    EXPECT_THAT(sink->messages.size(), Lt(11u));
+}
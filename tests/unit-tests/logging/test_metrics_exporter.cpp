@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/metrics/exporter.h"
+#include "src/server/report/metrics/registry.h"
+
+#include "mir/fd.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mrm = mir::report::metrics;
+using namespace testing;
+
+namespace
+{
+struct MetricsExporter : Test
+{
+    MetricsExporter()
+    {
+        char temp_dir[] = "/tmp/mir-metrics-XXXXXX";
+        if (!mkdtemp(temp_dir))
+            throw std::runtime_error{"Failed to create temporary directory"};
+        dir = temp_dir;
+        socket_path = dir + "/metrics";
+    }
+
+    ~MetricsExporter()
+    {
+        unlink(socket_path.c_str());
+        rmdir(dir.c_str());
+    }
+
+    auto address() const -> sockaddr_un
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socket_path.c_str(), sizeof address.sun_path - 1);
+        return address;
+    }
+
+    /// A socket bound to socket_path, listening if \a listening
+    auto bound_socket(bool listening) const -> mir::Fd
+    {
+        mir::Fd fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        auto const addr = address();
+        if (bind(fd, reinterpret_cast<sockaddr const*>(&addr), sizeof addr) < 0 ||
+            (listening && listen(fd, 1) < 0))
+        {
+            throw std::runtime_error{"Failed to set up socket"};
+        }
+        return fd;
+    }
+
+    auto read_metrics() const -> std::string
+    {
+        mir::Fd const fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        auto const addr = address();
+        if (connect(fd, reinterpret_cast<sockaddr const*>(&addr), sizeof addr) < 0)
+            return {};
+
+        std::string result;
+        char buffer[256];
+        for (ssize_t count; (count = read(fd, buffer, sizeof buffer)) > 0;)
+            result.append(buffer, count);
+        return result;
+    }
+
+    auto is_socket() const -> bool
+    {
+        struct stat info;
+        return lstat(socket_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode);
+    }
+
+    std::shared_ptr<mrm::Registry> const registry{std::make_shared<mrm::Registry>()};
+    std::string dir;
+    std::string socket_path;
+};
+}
+
+TEST_F(MetricsExporter, writes_the_registry_to_each_connection)
+{
+    registry->counter("mir_test", "A test counter")->add(3);
+    mrm::Exporter const exporter{registry, socket_path};
+
+    EXPECT_THAT(read_metrics(), HasSubstr("mir_test_total 3"));
+    EXPECT_THAT(read_metrics(), HasSubstr("mir_test_total 3"));
+}
+
+TEST_F(MetricsExporter, replaces_a_stale_socket)
+{
+    bound_socket(false);
+    ASSERT_TRUE(is_socket());
+
+    mrm::Exporter const exporter{registry, socket_path};
+
+    EXPECT_THAT(read_metrics(), HasSubstr("# EOF"));
+}
+
+TEST_F(MetricsExporter, does_not_replace_a_socket_in_use)
+{
+    auto const in_use = bound_socket(true);
+
+    EXPECT_THROW((mrm::Exporter{registry, socket_path}), std::runtime_error);
+    EXPECT_TRUE(is_socket());
+}
+
+TEST_F(MetricsExporter, does_not_replace_other_files)
+{
+    std::ofstream{socket_path} << "precious";
+
+    EXPECT_THROW((mrm::Exporter{registry, socket_path}), std::runtime_error);
+
+    std::string contents;
+    std::getline(std::ifstream{socket_path}, contents);
+    EXPECT_THAT(contents, Eq("precious"));
+}
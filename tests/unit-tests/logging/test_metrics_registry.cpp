@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/metrics/registry.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+namespace mrm = mir::report::metrics;
+using namespace testing;
+
+namespace
+{
+struct MetricsRegistry : Test
+{
+    mrm::Registry registry;
+
+    auto text() const -> std::string
+    {
+        std::stringstream out;
+        registry.write_to(out);
+        return out.str();
+    }
+};
+}
+
+TEST_F(MetricsRegistry, writes_counters_and_gauges_with_labels)
+{
+    registry.counter("frames", "Frames composited", {{"output", "1920x1080+0+0"}})->add(3);
+    registry.gauge("clients", "Clients connected")->set(2);
+
+    EXPECT_THAT(text(), HasSubstr("# TYPE frames counter\n"));
+    EXPECT_THAT(text(), HasSubstr("frames_total{output=\"1920x1080+0+0\"} 3\n"));
+    EXPECT_THAT(text(), HasSubstr("# TYPE clients gauge\n"));
+    EXPECT_THAT(text(), HasSubstr("clients 2\n"));
+    EXPECT_THAT(text(), EndsWith("# EOF\n"));
+}
+
+TEST_F(MetricsRegistry, returns_existing_metric_with_same_name_and_labels)
+{
+    auto const a = registry.counter("requests", "Requests", {{"client", "a"}});
+    auto const b = registry.counter("requests", "Requests", {{"client", "b"}});
+
+    EXPECT_THAT(registry.counter("requests", "Requests", {{"client", "a"}}), Eq(a));
+    EXPECT_THAT(b, Ne(a));
+}
+
+TEST_F(MetricsRegistry, rejects_metric_with_same_name_and_different_type)
+{
+    registry.counter("requests", "Requests");
+
+    EXPECT_THROW(registry.gauge("requests", "Requests"), std::logic_error);
+}
+
+TEST_F(MetricsRegistry, escapes_label_values)
+{
+    registry.counter("requests", "Requests", {{"client", "say \"hi\"\\"}})->add();
+
+    EXPECT_THAT(text(), HasSubstr("requests_total{client=\"say \\\"hi\\\"\\\\\"} 1\n"));
+}
+
+TEST_F(MetricsRegistry, histogram_buckets_are_cumulative)
+{
+    auto const histogram = registry.histogram("size", "Sizes", 2, 4, 1);
+
+    histogram->record(1);
+    histogram->record(4);
+    histogram->record(5);
+    histogram->record(7);
+    histogram->record(100);
+
+    EXPECT_THAT(text(), HasSubstr(
+        "size_bucket{le=\"4\"} 2\n"
+        "size_bucket{le=\"8\"} 4\n"
+        "size_bucket{le=\"16\"} 4\n"
+        "size_bucket{le=\"+Inf\"} 5\n"
+        "size_count 5\n"
+        "size_sum 117\n"));
+}
+
+TEST(MetricsHistogram, buckets_are_within_a_quarter_of_the_value)
+{
+    for (uint64_t value = 1; value < (uint64_t{1} << 40); value = value*3 + 1)
+    {
+        auto const bucket = mrm::Histogram::bucket_for(value);
+        auto const lower = mrm::Histogram::lower_bound_of(bucket);
+
+        EXPECT_THAT(lower, Le(value));
+        EXPECT_THAT(mrm::Histogram::lower_bound_of(bucket + 1), Gt(value));
+        EXPECT_THAT(value - lower, Le(value/4));
+    }
+}
+
+TEST_F(MetricsRegistry, removed_metrics_are_not_written)
+{
+    auto const a = registry.counter("requests", "Requests", {{"client", "a"}});
+    registry.counter("requests", "Requests", {{"client", "b"}})->add();
+
+    registry.remove("requests", {{"client", "a"}});
+    a->add();
+
+    EXPECT_THAT(text(), Not(HasSubstr("client=\"a\"")));
+    EXPECT_THAT(text(), HasSubstr("requests_total{client=\"b\"} 1\n"));
+
+    registry.remove("requests", {{"client", "b"}});
+
+    EXPECT_THAT(text(), Not(HasSubstr("requests")));
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/metrics/compositor_report.h"
+#include "src/server/report/metrics/message_processor_report.h"
+#include "src/server/report/metrics/session_mediator_report.h"
+#include "src/server/report/metrics/registry.h"
+#include "mir/test/doubles/advanceable_clock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace mrm = mir::report::metrics;
+namespace mtd = mir::test::doubles;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct MetricsReport : Test
+{
+    std::shared_ptr<mrm::Registry> const registry{std::make_shared<mrm::Registry>()};
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+
+    auto text() const -> std::string
+    {
+        std::stringstream out;
+        registry->write_to(out);
+        return out.str();
+    }
+};
+
+int const ring_invocation_id{-1};
+}
+
+TEST_F(MetricsReport, counts_frames_of_each_output)
+{
+    mrm::CompositorReport report{registry, clock};
+    int first, second;
+
+    report.added_display(1920, 1080, 0, 0, &first);
+    report.added_display(1280, 1024, 1920, 0, &second);
+
+    for (auto i = 0; i != 3; ++i)
+    {
+        report.began_frame(&first);
+        report.rendered_frame(&first);
+        report.finished_frame(&first);
+    }
+
+    report.began_frame(&second);
+    report.finished_frame(&second);
+
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_frames_total{output=\"1920x1080+0+0\"} 3\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_frames_total{output=\"1280x1024+1920+0\"} 1\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_bypassed_frames_total{output=\"1920x1080+0+0\"} 0\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_bypassed_frames_total{output=\"1280x1024+1920+0\"} 1\n"));
+}
+
+TEST_F(MetricsReport, counts_frames_of_outputs_added_after_compositor_restarts)
+{
+    mrm::CompositorReport report{registry, clock};
+    int before, after;
+
+    report.added_display(1920, 1080, 0, 0, &before);
+    report.began_frame(&before);
+    report.finished_frame(&before);
+    report.stopped();
+
+    report.added_display(1280, 1024, 0, 0, &after);
+    report.began_frame(&after);
+    report.finished_frame(&after);
+
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_frames_total{output=\"1920x1080+0+0\"} 1\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_frames_total{output=\"1280x1024+0+0\"} 1\n"));
+}
+
+TEST_F(MetricsReport, counts_frames_of_outputs_it_was_not_told_about)
+{
+    mrm::CompositorReport report{registry, clock};
+    int output;
+
+    report.began_frame(&output);
+    report.finished_frame(&output);
+
+    EXPECT_THAT(text(), HasSubstr("mir_compositor_frames_total{output=\"unknown-0\"} 1\n"));
+}
+
+TEST_F(MetricsReport, times_client_requests_by_method)
+{
+    mrm::MessageProcessorReport report{registry, clock};
+    int mediator;
+
+    report.received_invocation(&mediator, 1, "create_surface");
+    clock->advance_by(1ms);
+    report.completed_invocation(&mediator, 1, true);
+
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_invocations_total{method=\"create_surface\"} 1\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_invocation_seconds_count{method=\"create_surface\"} 1\n"));
+}
+
+TEST_F(MetricsReport, times_each_submission_ring_entry)
+{
+    mrm::MessageProcessorReport report{registry, clock};
+    int mediator;
+
+    for (auto i = 0; i != 3; ++i)
+    {
+        report.received_invocation(&mediator, ring_invocation_id, "submit_buffer");
+        report.completed_invocation(&mediator, ring_invocation_id, true);
+    }
+
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_invocations_total{method=\"submit_buffer\"} 3\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_invocation_seconds_count{method=\"submit_buffer\"} 3\n"));
+}
+
+TEST_F(MetricsReport, does_not_time_requests_that_failed)
+{
+    mrm::MessageProcessorReport report{registry, clock};
+    int mediator;
+
+    report.received_invocation(&mediator, 1, "create_surface");
+    report.exception_handled(&mediator, 1, std::runtime_error{"failed"});
+    report.completed_invocation(&mediator, 1, false);
+
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_exceptions_total 1\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_ipc_invocation_seconds_count{method=\"create_surface\"} 0\n"));
+}
+
+TEST_F(MetricsReport, counts_requests_of_each_client)
+{
+    mrm::SessionMediatorReport report{registry};
+
+    report.session_connect_called("terminal");
+    report.session_submit_buffer_called("terminal");
+    report.session_submit_buffer_called("terminal");
+    report.session_create_buffer_stream_called("terminal");
+
+    EXPECT_THAT(text(), HasSubstr("mir_clients_connected 1\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_client_buffer_submissions_total{client=\"terminal\"} 2\n"));
+    EXPECT_THAT(text(), HasSubstr("mir_client_buffer_streams{client=\"terminal\"} 1\n"));
+}
+
+TEST_F(MetricsReport, removes_client_metrics_when_the_last_client_with_the_name_disconnects)
+{
+    mrm::SessionMediatorReport report{registry};
+
+    report.session_connect_called("terminal");
+    report.session_connect_called("terminal");
+    report.session_submit_buffer_called("terminal");
+
+    report.session_disconnect_called("terminal");
+    EXPECT_THAT(text(), HasSubstr("mir_client_buffer_submissions_total{client=\"terminal\"} 1\n"));
+
+    report.session_disconnect_called("terminal");
+    EXPECT_THAT(text(), Not(HasSubstr("client=\"terminal\"")));
+    EXPECT_THAT(text(), HasSubstr("mir_clients_connected 0\n"));
+}
+
+TEST_F(MetricsReport, counts_a_reconnected_client_afresh)
+{
+    mrm::SessionMediatorReport report{registry};
+
+    report.session_connect_called("terminal");
+    report.session_submit_buffer_called("terminal");
+    report.session_disconnect_called("terminal");
+
+    report.session_connect_called("terminal");
+    report.session_submit_buffer_called("terminal");
+
+    EXPECT_THAT(text(), HasSubstr("mir_client_buffer_submissions_total{client=\"terminal\"} 1\n"));
+}
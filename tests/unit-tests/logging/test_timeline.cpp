@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/report/timeline.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <thread>
+
+#include <pthread.h>
+
+namespace mrt = mir::report::timeline;
+using namespace testing;
+
+namespace
+{
+struct Timeline : Test
+{
+    mrt::Timeline timeline{8};
+
+    auto json() const -> std::string
+    {
+        std::stringstream out;
+        timeline.write_to(out);
+        return out.str();
+    }
+};
+}
+
+TEST_F(Timeline, records_nothing_until_started)
+{
+    {
+        mrt::Span const span{"composite", timeline};
+    }
+
+    EXPECT_THAT(json(), Not(HasSubstr("composite")));
+}
+
+TEST_F(Timeline, records_spans_while_recording)
+{
+    timeline.start();
+    {
+        mrt::Span const span{"composite", timeline};
+    }
+    timeline.stop();
+    {
+        mrt::Span const span{"after", timeline};
+    }
+
+    EXPECT_THAT(json(), StartsWith("{\"traceEvents\":["));
+    EXPECT_THAT(json(), HasSubstr("{\"name\":\"composite\",\"cat\":\"mir\",\"ph\":\"X\",\"ts\":"));
+    EXPECT_THAT(json(), Not(HasSubstr("after")));
+}
+
+TEST_F(Timeline, names_the_threads_that_recorded)
+{
+    timeline.start();
+    std::thread{[this]
+        {
+            pthread_setname_np(pthread_self(), "Mir/Test");
+            mrt::Span const span{"dispatch", timeline};
+        }}.join();
+
+    EXPECT_THAT(json(), HasSubstr("\"ph\":\"M\""));
+    EXPECT_THAT(json(), HasSubstr("\"args\":{\"name\":\"Mir/Test\"}"));
+}
+
+TEST_F(Timeline, starting_again_discards_the_previous_recording)
+{
+    timeline.start();
+    {
+        mrt::Span const span{"first", timeline};
+    }
+    timeline.start();
+    {
+        mrt::Span const span{"second", timeline};
+    }
+
+    EXPECT_THAT(json(), Not(HasSubstr("first")));
+    EXPECT_THAT(json(), HasSubstr("second"));
+}
+
+TEST_F(Timeline, held_flows_end_in_a_later_span)
+{
+    timeline.start();
+    {
+        mrt::Span const span{"composite", timeline};
+        timeline.flow(mrt::FlowPhase::step, 42);
+        timeline.hold_flow(42);
+    }
+    {
+        mrt::Span const span{"page flip", timeline};
+        timeline.end_flows(timeline.release_held_flows());
+    }
+
+    EXPECT_THAT(json(), HasSubstr("\"ph\":\"t\",\"ts\":"));
+    EXPECT_THAT(json(), HasSubstr(",\"id\":42,\"bp\":\"e\","));
+    EXPECT_THAT(timeline.release_held_flows(), IsEmpty());
+}
+
+TEST_F(Timeline, counts_events_dropped_when_a_thread_buffer_is_full)
+{
+    timeline.start();
+    for (auto i = 0; i != 10; ++i)
+    {
+        mrt::Span const span{"composite", timeline};
+    }
+
+    EXPECT_THAT(json(), HasSubstr("\"otherData\":{\"dropped_events\":2}"));
+}
+
+TEST_F(Timeline, thread_buffers_grow_to_the_requested_size)
+{
+    auto const events = 2500;
+    mrt::Timeline timeline{events};
+
+    timeline.start();
+    for (auto i = 0; i != events + 1; ++i)
+    {
+        mrt::Span const span{"composite", timeline};
+    }
+
+    std::stringstream out;
+    timeline.write_to(out);
+    auto const json = out.str();
+
+    auto spans = 0;
+    for (auto i = json.find("\"ph\":\"X\""); i != std::string::npos; i = json.find("\"ph\":\"X\"", i + 1))
+        ++spans;
+
+    EXPECT_THAT(spans, Eq(events));
+    EXPECT_THAT(json, HasSubstr("\"otherData\":{\"dropped_events\":1}"));
+}
+
+TEST_F(Timeline, writes_exited_threads_once_stopped)
+{
+    timeline.start();
+    std::thread{[this]
+        {
+            mrt::Span const span{"dispatch", timeline};
+        }}.join();
+    timeline.stop();
+
+    EXPECT_THAT(json(), HasSubstr("dispatch"));
+    EXPECT_THAT(json(), Not(HasSubstr("dispatch")));
+}
+
+TEST_F(Timeline, keeps_exited_threads_while_recording)
+{
+    timeline.start();
+    std::thread{[this]
+        {
+            mrt::Span const span{"dispatch", timeline};
+        }}.join();
+
+    EXPECT_THAT(json(), HasSubstr("dispatch"));
+    EXPECT_THAT(json(), HasSubstr("dispatch"));
+}
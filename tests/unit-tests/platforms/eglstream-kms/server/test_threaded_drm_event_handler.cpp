@@ -22,6 +22,14 @@
 
 #include <mutex>
 #include <deque>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#include <dirent.h>
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -209,3 +217,122 @@ TEST_F(ThreadedDRMEventHandlerTest, dispatches_event_for_correct_crtc)
     EXPECT_THAT(first_handle.wait_for(30s), Eq(std::future_status::ready));
     EXPECT_TRUE(first_flip_done);
 }
+
+TEST_F(ThreadedDRMEventHandlerTest, records_flip_statistics_per_crtc)
+{
+    using namespace std::literals::chrono_literals;
+
+    mge::ThreadedDRMEventHandler handler{mock_drm_fd};
+    mge::ThreadedDRMEventHandler::KMSCrtcId const crtc_one{55};
+    mge::ThreadedDRMEventHandler::KMSCrtcId const crtc_two{44};
+
+    for (auto i = 0; i != 2; ++i)
+    {
+        auto handle = handler.expect_flip_event(crtc_one, [](auto, auto){});
+        add_flip_event(0, 0, 0, crtc_one, handler.drm_event_data());
+        ASSERT_THAT(handle.wait_for(30s), Eq(std::future_status::ready));
+    }
+
+    auto const stats = handler.flip_statistics(crtc_one);
+    EXPECT_THAT(stats.flips, Eq(2u));
+    EXPECT_THAT(stats.max_latency, Le(stats.total_latency));
+    EXPECT_THAT(handler.flip_statistics(crtc_two).flips, Eq(0u));
+}
+
+TEST_F(ThreadedDRMEventHandlerTest, can_be_destroyed_with_flip_outstanding)
+{
+    auto handler = std::make_unique<mge::ThreadedDRMEventHandler>(mock_drm_fd);
+    auto handle = handler->expect_flip_event(55, [](auto, auto){});
+
+    // Would hang if the dispatch thread couldn't be woken from waiting for the flip
+    handler.reset();
+}
+
+namespace
+{
+// A pipe with its write end closed polls as POLLHUP forever, like a broken DRM fd
+auto hung_up_fd() -> mir::Fd
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        throw std::system_error{errno, std::system_category(), "Failed to create pipe"};
+    }
+    close(fds[1]);
+    return mir::Fd{fds[0]};
+}
+
+auto threads_of_this_process() -> std::set<pid_t>
+{
+    std::set<pid_t> result;
+    if (auto const dir = opendir("/proc/self/task"))
+    {
+        while (auto const entry = readdir(dir))
+        {
+            if (entry->d_name[0] != '.')
+                result.insert(std::stoi(entry->d_name));
+        }
+        closedir(dir);
+    }
+    return result;
+}
+
+/// The CPU time (user and system) used by thread \a tid, in clock ticks
+auto cpu_ticks_used_by(pid_t tid) -> unsigned long
+{
+    std::ifstream stat{"/proc/self/task/" + std::to_string(tid) + "/stat"};
+    std::string contents{std::istreambuf_iterator<char>{stat}, std::istreambuf_iterator<char>{}};
+
+    // Fields follow the parenthesised thread name; utime and stime are the 12th and 13th of them
+    std::istringstream fields{contents.substr(contents.rfind(')') + 1)};
+    std::string field;
+    for (auto i = 0; i != 11; ++i)
+        fields >> field;
+
+    unsigned long utime{0}, stime{0};
+    fields >> utime >> stime;
+    return utime + stime;
+}
+}
+
+TEST_F(ThreadedDRMEventHandlerTest, expected_flips_fail_when_the_drm_fd_fails)
+{
+    using namespace std::literals::chrono_literals;
+
+    mge::ThreadedDRMEventHandler handler{hung_up_fd()};
+
+    auto first = handler.expect_flip_event(55, [](auto, auto){});
+    ASSERT_THAT(first.wait_for(30s), Eq(std::future_status::ready));
+    EXPECT_THROW(first.get(), std::system_error);
+
+    // The dispatch thread tries again for the next expectation
+    auto second = handler.expect_flip_event(55, [](auto, auto){});
+    ASSERT_THAT(second.wait_for(30s), Eq(std::future_status::ready));
+    EXPECT_THROW(second.get(), std::system_error);
+}
+
+TEST_F(ThreadedDRMEventHandlerTest, does_not_spin_when_the_drm_fd_fails)
+{
+    using namespace std::literals::chrono_literals;
+
+    auto const threads_before = threads_of_this_process();
+    mge::ThreadedDRMEventHandler handler{hung_up_fd()};
+
+    std::vector<pid_t> dispatch_threads;
+    for (auto const tid : threads_of_this_process())
+    {
+        if (!threads_before.count(tid))
+            dispatch_threads.push_back(tid);
+    }
+    ASSERT_THAT(dispatch_threads, SizeIs(1));
+
+    auto flip = handler.expect_flip_event(55, [](auto, auto){});
+    ASSERT_THAT(flip.wait_for(30s), Eq(std::future_status::ready));
+
+    auto const ticks_per_second = sysconf(_SC_CLK_TCK);
+    auto const ticks_before = cpu_ticks_used_by(dispatch_threads.front());
+    std::this_thread::sleep_for(500ms);
+
+    // A dispatch thread polling in a loop would use (nearly) the whole interval
+    EXPECT_THAT(cpu_ticks_used_by(dispatch_threads.front()) - ticks_before, Lt(ticks_per_second / 4));
+}
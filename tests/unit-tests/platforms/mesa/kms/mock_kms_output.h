@@ -68,6 +68,8 @@ struct MockKMSOutput : public graphics::mesa::KMSOutput
 
     MOCK_METHOD1(set_power_mode, void(MirPowerMode));
     MOCK_METHOD1(set_gamma, void(mir::graphics::GammaCurves const&));
+    MOCK_METHOD1(set_variable_refresh, void(bool));
+    MOCK_CONST_METHOD0(variable_refresh_active, bool());
 
     MOCK_METHOD0(refresh_hardware_state, void());
     MOCK_CONST_METHOD1(update_from_hardware_state, void(graphics::DisplayConfigurationOutput&));
@@ -798,3 +798,56 @@ TEST_F(MesaCursorTest, show_cursor_sets_cursor_with_hotspot)
     cursor.move_to(cursor_location_2);
 }
 
+
+TEST_F(MesaCursorTest, showing_the_same_image_again_does_not_rewrite_buffers)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+
+    cursor.show(stub_image);
+}
+
+TEST_F(MesaCursorTest, animated_cursor_frames_are_written_only_once)
+{
+    using namespace testing;
+
+    struct FilledCursorImage : public StubCursorImage
+    {
+        explicit FilledCursorImage(uint32_t pixel) : pixels(64*64, pixel) {}
+
+        void const* as_argb_8888() const override
+        {
+            return pixels.data();
+        }
+
+        std::vector<uint32_t> const pixels;
+    };
+
+    FilledCursorImage const frame1{0xff0000ff};
+    FilledCursorImage const frame2{0xff00ff00};
+
+    cursor.show(frame1);
+    cursor.show(frame2);
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+
+    cursor.show(frame1);
+    cursor.show(frame2);
+}
+
+TEST_F(MesaCursorTest, moving_between_differently_rotated_outputs_reuses_rotated_images)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+    cursor.move_to({766, 112});
+    cursor.move_to({10, 10});
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+
+    cursor.move_to({766, 112});
+    cursor.move_to({10, 10});
+}
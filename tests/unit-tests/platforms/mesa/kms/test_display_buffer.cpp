@@ -207,7 +207,30 @@ TEST_F(MesaDisplayBufferTest, predictive_bypass_is_throttled)
     }
 }
 
-TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
+TEST_F(MesaDisplayBufferTest, bypass_is_not_throttled_with_variable_refresh)
+{
+    ON_CALL(*mock_kms_output, variable_refresh_active())
+        .WillByDefault(Return(true));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        ASSERT_TRUE(db.overlay(bypassable_list));
+        db.post();
+
+        // Cast to a simple int type so that test failures are readable
+        ASSERT_EQ(0, db.recommended_sleep().count());
+    }
+}
+
+TEST_F(MesaDisplayBufferTest, composited_frames_are_not_throttled_until_measured)
 {
     graphics::RenderableList non_bypassable_list{
         std::make_shared<FakeRenderable>(geometry::Rectangle{{12, 34}, {1, 1}})
@@ -221,7 +244,8 @@ TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
         display_area,
         identity);
 
-    for (int frame = 0; frame < 5; ++frame)
+    // The initial estimate of composited render time is longer than a frame
+    for (auto frame = 0u; frame + 1 < RenderTimeEstimator::min_samples; ++frame)
     {
         ASSERT_FALSE(db.overlay(non_bypassable_list));
         db.post();
@@ -231,6 +255,94 @@ TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
     }
 }
 
+TEST_F(MesaDisplayBufferTest, fast_composited_frames_are_throttled_once_measured)
+{
+    graphics::RenderableList non_bypassable_list{
+        std::make_shared<FakeRenderable>(geometry::Rectangle{{12, 34}, {1, 1}})
+    };
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    for (auto frame = 0u; frame < RenderTimeEstimator::min_samples; ++frame)
+    {
+        ASSERT_FALSE(db.overlay(non_bypassable_list));
+        db.post();
+    }
+
+    // Cast to a simple int type so that test failures are readable
+    int milliseconds_per_frame = 1000 / mock_refresh_rate;
+    EXPECT_THAT(db.recommended_sleep().count(), Gt(0));
+    EXPECT_THAT(db.recommended_sleep().count(), Lt(milliseconds_per_frame));
+}
+
+TEST_F(MesaDisplayBufferTest, fast_composited_frames_on_cloned_outputs_are_throttled_once_measured)
+{
+    graphics::RenderableList non_bypassable_list{
+        std::make_shared<FakeRenderable>(geometry::Rectangle{{12, 34}, {1, 1}})
+    };
+
+    // The outputs flipped a moment ago
+    ON_CALL(*mock_kms_output, last_frame())
+        .WillByDefault(Invoke([]
+            {
+                graphics::Frame frame;
+                frame.ust = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC) - std::chrono::milliseconds{1};
+                return frame;
+            }));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output, mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    for (auto frame = 0u; frame < RenderTimeEstimator::min_samples; ++frame)
+    {
+        ASSERT_FALSE(db.overlay(non_bypassable_list));
+        db.post();
+    }
+
+    // The frame just posted flips at the next vblank, and the next frame is due at the one after
+    int milliseconds_per_frame = 1000 / mock_refresh_rate;
+    EXPECT_THAT(db.recommended_sleep().count(), Gt(0));
+    EXPECT_THAT(db.recommended_sleep().count(), Lt(2 * milliseconds_per_frame));
+}
+
+TEST_F(MesaDisplayBufferTest, cloned_outputs_without_recent_flips_are_not_throttled)
+{
+    graphics::RenderableList non_bypassable_list{
+        std::make_shared<FakeRenderable>(geometry::Rectangle{{12, 34}, {1, 1}})
+    };
+
+    // The outputs haven't flipped since startup
+    ON_CALL(*mock_kms_output, last_frame())
+        .WillByDefault(Return(graphics::Frame{}));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output, mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    for (auto frame = 0u; frame < RenderTimeEstimator::min_samples; ++frame)
+    {
+        ASSERT_FALSE(db.overlay(non_bypassable_list));
+        db.post();
+
+        ASSERT_EQ(0, db.recommended_sleep().count());
+    }
+}
+
 TEST_F(MesaDisplayBufferTest, bypass_buffer_only_referenced_once_by_db)
 {
     graphics::mesa::DisplayBuffer db(
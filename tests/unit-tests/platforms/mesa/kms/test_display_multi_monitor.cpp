@@ -541,6 +541,119 @@ TEST_F(MesaDisplayMultiMonitorTest, configure_clears_unused_connected_outputs)
     }
 }
 
+TEST_F(MesaDisplayMultiMonitorTest, configure_keeps_display_buffers_of_unchanged_outputs)
+{
+    using namespace testing;
+
+    int const num_connected_outputs{3};
+    int const num_disconnected_outputs{2};
+
+    setup_outputs(num_connected_outputs, num_disconnected_outputs);
+
+    auto display = create_display_side_by_side(create_platform());
+
+    std::vector<mg::DisplaySyncGroup*> groups_before;
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group) { groups_before.push_back(&group); });
+    ASSERT_THAT(groups_before.size(), Eq(3u));
+
+    /* Turn off just the last output */
+    auto conf = display->configuration();
+    auto output_index = 0;
+    conf->for_each_output(
+        [&](mg::UserDisplayConfigurationOutput& output)
+        {
+            if (output.connected && ++output_index == num_connected_outputs)
+                output.used = false;
+        });
+
+    display->configure(*conf);
+
+    std::vector<mg::DisplaySyncGroup*> groups_after;
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group) { groups_after.push_back(&group); });
+
+    EXPECT_THAT(groups_after, ElementsAre(groups_before[0], groups_before[1]));
+}
+
+TEST_F(MesaDisplayMultiMonitorTest, configure_sets_power_mode_of_outputs_whose_display_buffers_are_kept)
+{
+    using namespace testing;
+
+    int const num_connected_outputs{3};
+    int const num_disconnected_outputs{2};
+
+    setup_outputs(num_connected_outputs, num_disconnected_outputs);
+
+    auto display = create_display_side_by_side(create_platform());
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+
+    /* Only the powered off output changes its DPMS state */
+    EXPECT_CALL(mock_drm,
+                drmModeConnectorSetProperty(mtd::IsFdOfDevice(drm_device),
+                                            connector_ids[num_connected_outputs - 1],
+                                            _, mir_power_mode_off))
+                    .Times(1);
+    EXPECT_CALL(mock_drm, drmModeConnectorSetProperty(_, Ne(connector_ids[num_connected_outputs - 1]), _, _))
+        .Times(0);
+
+    /* Turn off just the last output, as idle blanking does */
+    auto conf = display->configuration();
+    auto output_index = 0;
+    conf->for_each_output(
+        [&](mg::UserDisplayConfigurationOutput& output)
+        {
+            if (output.connected && ++output_index == num_connected_outputs)
+                output.power_mode = mir_power_mode_off;
+        });
+
+    display->configure(*conf);
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+}
+
+TEST_F(MesaDisplayMultiMonitorTest, resume_restores_last_frame_without_waiting_for_next_post)
+{
+    using namespace testing;
+
+    int const num_connected_outputs{3};
+    int const num_disconnected_outputs{2};
+    uint32_t const fb_id{66};
+
+    setup_outputs(num_connected_outputs, num_disconnected_outputs);
+
+    EXPECT_CALL(mock_drm, drmModeAddFB2(mtd::IsFdOfDevice(drm_device),
+                                        _, _, _, _, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<7>(fb_id), Return(0)));
+
+    auto display = create_display_cloned(create_platform());
+
+    display->pause();
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+
+    EXPECT_CALL(mock_drm, drmModeAddFB2(mtd::IsFdOfDevice(drm_device),
+                                        _, _, _, _, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<7>(fb_id), Return(0)));
+
+    /* All active crtcs show the last frame again straight away */
+    for (int i = 0; i < num_connected_outputs; i++)
+    {
+        EXPECT_CALL(mock_drm,
+                    drmModeSetCrtc(mtd::IsFdOfDevice(drm_device),
+                                   crtc_ids[i], fb_id,
+                                   _, _,
+                                   Pointee(connector_ids[i]),
+                                   _, _))
+                        .Times(1);
+    }
+
+    display->resume();
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+}
+
 TEST_F(MesaDisplayMultiMonitorTest, resume_clears_unused_connected_outputs)
 {
     using namespace testing;
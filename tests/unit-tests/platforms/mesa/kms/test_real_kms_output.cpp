@@ -26,6 +26,7 @@
 #include "mir/test/doubles/mock_gbm.h"
 
 #include <stdexcept>
+#include <cstring>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -548,3 +549,66 @@ TEST_F(RealKMSOutputTest, drm_set_gamma_failure_does_not_throw)
 
     EXPECT_NO_THROW(output.set_gamma(gamma););
 }
+
+TEST_F(RealKMSOutputTest, variable_refresh_is_enabled_on_crtc_that_supports_it)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+
+    uint32_t vrr_prop_id{99};
+    uint64_t vrr_value{0};
+    drmModeObjectProperties crtc_props{1, &vrr_prop_id, &vrr_value};
+    drmModePropertyRes vrr_prop{};
+    vrr_prop.prop_id = vrr_prop_id;
+    strncpy(vrr_prop.name, "VRR_ENABLED", sizeof vrr_prop.name - 1);
+
+    ON_CALL(mock_drm, drmModeObjectGetProperties(_, crtc_ids[0], DRM_MODE_OBJECT_CRTC))
+        .WillByDefault(Return(&crtc_props));
+    ON_CALL(mock_drm, drmModeGetProperty(_, vrr_prop_id))
+        .WillByDefault(Return(&vrr_prop));
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, vrr_prop_id, 1))
+        .WillOnce(Return(0));
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    append_fb_id(fb_id);
+
+    auto fb = output.fb_for(fake_bo);
+
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    output.set_variable_refresh(true);
+    EXPECT_TRUE(output.variable_refresh_active());
+}
+
+TEST_F(RealKMSOutputTest, variable_refresh_is_not_active_without_crtc_support)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(_, _, _, _, _)).Times(0);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    append_fb_id(fb_id);
+
+    auto fb = output.fb_for(fake_bo);
+
+    output.set_variable_refresh(true);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    EXPECT_FALSE(output.variable_refresh_active());
+}
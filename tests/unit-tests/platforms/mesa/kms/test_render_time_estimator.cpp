@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/mesa/server/kms/render_time_estimator.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mgm = mir::graphics::mesa;
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+auto const initial_estimate = milliseconds{50};
+}
+
+TEST(RenderTimeEstimator, uses_initial_estimate_until_enough_frames_are_measured)
+{
+    mgm::RenderTimeEstimator estimator{initial_estimate};
+
+    for (auto i = 0u; i != mgm::RenderTimeEstimator::min_samples - 1; ++i)
+    {
+        estimator.record(milliseconds{1});
+        EXPECT_THAT(estimator.estimate(), Eq(initial_estimate));
+    }
+
+    estimator.record(milliseconds{1});
+    EXPECT_THAT(estimator.estimate(), Lt(initial_estimate));
+}
+
+TEST(RenderTimeEstimator, estimate_covers_measured_frames_with_a_margin)
+{
+    mgm::RenderTimeEstimator estimator{initial_estimate};
+
+    for (auto i = 0u; i != mgm::RenderTimeEstimator::window_size; ++i)
+        estimator.record(milliseconds{4});
+
+    EXPECT_THAT(estimator.estimate(), Gt(milliseconds{4}));
+    EXPECT_THAT(estimator.estimate(), Lt(milliseconds{8}));
+}
+
+TEST(RenderTimeEstimator, estimate_is_not_skewed_by_rare_outliers)
+{
+    mgm::RenderTimeEstimator estimator{initial_estimate};
+
+    for (auto i = 0u; i != mgm::RenderTimeEstimator::window_size; ++i)
+        estimator.record(i == 10 ? milliseconds{100} : milliseconds{4});
+
+    EXPECT_THAT(estimator.estimate(), Lt(milliseconds{8}));
+}
+
+TEST(RenderTimeEstimator, estimate_follows_a_sustained_slowdown)
+{
+    mgm::RenderTimeEstimator estimator{initial_estimate};
+
+    for (auto i = 0u; i != mgm::RenderTimeEstimator::window_size; ++i)
+        estimator.record(milliseconds{4});
+
+    for (auto i = 0u; i != mgm::RenderTimeEstimator::window_size / 4; ++i)
+        estimator.record(milliseconds{12});
+
+    EXPECT_THAT(estimator.estimate(), Ge(milliseconds{12}));
+}
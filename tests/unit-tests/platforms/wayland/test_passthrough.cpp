@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "passthrough.h"
+
+#include "mir/test/doubles/stub_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mg = mir::graphics;
+namespace mgw = mir::graphics::wayland;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+struct ClippedRenderable : mtd::StubRenderable
+{
+    using StubRenderable::StubRenderable;
+
+    std::experimental::optional<geom::Rectangle> clip_area() const override
+    {
+        return geom::Rectangle{{0, 0}, {10, 10}};
+    }
+};
+
+struct TranslucentRenderable : mtd::StubRenderable
+{
+    using StubRenderable::StubRenderable;
+
+    float alpha() const override
+    {
+        return 0.5f;
+    }
+};
+
+struct Passthrough : Test
+{
+    geom::Rectangle const area{{100, 100}, {1920, 1080}};
+    geom::Rectangle const window{{200, 300}, {640, 480}};
+
+    auto shm_buffer(geom::Size size, MirPixelFormat format = mir_pixel_format_argb_8888)
+        -> std::shared_ptr<mg::Buffer>
+    {
+        return std::make_shared<mtd::StubBuffer>(mg::BufferProperties{size, format, mg::BufferUsage::software});
+    }
+
+    auto renderable(geom::Rectangle const& position) -> std::shared_ptr<mg::Renderable>
+    {
+        return std::make_shared<mtd::StubRenderable>(shm_buffer(position.size), position);
+    }
+};
+}
+
+TEST_F(Passthrough, unscaled_opaque_shm_buffers_are_planes_in_order)
+{
+    geom::Rectangle const top{{150, 150}, {100, 100}};
+    mg::RenderableList const renderlist{renderable(window), renderable(top)};
+
+    auto const planes = mgw::passthrough_planes(renderlist, area, 1.0f);
+
+    ASSERT_THAT(planes.size(), Eq(2u));
+    EXPECT_THAT(planes[0].buffer, Eq(renderlist[0]->buffer()));
+    EXPECT_THAT(planes[0].position, Eq(geom::Point{100, 200}));
+    EXPECT_THAT(planes[1].buffer, Eq(renderlist[1]->buffer()));
+    EXPECT_THAT(planes[1].position, Eq(geom::Point{50, 50}));
+}
+
+TEST_F(Passthrough, xrgb_buffers_are_planes)
+{
+    mg::RenderableList const renderlist{
+        std::make_shared<mtd::StubRenderable>(shm_buffer(window.size, mir_pixel_format_xrgb_8888), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f).size(), Eq(1u));
+}
+
+TEST_F(Passthrough, nothing_to_show_needs_gl)
+{
+    EXPECT_THAT(mgw::passthrough_planes({}, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, scaled_output_needs_gl)
+{
+    EXPECT_THAT(mgw::passthrough_planes({renderable(window)}, area, 2.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, too_many_renderables_need_gl)
+{
+    mg::RenderableList renderlist;
+    for (auto i = 0u; i != mgw::max_passthrough_planes + 1; ++i)
+        renderlist.push_back(renderable(window));
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, formats_the_host_may_not_support_need_gl)
+{
+    mg::RenderableList const renderlist{
+        std::make_shared<mtd::StubRenderable>(shm_buffer(window.size, mir_pixel_format_abgr_8888), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, translucent_renderable_needs_gl)
+{
+    mg::RenderableList const renderlist{std::make_shared<TranslucentRenderable>(shm_buffer(window.size), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, transformed_renderable_needs_gl)
+{
+    mg::RenderableList const renderlist{
+        std::make_shared<mtd::StubTransformedRenderable>(shm_buffer(window.size), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, scaled_renderable_needs_gl)
+{
+    mg::RenderableList const renderlist{
+        std::make_shared<mtd::StubRenderable>(shm_buffer({320, 240}), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, renderable_partly_off_the_output_needs_gl)
+{
+    EXPECT_THAT(mgw::passthrough_planes({renderable({{1800, 300}, {640, 480}})}, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, clipped_renderable_needs_gl)
+{
+    mg::RenderableList const renderlist{std::make_shared<ClippedRenderable>(shm_buffer(window.size), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
+
+TEST_F(Passthrough, one_unsuitable_renderable_puts_everything_on_gl)
+{
+    mg::RenderableList const renderlist{
+        renderable(window),
+        std::make_shared<mtd::StubTransformedRenderable>(shm_buffer(window.size), window)};
+
+    EXPECT_THAT(mgw::passthrough_planes(renderlist, area, 1.0f), IsEmpty());
+}
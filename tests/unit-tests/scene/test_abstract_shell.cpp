@@ -112,7 +112,8 @@ struct MockSessionManager : ms::SessionManager
               display,
               std::make_shared<mtd::NullANRDetector>(),
               std::make_shared<mtd::StubBufferAllocator>(),
-              std::make_shared<mtd::StubObserverRegistrar<mir::graphics::DisplayConfigurationObserver>>()}
+              std::make_shared<mtd::StubObserverRegistrar<mir::graphics::DisplayConfigurationObserver>>(),
+              ms::ResourceLimits{}}
     {
     }
 
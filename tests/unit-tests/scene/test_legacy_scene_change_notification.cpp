@@ -18,6 +18,7 @@
 
 #include "mir/scene/legacy_scene_change_notification.h"
 #include "mir/scene/surface_observer.h"
+#include "mir/geometry/rectangle.h"
 
 #include "mir/test/fake_shared.h"
 #include "mir/test/doubles/mock_surface.h"
@@ -39,6 +40,10 @@ struct MockBufferCallback
 {
     MOCK_METHOD1(invoke, void(int));
 };
+struct MockDamageCallback
+{
+    MOCK_METHOD2(invoke, void(int, mir::geometry::Rectangle const&));
+};
 
 struct LegacySceneChangeNotificationTest : public testing::Test
 {
@@ -99,6 +104,29 @@ TEST_F(LegacySceneChangeNotificationTest, observes_surface_changes)
     surface_observer->frame_posted(surface.get(), buffer_num, mir::geometry::Size{0, 0});
 }
 
+TEST_F(LegacySceneChangeNotificationTest, forwards_scene_damage_to_damage_callback)
+{
+    using namespace ::testing;
+    MockDamageCallback damage_callback;
+    mir::geometry::Rectangle const damage{{5, 6}, {7, 8}};
+
+    EXPECT_CALL(scene_callback, invoke()).Times(0);
+    EXPECT_CALL(damage_callback, invoke(1, damage)).Times(1);
+
+    ms::LegacySceneChangeNotification observer(
+        scene_change_callback,
+        [&](int frames, mir::geometry::Rectangle const& damage) { damage_callback.invoke(frames, damage); });
+    observer.scene_damaged(damage);
+}
+
+TEST_F(LegacySceneChangeNotificationTest, treats_scene_damage_as_scene_change_without_damage_callback)
+{
+    EXPECT_CALL(scene_callback, invoke()).Times(1);
+
+    ms::LegacySceneChangeNotification observer(scene_change_callback, buffer_change_callback);
+    observer.scene_damaged({{5, 6}, {7, 8}});
+}
+
 TEST_F(LegacySceneChangeNotificationTest, redraws_on_rename)
 {
     using namespace ::testing;
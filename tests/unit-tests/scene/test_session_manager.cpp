@@ -96,7 +96,8 @@ struct SessionManagerSetup : public testing::Test
         mt::fake_shared(display),
         std::make_shared<mtd::NullANRDetector>(),
         mt::fake_shared(allocator),
-        mt::fake_shared(display_config_registrar)};
+        mt::fake_shared(display_config_registrar),
+        ms::ResourceLimits{}};
 };
 
 }
@@ -124,7 +125,8 @@ struct SessionManagerSessionListenerSetup : public testing::Test
         mt::fake_shared(display),
         std::make_shared<mtd::NullANRDetector>(),
         mt::fake_shared(allocator),
-        mt::fake_shared(display_config_registrar)};
+        mt::fake_shared(display_config_registrar),
+        ms::ResourceLimits{}};
 };
 }
 
@@ -206,7 +208,8 @@ struct SessionManagerSessionEventsSetup : public testing::Test
         mt::fake_shared(display),
         std::make_shared<mtd::NullANRDetector>(),
         mt::fake_shared(allocator),
-        mt::fake_shared(display_config_registrar)};
+        mt::fake_shared(display_config_registrar),
+        ms::ResourceLimits{}};
 };
 }
 
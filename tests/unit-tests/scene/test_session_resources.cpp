@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/scene/session_resources.h"
+
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <stdexcept>
+
+namespace ms = mir::scene;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+struct SessionResources : Test
+{
+    std::shared_ptr<ms::SessionResources> resources{std::make_shared<ms::SessionResources>("test")};
+
+    // 4 bytes per pixel, so 1024 bytes
+    std::shared_ptr<mg::Buffer> const buffer{std::make_shared<mtd::StubBuffer>(geom::Size{16, 16})};
+};
+}
+
+TEST_F(SessionResources, counts_surfaces_and_buffer_streams)
+{
+    resources->add_surface();
+    resources->add_surface();
+    resources->add_buffer_stream();
+    resources->remove_surface();
+
+    EXPECT_THAT(resources->usage().surfaces, Eq(1u));
+    EXPECT_THAT(resources->usage().buffer_streams, Eq(1u));
+}
+
+TEST_F(SessionResources, surfaces_over_the_limit_are_refused)
+{
+    ms::ResourceLimits limits;
+    limits.max_surfaces = 2;
+    resources->set_limits(limits);
+
+    resources->add_surface();
+    resources->add_surface();
+
+    EXPECT_THROW(resources->add_surface(), std::runtime_error);
+    EXPECT_THAT(resources->usage().surfaces, Eq(2u));
+
+    resources->remove_surface();
+    EXPECT_NO_THROW(resources->add_surface());
+}
+
+TEST_F(SessionResources, buffer_streams_over_the_limit_are_refused)
+{
+    ms::ResourceLimits limits;
+    limits.max_buffer_streams = 1;
+    resources->set_limits(limits);
+
+    resources->add_buffer_stream();
+
+    EXPECT_THROW(resources->add_buffer_stream(), std::runtime_error);
+    EXPECT_THAT(resources->usage().buffer_streams, Eq(1u));
+}
+
+TEST_F(SessionResources, buffers_are_accounted_until_released)
+{
+    auto tracked = resources->track(buffer);
+    auto copy = tracked;
+
+    EXPECT_THAT(tracked.get(), Eq(buffer.get()));
+    EXPECT_THAT(resources->usage().buffers, Eq(1u));
+    EXPECT_THAT(resources->usage().buffer_bytes, Eq(1024u));
+
+    tracked.reset();
+    EXPECT_THAT(resources->usage().buffers, Eq(1u));
+
+    copy.reset();
+    EXPECT_THAT(resources->usage().buffers, Eq(0u));
+    EXPECT_THAT(resources->usage().buffer_bytes, Eq(0u));
+}
+
+TEST_F(SessionResources, tracked_buffers_keep_the_accounting_alive)
+{
+    auto tracked = resources->track(buffer);
+    std::weak_ptr<ms::SessionResources> const weak{resources};
+
+    resources.reset();
+    EXPECT_FALSE(weak.expired());
+
+    tracked.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST_F(SessionResources, buffers_over_the_memory_limit_are_refused)
+{
+    ms::ResourceLimits limits;
+    limits.max_buffer_bytes = 1536;
+    resources->set_limits(limits);
+
+    auto const first = resources->track(buffer);
+
+    EXPECT_THROW(resources->track(buffer), std::runtime_error);
+    EXPECT_THAT(resources->usage().buffers, Eq(1u));
+    EXPECT_THAT(resources->usage().buffer_bytes, Eq(1024u));
+}
+
+TEST_F(SessionResources, buffers_over_the_warning_level_are_accepted)
+{
+    ms::ResourceLimits limits;
+    limits.buffer_bytes_warning = 512;
+    resources->set_limits(limits);
+
+    auto const first = resources->track(buffer);
+    auto const second = resources->track(buffer);
+
+    EXPECT_THAT(resources->usage().buffers, Eq(2u));
+}
+
+TEST_F(SessionResources, counts_commits)
+{
+    resources->buffer_committed();
+    resources->buffer_committed();
+
+    EXPECT_THAT(resources->usage().commits, Eq(2u));
+}
+
+TEST_F(SessionResources, counts_throttled_frames)
+{
+    resources->frame_throttled();
+
+    EXPECT_THAT(resources->usage().throttled_frames, Eq(1u));
+}
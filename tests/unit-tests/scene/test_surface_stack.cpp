@@ -84,6 +84,7 @@ struct MockSceneObserver : public ms::Observer
     MOCK_METHOD1(surface_removed, void(std::shared_ptr<ms::Surface> const&));
     MOCK_METHOD1(surfaces_reordered, void(ms::SurfaceSet const&));
     MOCK_METHOD0(scene_changed, void());
+    MOCK_METHOD1(scene_damaged, void(geom::Rectangle const&));
 
     MOCK_METHOD1(surface_exists, void(std::shared_ptr<ms::Surface> const&));
     MOCK_METHOD0(end_observation, void());
@@ -767,6 +768,29 @@ TEST_F(SurfaceStack, exposes_rendered_surface)
     elements2.back()->rendered();
 }
 
+TEST_F(SurfaceStack, occludes_hidden_surface)
+{
+    using namespace testing;
+
+    stack.register_compositor(compositor_id);
+
+    auto const mock_surface = std::make_shared<MockConfigureSurface>();
+    stack.add_surface(mock_surface, default_params.input_mode);
+
+    auto const elements = stack.scene_elements_for(compositor_id);
+    ASSERT_THAT(elements.size(), Eq(1u));
+
+    EXPECT_CALL(*mock_surface, configure(mir_window_attrib_visibility, mir_window_visibility_exposed));
+    elements.back()->rendered();
+
+    Mock::VerifyAndClearExpectations(mock_surface.get());
+
+    mock_surface->hide();
+
+    EXPECT_CALL(*mock_surface, configure(mir_window_attrib_visibility, mir_window_visibility_occluded));
+    EXPECT_THAT(stack.scene_elements_for(compositor_id), IsEmpty());
+}
+
 TEST_F(SurfaceStack, occludes_surface_when_unregistering_all_compositors_that_rendered_it)
 {
     using namespace testing;
@@ -952,6 +976,46 @@ TEST_F(SurfaceStack, scene_observers_notified_of_generic_scene_change)
     stack.emit_scene_changed();
 }
 
+TEST_F(SurfaceStack, scene_observers_notified_of_scene_damage)
+{
+    using namespace ::testing;
+
+    MockSceneObserver o1, o2;
+    geom::Rectangle const damage{{12, 34}, {24, 24}};
+
+    EXPECT_CALL(o1, scene_changed()).Times(0);
+    EXPECT_CALL(o1, scene_damaged(damage)).Times(1);
+    EXPECT_CALL(o2, scene_damaged(damage)).Times(1);
+
+    stack.add_observer(mt::fake_shared(o1));
+    stack.add_observer(mt::fake_shared(o2));
+
+    stack.emit_scene_damaged(damage);
+
+    EXPECT_EQ(1, stack.frames_pending(this));
+}
+
+TEST_F(SurfaceStack, scene_damage_is_a_scene_change_for_observers_that_predate_it)
+{
+    using namespace ::testing;
+
+    struct LegacySceneObserver : ms::Observer
+    {
+        MOCK_METHOD1(surface_added, void(std::shared_ptr<ms::Surface> const&));
+        MOCK_METHOD1(surface_removed, void(std::shared_ptr<ms::Surface> const&));
+        MOCK_METHOD1(surfaces_reordered, void(ms::SurfaceSet const&));
+        MOCK_METHOD0(scene_changed, void());
+        MOCK_METHOD1(surface_exists, void(std::shared_ptr<ms::Surface> const&));
+        MOCK_METHOD0(end_observation, void());
+    } observer;
+
+    EXPECT_CALL(observer, scene_changed()).Times(1);
+
+    stack.add_observer(mt::fake_shared(observer));
+
+    stack.emit_scene_damaged({{12, 34}, {24, 24}});
+}
+
 TEST_F(SurfaceStack, for_each_enumerates_all_input_surfaces)
 {
     using namespace ::testing;
@@ -318,6 +318,35 @@ TEST_F(DecorationBasicDecoration, redrawn_on_focus_state_change)
     Mock::VerifyAndClearExpectations(&buffer_stream);
 }
 
+TEST_F(DecorationBasicDecoration, reuses_buffers_when_focus_state_returns)
+{
+    std::vector<std::shared_ptr<mir::graphics::Buffer>> focused_buffers;
+    std::vector<std::shared_ptr<mir::graphics::Buffer>> refocused_buffers;
+
+    window_surface.configure(mir_window_attrib_focus, mir_window_focus_state_unfocused);
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&buffer_stream);
+
+    EXPECT_CALL(buffer_stream, submit_buffer(_))
+        .WillRepeatedly(Invoke([&](auto const& buffer) { focused_buffers.push_back(buffer); }));
+    window_surface.configure(mir_window_attrib_focus, mir_window_focus_state_focused);
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&buffer_stream);
+
+    window_surface.configure(mir_window_attrib_focus, mir_window_focus_state_unfocused);
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&buffer_stream);
+
+    EXPECT_CALL(buffer_stream, submit_buffer(_))
+        .WillRepeatedly(Invoke([&](auto const& buffer) { refocused_buffers.push_back(buffer); }));
+    window_surface.configure(mir_window_attrib_focus, mir_window_focus_state_focused);
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&buffer_stream);
+
+    ASSERT_THAT(focused_buffers, Not(IsEmpty()));
+    EXPECT_THAT(refocused_buffers, Eq(focused_buffers));
+}
+
 TEST_F(DecorationBasicDecoration, decoration_resized_on_window_resize)
 {
     geom::Size new_size{203, 305};
@@ -334,6 +363,15 @@ TEST_F(DecorationBasicDecoration, decoration_resized_on_window_resize)
     EXPECT_THAT(spec.height.value(), Eq(new_size.height));
 }
 
+TEST_F(DecorationBasicDecoration, not_redrawn_on_window_resize)
+{
+    EXPECT_CALL(buffer_stream, submit_buffer(_))
+        .Times(0);
+    window_surface.resize({203, 305});
+    executor.execute();
+    Mock::VerifyAndClearExpectations(&buffer_stream);
+}
+
 TEST_F(DecorationBasicDecoration, makes_padding_for_borders)
 {
     EXPECT_THAT(window_surface.content_size().width, Lt(window_surface.window_size().width));
@@ -368,7 +406,7 @@ TEST_F(DecorationBasicDecoration, padding_comes_back_when_restored)
     EXPECT_THAT(window_surface.content_size().height, Lt(window_surface.window_size().height));
 }
 
-TEST_F(DecorationBasicDecoration, four_decoration_streams_when_restored)
+TEST_F(DecorationBasicDecoration, titlebar_and_border_streams_when_restored)
 {
     window_surface.configure(mir_window_attrib_state, mir_window_state_maximized);
     executor.execute();
@@ -380,7 +418,8 @@ TEST_F(DecorationBasicDecoration, four_decoration_streams_when_restored)
     window_surface.configure(mir_window_attrib_state, mir_window_state_restored);
     executor.execute();
     ASSERT_TRUE(spec.streams.is_set());
-    EXPECT_THAT(spec.streams.value().size(), Eq(4)); // Titlebar and left, right and bottom borders
+    // Titlebar, buttons and left, right and bottom borders (the window has no name, so there is no title stream)
+    EXPECT_THAT(spec.streams.value().size(), Eq(5));
 }
 
 TEST_F(DecorationBasicDecoration, input_area_contains_borders_when_restored)
@@ -413,7 +452,7 @@ TEST_F(DecorationBasicDecoration, only_has_titlebar_padding_when_maximized)
     EXPECT_THAT(window_surface.content_size().height, Lt(window_surface.window_size().height));
 }
 
-TEST_F(DecorationBasicDecoration, one_decoration_stream_when_maximized)
+TEST_F(DecorationBasicDecoration, only_titlebar_streams_when_maximized)
 {
     std::shared_ptr<ms::Surface> decoration_surface_{mt::fake_shared(decoration_surface)};
     msh::SurfaceSpecification spec;
@@ -423,7 +462,7 @@ TEST_F(DecorationBasicDecoration, one_decoration_stream_when_maximized)
     window_surface.configure(mir_window_attrib_state, mir_window_state_maximized);
     executor.execute();
     ASSERT_TRUE(spec.streams.is_set());
-    EXPECT_THAT(spec.streams.value().size(), Eq(1)); // Titlebar only
+    EXPECT_THAT(spec.streams.value().size(), Eq(2)); // Titlebar and buttons only
 }
 
 TEST_F(DecorationBasicDecoration, input_area_contains_only_top_bar_when_maximized)
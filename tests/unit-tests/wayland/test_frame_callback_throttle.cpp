@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/frame_callback_throttle.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <wayland-server-core.h>
+
+#include <memory>
+#include <vector>
+
+namespace mf = mir::frontend;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+auto const interval = 10ms;
+
+struct FrameCallbackThrottle : Test
+{
+    /// Runs the event loop for (at least) the given time
+    void dispatch_for(std::chrono::milliseconds duration)
+    {
+        auto const end = std::chrono::steady_clock::now() + duration;
+        for (auto now = std::chrono::steady_clock::now(); now < end; now = std::chrono::steady_clock::now())
+        {
+            auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(end - now) + 1ms;
+            wl_event_loop_dispatch(the_event_loop.get(), remaining.count());
+        }
+    }
+
+    // Declared first so the throttle removes its timer before the loop is destroyed
+    std::unique_ptr<wl_event_loop, decltype(&wl_event_loop_destroy)> const the_event_loop{
+        wl_event_loop_create(), &wl_event_loop_destroy};
+    std::vector<bool> sent;
+    mf::FrameCallbackThrottle throttle{the_event_loop.get(), interval, [this](bool throttled) { sent.push_back(throttled); }};
+};
+}
+
+TEST_F(FrameCallbackThrottle, sends_straight_away_while_visible)
+{
+    throttle.send_when_due();
+
+    EXPECT_THAT(sent, ElementsAre(false));
+}
+
+TEST_F(FrameCallbackThrottle, holds_back_callbacks_while_not_visible)
+{
+    throttle.set_visible(false);
+    throttle.send_when_due();
+
+    EXPECT_THAT(sent, IsEmpty());
+
+    dispatch_for(3 * interval);
+
+    EXPECT_THAT(sent, ElementsAre(true));
+}
+
+TEST_F(FrameCallbackThrottle, sends_once_per_interval_while_not_visible)
+{
+    throttle.set_visible(false);
+
+    throttle.send_when_due();
+    throttle.send_when_due();
+    throttle.send_when_due();
+    dispatch_for(3 * interval);
+
+    EXPECT_THAT(sent, ElementsAre(true));
+
+    throttle.send_when_due();
+    dispatch_for(3 * interval);
+
+    EXPECT_THAT(sent, ElementsAre(true, true));
+}
+
+TEST_F(FrameCallbackThrottle, becoming_visible_stops_the_timer)
+{
+    throttle.set_visible(false);
+    throttle.send_when_due();
+
+    throttle.set_visible(true);
+    dispatch_for(3 * interval);
+
+    EXPECT_THAT(sent, IsEmpty());
+
+    throttle.send_when_due();
+
+    EXPECT_THAT(sent, ElementsAre(false));
+}
+
+TEST_F(FrameCallbackThrottle, can_be_throttled_again_after_becoming_visible)
+{
+    throttle.set_visible(false);
+    throttle.send_when_due();
+    throttle.set_visible(true);
+
+    throttle.set_visible(false);
+    throttle.send_when_due();
+    dispatch_for(3 * interval);
+
+    EXPECT_THAT(sent, ElementsAre(true));
+}